@@ -86,6 +86,7 @@
 ---@field max_creatures integer The maximum number of creatures the player can have from portals
 ---@field colour string The colour of the player
 ---@field player_name string The name of the player
+---@field revealed_subtiles integer Amount of map subtiles the player has revealed
 if not Player then Player = {} end
 
 
@@ -0,0 +1,205 @@
+#!/usr/bin/env python3
+"""
+Headless parallel runner for the KeeperFX functional tests (src/ftests).
+
+Every test (or shard of tests) runs in its own keeperfx process, built with
+FTEST_DEBUG, using SDL's dummy video and audio drivers. Each process is capped
+in game turns and wall time, and appends its per-test results to a JSON lines
+file through -ftest_report. The results are then aggregated into a JSON
+summary and a JUnit XML report, suitable for CI.
+
+Example:
+    scripts/ftest_runner.py --exe bin/keeperfx.exe --jobs 4 --junit ftests.xml
+"""
+
+import argparse
+import concurrent.futures
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+import xml.etree.ElementTree as ET
+
+SRC_ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+FTEST_LIST_FILE = os.path.join(SRC_ROOT, "src", "ftests", "ftest_list.c")
+
+
+def list_tests(include_long):
+    """Reads the registered test names from ftest_list.c, skipping commented out entries."""
+    tests = []
+    in_long_list = False
+    with open(FTEST_LIST_FILE, "r", encoding="utf-8") as f:
+        for line in f:
+            stripped = line.strip()
+            if ".long_running_tests_list" in stripped:
+                in_long_list = True
+            if stripped.startswith("//"):
+                continue
+            match = re.search(r'\.test_name\s*=\s*"([^"]+)"', stripped)
+            if match is None:
+                continue
+            if in_long_list and not include_long:
+                continue
+            tests.append(match.group(1))
+    return tests
+
+
+def make_shards(tests, shard_size):
+    return [tests[i:i + shard_size] for i in range(0, len(tests), shard_size)]
+
+
+def run_shard(args, shard, work_dir):
+    """Runs one keeperfx process for the given shard and returns the results of its tests."""
+    shard_name = shard[0] if len(shard) == 1 else "{}+{}".format(shard[0], len(shard) - 1)
+    report_file = os.path.join(work_dir, "{}.jsonl".format(shard_name))
+    log_file = os.path.join(work_dir, "{}.log".format(shard_name))
+
+    cmd = [args.exe, "-ftests", ",".join(shard), "-nosound",
+           "-ftest_report", report_file, "-log", log_file]
+    if args.max_turns > 0:
+        cmd += ["-ftest_maxturns", str(args.max_turns)]
+    if args.max_time > 0:
+        cmd += ["-ftest_maxtime", str(args.max_time)]
+    if args.include_long:
+        cmd += ["-includelongtests"]
+
+    env = dict(os.environ)
+    env.setdefault("SDL_VIDEO_DRIVER", "dummy")
+    env.setdefault("SDL_AUDIO_DRIVER", "dummy")
+
+    # Hard limit for the whole process; the engine side limit should normally trigger first
+    process_timeout = args.max_time * len(shard) + args.startup_time if args.max_time > 0 else None
+    started = time.monotonic()
+    exit_code = None
+    timed_out = False
+    try:
+        completed = subprocess.run(cmd, cwd=args.game_dir, env=env, timeout=process_timeout,
+                                   stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+        exit_code = completed.returncode
+    except subprocess.TimeoutExpired:
+        timed_out = True
+    elapsed = time.monotonic() - started
+
+    results = {}
+    if os.path.exists(report_file):
+        with open(report_file, "r", encoding="utf-8") as f:
+            for line in f:
+                line = line.strip()
+                if not line:
+                    continue
+                entry = json.loads(line)
+                # Repeated tests report once per run; keep the first failure, or the last run
+                previous = results.get(entry["test"])
+                if previous is not None and previous["result"] != "passed":
+                    continue
+                results[entry["test"]] = entry
+
+    # Tests which never reported were not reached, because the process aborted, crashed or hung
+    for test in shard:
+        if test in results:
+            continue
+        if timed_out:
+            message = "process killed after {:.0f}s".format(elapsed)
+            result = "timeout"
+        else:
+            message = "process exited with code {} before the test reported".format(exit_code)
+            result = "error"
+        results[test] = {"test": test, "result": result, "turns": 0, "wall_time_ms": 0, "turns_per_second": 0,
+                         "message": message}
+
+    for test in shard:
+        results[test]["log"] = log_file
+    return [results[test] for test in shard]
+
+
+def write_junit(path, results, total_time):
+    failures = sum(1 for r in results if r["result"] in ("failed", "timeout"))
+    errors = sum(1 for r in results if r["result"] == "error")
+    suite = ET.Element("testsuite", name="keeperfx.ftests", tests=str(len(results)),
+                       failures=str(failures), errors=str(errors), time="{:.3f}".format(total_time))
+    for r in results:
+        case = ET.SubElement(suite, "testcase", classname="ftests", name=r["test"],
+                             time="{:.3f}".format(r.get("wall_time_ms", 0) / 1000.0))
+        props = ET.SubElement(case, "properties")
+        ET.SubElement(props, "property", name="turns", value=str(r.get("turns", 0)))
+        ET.SubElement(props, "property", name="wall_time_ms", value=str(r.get("wall_time_ms", 0)))
+        ET.SubElement(props, "property", name="turns_per_second", value=str(r.get("turns_per_second", 0)))
+        if r["result"] in ("failed", "timeout"):
+            ET.SubElement(case, "failure", type=r["result"], message=r.get("message", ""))
+        elif r["result"] == "error":
+            ET.SubElement(case, "error", message=r.get("message", ""))
+        if r.get("log"):
+            ET.SubElement(case, "system-out").text = "log: {}".format(r["log"])
+    ET.ElementTree(suite).write(path, encoding="utf-8", xml_declaration=True)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Run KeeperFX functional tests headless and in parallel.")
+    parser.add_argument("tests", nargs="*", help="test names to run (default: all from ftest_list.c)")
+    parser.add_argument("--exe", required=True, help="keeperfx executable built with FTEST_DEBUG")
+    parser.add_argument("--game-dir", default=None, help="game data directory (default: directory of --exe)")
+    parser.add_argument("--jobs", "-j", type=int, default=os.cpu_count() or 1, help="number of parallel processes")
+    parser.add_argument("--shard-size", type=int, default=1, help="tests executed by a single process")
+    parser.add_argument("--max-turns", type=int, default=20000, help="game turn limit per test (0 = no limit)")
+    parser.add_argument("--max-time", type=int, default=300, help="wall time limit per test in seconds (0 = no limit)")
+    parser.add_argument("--startup-time", type=int, default=60, help="extra seconds allowed for engine startup")
+    parser.add_argument("--include-long", action="store_true", help="also run long_running_tests_list")
+    parser.add_argument("--work-dir", default=None, help="directory for logs and partial reports")
+    parser.add_argument("--json", default="ftest_results.json", help="aggregated JSON report")
+    parser.add_argument("--junit", default="ftest_results.xml", help="aggregated JUnit XML report")
+    args = parser.parse_args()
+
+    args.exe = os.path.abspath(args.exe)
+    if args.game_dir is None:
+        args.game_dir = os.path.dirname(args.exe)
+    tests = args.tests if args.tests else list_tests(args.include_long)
+    if not tests:
+        print("No functional tests found.", file=sys.stderr)
+        return 2
+    work_dir = args.work_dir or tempfile.mkdtemp(prefix="kfx_ftests_")
+    os.makedirs(work_dir, exist_ok=True)
+
+    shards = make_shards(tests, max(1, args.shard_size))
+    print("Running {} tests in {} processes ({} parallel), logs in {}".format(
+        len(tests), len(shards), args.jobs, work_dir))
+
+    started = time.monotonic()
+    results = []
+    with concurrent.futures.ThreadPoolExecutor(max_workers=max(1, args.jobs)) as pool:
+        futures = [pool.submit(run_shard, args, shard, work_dir) for shard in shards]
+        for future in concurrent.futures.as_completed(futures):
+            for r in future.result():
+                print("{:8} {:48} turns={:<7} time={}ms turns/s={} {}".format(
+                    r["result"].upper(), r["test"], r.get("turns", 0), r.get("wall_time_ms", 0),
+                    r.get("turns_per_second", 0), r.get("message", "")))
+                results.append(r)
+    total_time = time.monotonic() - started
+
+    order = {name: i for i, name in enumerate(tests)}
+    results.sort(key=lambda r: order.get(r["test"], len(order)))
+    # Simulation speed over all tests, from the time spent inside the tests
+    total_turns = sum(r.get("turns", 0) for r in results)
+    total_test_ms = sum(r.get("wall_time_ms", 0) for r in results)
+    summary = {
+        "total": len(results),
+        "passed": sum(1 for r in results if r["result"] == "passed"),
+        "failed": sum(1 for r in results if r["result"] != "passed"),
+        "wall_time_s": round(total_time, 3),
+        "turns": total_turns,
+        "turns_per_second": round(total_turns * 1000.0 / total_test_ms, 1) if total_test_ms > 0 else 0,
+        "results": results,
+    }
+    with open(args.json, "w", encoding="utf-8") as f:
+        json.dump(summary, f, indent=2)
+    write_junit(args.junit, results, total_time)
+
+    print("{} passed, {} failed, {:.1f}s, {} turns/s".format(
+        summary["passed"], summary["failed"], total_time, summary["turns_per_second"]))
+    return 0 if summary["failed"] == 0 else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -41,6 +41,14 @@
 
 #define EDGEFIT_LEN           64
 #define EDGEOR_COUNT           4
+/** Amount of navigation rule parameter sets for which component labels are kept at once. */
+#define NAV_REACH_SLOTS_COUNT  8
+
+enum NavReachabilityValues {
+    NavReach_Unknown = 0,
+    NavReach_Unreachable,
+    NavReach_Reachable,
+};
 
 typedef long (*NavRules)(NavColour, NavColour);
 
@@ -111,6 +119,23 @@ NavColour *LastTriangulatedMap;
 long ix_Border;
 int32_t Border[BORDER_LENGTH];
 
+/** Component labels of the triangulation for one set of navigation rule parameters. */
+struct NavReachSlot {
+    long owner;
+    TbBool over_lava;
+    TbBool labels_valid;
+    unsigned long generation;
+    unsigned long last_use;
+    unsigned short loose_component[TRIANLGLES_COUNT];
+    unsigned short strict_component[TRIANLGLES_COUNT];
+};
+
+static struct NavReachSlot nav_reach_slots[NAV_REACH_SLOTS_COUNT];
+static int32_t nav_reach_queue[TRIANLGLES_COUNT];
+/** Triangulation generation; slots labelled for older generation are outdated. Starts above 0 so that empty slots are never valid. */
+static unsigned long nav_reach_generation = 1;
+static unsigned long nav_reach_use_counter;
+
 TbBool nav_map_initialised = 0;
 
 /******************************************************************************/
@@ -1231,6 +1256,73 @@ void tag_open_closed_init(void)
 
 */
 
+/**
+ * Labels connected components of the triangulation, using current navigation rule parameters.
+ * @param component Output array of size ix_Triangles; 0 means the triangle is in no component.
+ * @param strict If true, triangles are connected only if navigation is allowed both ways between them;
+ *     otherwise navigation in any direction is enough.
+ * @return True on success, false if there were too many components to label.
+ */
+static TbBool nav_reach_label_components(unsigned short *component, TbBool strict)
+{
+    memset(component, 0, ix_Triangles * sizeof(unsigned short));
+    // Route search never enters the border triangles, so they can't be in strict components
+    if (strict)
+    {
+        for (long i = 0; i < ix_Border; i++)
+        {
+            if ((Border[i] >= 0) && (Border[i] < ix_Triangles))
+                component[Border[i]] = USHRT_MAX;
+        }
+    }
+    unsigned short last_component = 0;
+    for (long tri_idx = 0; tri_idx < ix_Triangles; tri_idx++)
+    {
+        if ((component[tri_idx] != 0) || (get_triangle_tree_alt(tri_idx) == NAV_COL_UNSET))
+            continue;
+        if (last_component >= USHRT_MAX-1)
+        {
+            ERRORLOG("Too many navigation components");
+            return false;
+        }
+        last_component++;
+        long qpos = 0;
+        long qlen = 0;
+        component[tri_idx] = last_component;
+        nav_reach_queue[qlen++] = tri_idx;
+        while (qpos < qlen)
+        {
+            long ctri = nav_reach_queue[qpos++];
+            NavColour calt = get_triangle_tree_alt(ctri);
+            for (long ncor = 0; ncor < 3; ncor++)
+            {
+                long ntri = Triangles[ctri].tags[ncor];
+                if ((ntri < 0) || (ntri >= ix_Triangles) || (component[ntri] != 0))
+                    continue;
+                NavColour nalt = get_triangle_tree_alt(ntri);
+                if (nalt == NAV_COL_UNSET)
+                    continue;
+                TbBool to_neighbour = (nav_rulesA2B(calt, nalt) != NavigationRule_Blocked);
+                TbBool from_neighbour = (nav_rulesA2B(nalt, calt) != NavigationRule_Blocked);
+                if (strict ? (to_neighbour && from_neighbour) : (to_neighbour || from_neighbour))
+                {
+                    component[ntri] = last_component;
+                    nav_reach_queue[qlen++] = ntri;
+                }
+            }
+        }
+    }
+    if (strict)
+    {
+        for (long i = 0; i < ix_Border; i++)
+        {
+            if ((Border[i] >= 0) && (Border[i] < ix_Triangles) && (component[Border[i]] == USHRT_MAX))
+                component[Border[i]] = 0;
+        }
+    }
+    return true;
+}
+
 static unsigned long nav_same_component(long ptAx, long ptAy, long ptBx, long ptBy)
 {
     NAVIDBG(19,"F=%u Connect %03ld,%03ld %03ld,%03ld", get_gameturn(), ptAx, ptAy, ptBx, ptBy);
@@ -1252,6 +1344,93 @@ TbBool navigation_points_connected(struct Coord3d *pt1, struct Coord3d *pt2)
   return nav_same_component(pt1->x.val, pt1->y.val, pt2->x.val, pt2->y.val);
 }
 
+/**
+ * Returns reachability slot for given navigation rule parameters, labelling components if needed.
+ * Components are labelled over the whole triangulation, and stay valid until it is changed.
+ * @param owner Player whose owner flags block navigation, or -1 if ownership is ignored.
+ * @param over_lava Whether unsafe surfaces may be entered.
+ * @return The slot, or NULL if components can't be labelled.
+ */
+static struct NavReachSlot *nav_reach_get_slot(long owner, TbBool over_lava)
+{
+    if (nav_rulesA2B == NULL)
+        return NULL;
+    struct NavReachSlot *rslot = NULL;
+    struct NavReachSlot *oldest_slot = &nav_reach_slots[0];
+    for (long i = 0; i < NAV_REACH_SLOTS_COUNT; i++)
+    {
+        struct NavReachSlot *cslot = &nav_reach_slots[i];
+        if ((cslot->generation == nav_reach_generation) && (cslot->owner == owner) && (cslot->over_lava == over_lava))
+        {
+            rslot = cslot;
+            break;
+        }
+        if (cslot->last_use < oldest_slot->last_use)
+            oldest_slot = cslot;
+    }
+    if (rslot == NULL)
+    {
+        rslot = oldest_slot;
+        rslot->owner = owner;
+        rslot->over_lava = over_lava;
+        rslot->generation = nav_reach_generation;
+        owner_player_navigating = owner;
+        nav_thing_can_travel_over_lava = over_lava;
+        rslot->labels_valid = nav_reach_label_components(rslot->loose_component, false)
+            && nav_reach_label_components(rslot->strict_component, true);
+        nav_thing_can_travel_over_lava = 0;
+        owner_player_navigating = -1;
+        NAVIDBG(9,"Labelled %ld triangles for owner %ld lava %d",(long)ix_Triangles,owner,(int)over_lava);
+    }
+    nav_reach_use_counter++;
+    rslot->last_use = nav_reach_use_counter;
+    if (!rslot->labels_valid)
+        return NULL;
+    return rslot;
+}
+
+/**
+ * Checks connectivity of two triangles without tracing a route.
+ * Triangles not in the same loose component cannot be connected by any route. Triangles in the
+ * same strict component are connected in both directions, but that is only enough for the smallest
+ * creatures - larger ones also need edges wide enough, which requires tracing the route.
+ * @param tri_src Source triangle.
+ * @param tri_dst Destination triangle.
+ * @param owner Player whose owner flags block navigation, or -1 if ownership is ignored.
+ * @param over_lava Whether unsafe surfaces may be entered.
+ * @param nav_size Navigation size, as given to path_init8_wide_f().
+ * @return Reachability, or NavReach_Unknown if a route has to be traced.
+ */
+static unsigned char nav_reach_triangles(long tri_src, long tri_dst, long owner, TbBool over_lava, unsigned char nav_size)
+{
+    if ((tri_src < 0) || (tri_src >= ix_Triangles) || (tri_dst < 0) || (tri_dst >= ix_Triangles))
+        return NavReach_Unknown;
+    if (((get_triangle_tree_alt(tri_src) & NAVMAP_FLOORHEIGHT_MASK) == NAVMAP_FLOORHEIGHT_MAX)
+     || ((get_triangle_tree_alt(tri_dst) & NAVMAP_FLOORHEIGHT_MASK) == NAVMAP_FLOORHEIGHT_MAX))
+        return NavReach_Unreachable;
+    struct NavReachSlot *rslot = nav_reach_get_slot(owner, over_lava);
+    if (rslot == NULL)
+        return NavReach_Unknown;
+    unsigned short comp_src = rslot->loose_component[tri_src];
+    if ((comp_src == 0) || (comp_src != rslot->loose_component[tri_dst]))
+        return NavReach_Unreachable;
+    if (nav_size != 0)
+        return NavReach_Unknown;
+    comp_src = rslot->strict_component[tri_src];
+    if ((comp_src != 0) && (comp_src == rslot->strict_component[tri_dst]))
+        return NavReach_Reachable;
+    return NavReach_Unknown;
+}
+
+/**
+ * Marks component labels used for reachability checks as outdated.
+ * Needs to be called whenever triangulation is changed.
+ */
+void ariadne_invalidate_reachability(void)
+{
+    nav_reach_generation++;
+}
+
 static TbBool triangulation_border_tag(void)
 {
     if (border_tags_to_current(Border, ix_Border) != ix_Border)
@@ -2612,6 +2791,54 @@ long ariadne_count_waypoints_on_creature_route_to_target_f(const struct Thing *t
     return path.waypoints_num;
 }
 
+/**
+ * Checks if creature can get from source to destination position.
+ * Uses connected components of the triangulation when they give a definite answer,
+ * and traces a complete route only when they don't.
+ * @param thing
+ * @param srcpos
+ * @param dstpos
+ * @param flags
+ * @param func_name
+ * @return
+ * @see ariadne_count_waypoints_on_creature_route_to_target() traces the complete route.
+ */
+TbBool ariadne_creature_can_reach_target_f(const struct Thing *thing,
+    const struct Coord3d *srcpos, const struct Coord3d *dstpos, AriadneRouteFlags flags, const char *func_name)
+{
+    long owner;
+    if ((flags & AridRtF_NoOwner) != 0)
+        owner = -1;
+    else
+        owner = thing->owner;
+    long nav_sizexy = thing_nav_block_sizexy(thing);
+    if (nav_sizexy > 0) nav_sizexy--;
+    unsigned char reach = nav_reach_triangles(triangle_findSE8(srcpos->x.val, srcpos->y.val),
+        triangle_findSE8(dstpos->x.val, dstpos->y.val), owner, creature_can_travel_over_lava(thing), nav_sizexy);
+#if (BFDEBUG_LEVEL > 0)
+    if (reach != NavReach_Unknown)
+    {
+        long waypoints_num = ariadne_count_waypoints_on_creature_route_to_target_f(thing, srcpos, dstpos, flags, func_name);
+        if ((reach == NavReach_Unreachable) && (waypoints_num > 0)) {
+            ERRORLOG("%s: Components of %s index %d say %3d,%3d is unreachable from %3d,%3d, but route was found", func_name,
+                thing_model_name(thing), (int)thing->index, (int)dstpos->x.stl.num, (int)dstpos->y.stl.num,
+                (int)srcpos->x.stl.num, (int)srcpos->y.stl.num);
+        } else
+        if ((reach == NavReach_Reachable) && (waypoints_num <= 0)) {
+            // Route tracing may give up on long routes when its heap gets full
+            NAVIDBG(6,"%s: Components of %s index %d say %3d,%3d is reachable from %3d,%3d, but route wasn't found", func_name,
+                thing_model_name(thing), (int)thing->index, (int)dstpos->x.stl.num, (int)dstpos->y.stl.num,
+                (int)srcpos->x.stl.num, (int)srcpos->y.stl.num);
+        }
+    }
+#endif
+    if (reach == NavReach_Unreachable)
+        return false;
+    if (reach == NavReach_Reachable)
+        return true;
+    return (ariadne_count_waypoints_on_creature_route_to_target_f(thing, srcpos, dstpos, flags, func_name) > 0);
+}
+
 AriadneReturn ariadne_invalidate_creature_route(struct Thing *thing)
 {
     struct CreatureControl *cctrl;
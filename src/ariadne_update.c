@@ -1512,6 +1512,7 @@ static TbBool triangulate_area(NavColour *imap, long start_x, long start_y, long
     long i;
     triangulation_successful = true;
     LastTriangulatedMap = imap;
+    ariadne_invalidate_reachability();
     NAVIDBG(9,"Area from (%03ld,%03ld) to (%03ld,%03ld) with %04ld triangles",start_x,start_y,end_x,end_y,count_Triangles);
     // Switch coords to make end_x larger than start_x
     if (end_x < start_x)
@@ -1675,7 +1676,7 @@ static void triangulate_map(NavColour *imap)
 long init_navigation(void)
 {
     
-    NavColour *IanMap = (NavColour *)&game.navigation_map;
+    NavColour *IanMap = game.navigation_map;
     init_navigation_map();
     triangulate_map(IanMap);
     set_nav_rule_default();
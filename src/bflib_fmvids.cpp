@@ -6,6 +6,7 @@
 #include "bflib_keybrd.h"
 #include "bflib_vidsurface.h"
 #include "bflib_fileio.h"
+#include "bflib_workers.h"
 #include "kjm_input.h"
 
 // See: https://trac.ffmpeg.org/ticket/3626
@@ -22,6 +23,8 @@ extern "C" {
 #include <memory>
 #include <stdexcept>
 #include <chrono>
+#include <mutex>
+#include <condition_variable>
 #include "thread.hpp"
 #include <vector>
 #include <SDL3/SDL.h>
@@ -699,6 +702,13 @@ struct AnimFLIPrefix { //sizeof=0x6
 };
 #pragma pack()
 
+enum AnimDeltaMethods {
+	AnDM_BRUN = 0,
+	AnDM_SS2,
+	AnDM_LC,
+	AnDM_COUNT,
+};
+
 struct Animation {
 	long state_flags;
 	unsigned char *videobuf;
@@ -717,10 +727,38 @@ struct Animation {
 	AnimFLIPrefix prefix;
 	AnimFLIChunk subchunk;
 	char unusedfield3C4[12];
+	/** Scratch buffers for delta compression methods, which are tried concurrently. */
+	unsigned char *deltabuf[AnDM_COUNT];
 };
 
 Animation animation;
 
+/** Amount of captured frames which may wait for the encoder. */
+#define ANIM_CAPTURE_FRAMES_COUNT 6
+
+struct AnimCapturedFrame {
+	unsigned char *pixels;
+	unsigned char palette[768];
+};
+
+/**
+ * Encoder thread state. Frames are captured into a ring buffer by the
+ * render thread, and compressed and written to file by the encoder thread.
+ */
+struct AnimEncoder {
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable frame_queued;
+	std::condition_variable frame_freed;
+	AnimCapturedFrame frames[ANIM_CAPTURE_FRAMES_COUNT];
+	int first_queued;
+	int queued_count;
+	bool stopping;
+	bool write_failed;
+};
+
+AnimEncoder anim_encoder;
+
 /**
  * Writes the data into FLI animation.
  * @return Returns false on error, true on success.
@@ -813,17 +851,19 @@ long anim_make_FLI_COLOUR256(unsigned char *palette)
 
 /**
  * Compress data into FLI's BRUN block (8-bit Run-Length compression).
+ * Output buffer has to be zeroed; frame rows are expected to be packed.
  * @return Returns unpacked size of the block which was compressed.
  */
-long anim_make_FLI_BRUN(unsigned char *screenbuf) {
-	unsigned char *blk_begin = animation.buffer_write_pointer;
+long anim_make_FLI_BRUN(unsigned char *outbuf, unsigned char *screenbuf) {
+	unsigned char *wptr = outbuf;
+	unsigned char *blk_begin = wptr;
 	short w;
 	short h;
 	short k;
 	short count;
 	unsigned char *sbuf = screenbuf;
 	for ( h = animation.header.height; h>0; h-- ) {
-		animation.buffer_write_pointer++;
+		wptr++;
 		for (w=animation.header.width; w>0; ) {
 			count = 0;
 			// Counting size of RLE block
@@ -839,10 +879,10 @@ long anim_make_FLI_BRUN(unsigned char *screenbuf) {
 					count++;
 					w--;
 				}
-				*animation.buffer_write_pointer = (char)count;
-				animation.buffer_write_pointer++;
-				*animation.buffer_write_pointer = sbuf[0];
-				animation.buffer_write_pointer++;
+				*wptr = (char)count;
+				wptr++;
+				*wptr = sbuf[0];
+				wptr++;
 				sbuf += count;
 			} else {
 				if ( w > 1 ) {
@@ -859,31 +899,33 @@ long anim_make_FLI_BRUN(unsigned char *screenbuf) {
 					w--;
 				}
 				if ( count!=0 ) {
-					*animation.buffer_write_pointer = (char)count;
-					animation.buffer_write_pointer++;
-					memcpy(animation.buffer_write_pointer, sbuf, -count);
+					*wptr = (char)count;
+					wptr++;
+					memcpy(wptr, sbuf, -count);
 					sbuf -= count;
-					animation.buffer_write_pointer -= count;
+					wptr -= count;
 				}
 			}
 		}
 	}
 	// Make the block size even
-	if ((size_t)animation.buffer_write_pointer & 1) {
-		*animation.buffer_write_pointer='\0';
-		animation.buffer_write_pointer++;
+	if ((size_t)wptr & 1) {
+		*wptr='\0';
+		wptr++;
 	}
-	return (animation.buffer_write_pointer - blk_begin);
+	return (wptr - blk_begin);
 }
 
 /**
  * Compress data into FLI's SS2 block.
+ * Output buffer has to be zeroed; frame rows are expected to be packed.
  * @return Returns unpacked size of the block which was compressed.
  */
-long anim_make_FLI_SS2(unsigned char *curdat, unsigned char *prvdat)
+long anim_make_FLI_SS2(unsigned char *outbuf, unsigned char *curdat, unsigned char *prvdat)
 {
+	unsigned char *wptr = outbuf;
 	unsigned char *blk_begin;
-	blk_begin=animation.buffer_write_pointer;
+	blk_begin=wptr;
 	unsigned char *cbuf;
 	unsigned char *pbuf;
 	unsigned char *cbf;
@@ -899,17 +941,17 @@ long anim_make_FLI_SS2(unsigned char *curdat, unsigned char *prvdat)
 	pbuf = prvdat;
 	unsigned short *lines_count;
 	unsigned short *pckt_count;
-	lines_count = (unsigned short *)animation.buffer_write_pointer;
-	animation.buffer_write_pointer += 2;
-	pckt_count = (unsigned short *)animation.buffer_write_pointer;
+	lines_count = (unsigned short *)wptr;
+	wptr += 2;
+	pckt_count = (unsigned short *)wptr;
 
 	wend = 0;
 	for (h=animation.header.height; h>0; h--) {
 		cbf = cbuf;
 		pbf = pbuf;
 		if (wend == 0) {
-			pckt_count = (unsigned short *)animation.buffer_write_pointer;
-			animation.buffer_write_pointer += 2;
+			pckt_count = (unsigned short *)wptr;
+			wptr += 2;
 			(*lines_count)++;
 		}
 		for (w=animation.header.width;w>0;) {
@@ -919,23 +961,23 @@ long anim_make_FLI_SS2(unsigned char *curdat, unsigned char *prvdat)
 			}
 			if (2*(long)k == animation.header.width) {
 				wend--;
-				cbf += LbGraphicsScreenWidth();
-				pbf += LbGraphicsScreenWidth();
+				cbf += animation.header.width;
+				pbf += animation.header.width;
 				continue;
 			}
 			if ( w > 0 ) {
 				if (wend != 0) {
 					(*pckt_count) = wend;
-					pckt_count = (unsigned short *)animation.buffer_write_pointer;
-					animation.buffer_write_pointer += 2;
+					pckt_count = (unsigned short *)wptr;
+					wptr += 2;
 				}
 				wendt = 2*k;
 				wend = wendt;
 				while (wend > 255) {
-					*(unsigned char *)animation.buffer_write_pointer = 255;
-					animation.buffer_write_pointer++;
-					*(unsigned char *)animation.buffer_write_pointer = 0;
-					animation.buffer_write_pointer++;
+					*(unsigned char *)wptr = 255;
+					wptr++;
+					*(unsigned char *)wptr = 0;
+					wptr++;
 					wend -= 255;
 					(*pckt_count)++;
 				}
@@ -955,12 +997,12 @@ long anim_make_FLI_SS2(unsigned char *curdat, unsigned char *prvdat)
 						nsame++;
 						w -= 2;
 					}
-					*(unsigned char *)animation.buffer_write_pointer = wend;
-					animation.buffer_write_pointer++;
-					*(unsigned char *)animation.buffer_write_pointer = -nsame;
-					animation.buffer_write_pointer++;
-					*(unsigned short *)animation.buffer_write_pointer = *(unsigned short *)cbf;
-					animation.buffer_write_pointer+=2;
+					*(unsigned char *)wptr = wend;
+					wptr++;
+					*(unsigned char *)wptr = -nsame;
+					wptr++;
+					*(unsigned short *)wptr = *(unsigned short *)cbf;
+					wptr+=2;
 					pbf += 2*nsame;
 					cbf += 2*nsame;
 					wend = 0;
@@ -981,12 +1023,12 @@ long anim_make_FLI_SS2(unsigned char *curdat, unsigned char *prvdat)
 						}
 					}
 					if (ndiff>0) {
-						*(unsigned char *)animation.buffer_write_pointer = wend;
-						animation.buffer_write_pointer++;
-						*(unsigned char *)animation.buffer_write_pointer = ndiff;
-						animation.buffer_write_pointer++;
-						memcpy(animation.buffer_write_pointer, cbf, 2*(long)ndiff);
-						animation.buffer_write_pointer += 2*(long)ndiff;
+						*(unsigned char *)wptr = wend;
+						wptr++;
+						*(unsigned char *)wptr = ndiff;
+						wptr++;
+						memcpy(wptr, cbf, 2*(long)ndiff);
+						wptr += 2*(long)ndiff;
 						pbf += 2*(long)ndiff;
 						cbf += 2*(long)ndiff;
 						wend = 0;
@@ -995,34 +1037,36 @@ long anim_make_FLI_SS2(unsigned char *curdat, unsigned char *prvdat)
 				}
 			}
 		}
-		cbuf += LbGraphicsScreenWidth();
-		pbuf += LbGraphicsScreenWidth();
+		cbuf += animation.header.width;
+		pbuf += animation.header.width;
 	}
 
 	if (animation.header.height+wend == 0) {
 		(*lines_count) = 1;
 		(*pckt_count) = 1;
-		*(unsigned char *)animation.buffer_write_pointer = 0;
-		animation.buffer_write_pointer++;
-		*(unsigned char *)animation.buffer_write_pointer = 0;
-		animation.buffer_write_pointer++;
+		*(unsigned char *)wptr = 0;
+		wptr++;
+		*(unsigned char *)wptr = 0;
+		wptr++;
 	} else if (wend != 0) {
-		animation.buffer_write_pointer -= 2;
+		wptr -= 2;
 		(*lines_count)--;
 	}
 	// Make the data size even
-	animation.buffer_write_pointer = (unsigned char *)(((size_t)animation.buffer_write_pointer + 1) & 0xFFFFFFFE);
-	return animation.buffer_write_pointer - blk_begin;
+	wptr = (unsigned char *)(((size_t)wptr + 1) & 0xFFFFFFFE);
+	return wptr - blk_begin;
 }
 
 /**
  * Compress data into FLI's LC block.
+ * Output buffer has to be zeroed; frame rows are expected to be packed.
  * @return Returns unpacked size of the block which was compressed.
  */
-long anim_make_FLI_LC(unsigned char *curdat, unsigned char *prvdat)
+long anim_make_FLI_LC(unsigned char *outbuf, unsigned char *curdat, unsigned char *prvdat)
 {
+	unsigned char *wptr = outbuf;
 	unsigned char *blk_begin;
-	blk_begin=animation.buffer_write_pointer;
+	blk_begin=wptr;
 	unsigned char *cbuf;
 	unsigned char *pbuf;
 	unsigned char *cbf;
@@ -1048,8 +1092,8 @@ long anim_make_FLI_LC(unsigned char *curdat, unsigned char *prvdat)
 			++wend;
 		}
 		if ( wend != animation.header.width ) break;
-		cbuf += LbGraphicsScreenWidth();
-		pbuf += LbGraphicsScreenWidth();
+		cbuf += animation.header.width;
+		pbuf += animation.header.width;
 	}
 	if (hend != 0) {
 		hend = animation.header.height - hend;
@@ -1063,22 +1107,22 @@ long anim_make_FLI_LC(unsigned char *curdat, unsigned char *prvdat)
 				wend++;
 			}
 			if ( wend != animation.header.width ) break;
-			cbuf -= LbGraphicsScreenWidth();
-			pbuf -= LbGraphicsScreenWidth();
+			cbuf -= animation.header.width;
+			pbuf -= animation.header.width;
 		}
 		hdim = h - hend;
 		blksize = animation.header.width * (long)hend;
 		cbuf = curdat+blksize;
 		pbuf = prvdat+blksize;
-		*(unsigned short *)animation.buffer_write_pointer = hend;
-		animation.buffer_write_pointer += 2;
-		*(unsigned short *)animation.buffer_write_pointer = hdim;
-		animation.buffer_write_pointer += 2;
+		*(unsigned short *)wptr = hend;
+		wptr += 2;
+		*(unsigned short *)wptr = hdim;
+		wptr += 2;
 
 		for (h = hdim; h>0; h--) {
 			cbf = cbuf;
 			pbf = pbuf;
-			outptr = animation.buffer_write_pointer++;
+			outptr = wptr++;
 			for (w=animation.header.width; w>0; ) {
 				for ( wend=0; w>0; wend++) {
 					if ( cbf[wend] != pbf[wend]) break;
@@ -1088,10 +1132,10 @@ long anim_make_FLI_LC(unsigned char *curdat, unsigned char *prvdat)
 				if (animation.header.width == wend) continue;
 				if ( w <= 0 ) break;
 				while ( wend > 255 ) {
-					*(unsigned char *)animation.buffer_write_pointer = 255;
-					animation.buffer_write_pointer++;
-					*(unsigned char *)animation.buffer_write_pointer = 0;
-					animation.buffer_write_pointer++;
+					*(unsigned char *)wptr = 255;
+					wptr++;
+					*(unsigned char *)wptr = 0;
+					wptr++;
 					wend -= 255;
 					(*(unsigned char *)outptr)++;
 				}
@@ -1112,14 +1156,14 @@ long anim_make_FLI_LC(unsigned char *curdat, unsigned char *prvdat)
 						nsame--;
 						w--;
 					}
-					*(unsigned char *)animation.buffer_write_pointer = wend;
-					animation.buffer_write_pointer++;
-					*(unsigned char *)animation.buffer_write_pointer = nsame;
-					animation.buffer_write_pointer++;
-					*(unsigned char *)animation.buffer_write_pointer = cbf[0];
+					*(unsigned char *)wptr = wend;
+					wptr++;
+					*(unsigned char *)wptr = nsame;
+					wptr++;
+					*(unsigned char *)wptr = cbf[0];
 					cbf -= nsame;
 					pbf -= nsame;
-					animation.buffer_write_pointer++;
+					wptr++;
 					(*(unsigned char *)outptr)++;
 				} else {
 					if ( w == 1 ) {
@@ -1140,32 +1184,32 @@ long anim_make_FLI_LC(unsigned char *curdat, unsigned char *prvdat)
 						}
 					}
 					if (ndiff != 0) {
-						*(unsigned char *)animation.buffer_write_pointer = wend;
-						animation.buffer_write_pointer++;
-						*(unsigned char *)animation.buffer_write_pointer = ndiff;
-						animation.buffer_write_pointer++;
-						memcpy(animation.buffer_write_pointer, cbf, ndiff);
-						animation.buffer_write_pointer += ndiff;
+						*(unsigned char *)wptr = wend;
+						wptr++;
+						*(unsigned char *)wptr = ndiff;
+						wptr++;
+						memcpy(wptr, cbf, ndiff);
+						wptr += ndiff;
 						cbf += ndiff;
 						pbf += ndiff;
 						(*(unsigned char *)outptr)++;
 					}
 				}
 			}
-			cbuf += LbGraphicsScreenWidth();
-			pbuf += LbGraphicsScreenWidth();
+			cbuf += animation.header.width;
+			pbuf += animation.header.width;
 		}
 	} else {
-		*(short *)animation.buffer_write_pointer = 0;
-		animation.buffer_write_pointer += 2;
-		*(short *)animation.buffer_write_pointer = 1;
-		animation.buffer_write_pointer += 2;
-		*(char *)animation.buffer_write_pointer = 0;
-		animation.buffer_write_pointer++;
+		*(short *)wptr = 0;
+		wptr += 2;
+		*(short *)wptr = 1;
+		wptr += 2;
+		*(char *)wptr = 0;
+		wptr++;
 	}
 	// Make the data size even
-	animation.buffer_write_pointer = (unsigned char *)(((size_t)animation.buffer_write_pointer + 1) & 0xFFFFFFFE);
-	return animation.buffer_write_pointer - blk_begin;
+	wptr = (unsigned char *)(((size_t)wptr + 1) & 0xFFFFFFFE);
+	return wptr - blk_begin;
 }
 
 /*
@@ -1197,6 +1241,254 @@ short anim_format_matches(int width,int height,int bpp)
 	return true;
 }
 
+struct AnimDeltaJob {
+	unsigned char *curdat;
+	unsigned char *prvdat;
+	unsigned char *outbuf[AnDM_COUNT];
+	long size[AnDM_COUNT];
+};
+
+void anim_make_delta_chunks(void *data, long begin, long end)
+{
+	AnimDeltaJob *job = (AnimDeltaJob *)data;
+	for (long i = begin; i < end; i++)
+	{
+		switch (i)
+		{
+		case AnDM_BRUN:
+			job->size[i] = anim_make_FLI_BRUN(job->outbuf[i], job->curdat);
+			break;
+		case AnDM_SS2:
+			job->size[i] = anim_make_FLI_SS2(job->outbuf[i], job->curdat, job->prvdat);
+			break;
+		case AnDM_LC:
+			job->size[i] = anim_make_FLI_LC(job->outbuf[i], job->curdat, job->prvdat);
+			break;
+		}
+	}
+}
+
+/**
+ * Compresses and writes one frame of the animation.
+ * Called from the encoder thread, so it must not log.
+ * @return Returns false on error, true on success.
+ */
+TbBool anim_make_next_frame(unsigned char *screenbuf, unsigned char *palette)
+{
+	unsigned char *dataptr;
+	int width = animation.header.width;
+	int height = animation.header.height;
+	animation.buffer_write_pointer = animation.chunkdata;
+	animation.prefix.ctype = 0xF1FAu;
+	animation.prefix.nchunks = 0;
+	animation.prefix.csize = 0;
+	memset(animation.prefix.reserved, 0, sizeof(animation.prefix.reserved));
+	AnimFLIPrefix *prefx = (AnimFLIPrefix *)animation.buffer_write_pointer;
+	anim_store_data(&animation.prefix, sizeof(AnimFLIPrefix));
+	animation.subchunk.ctype = 0;
+	animation.subchunk.csize = 0;
+	AnimFLIChunk *subchnk = (AnimFLIChunk *)animation.buffer_write_pointer;
+	anim_store_data(&animation.subchunk, sizeof(AnimFLIChunk));
+	if ( animation.frame_count == 0 ) {
+		animation.header.oframe1 = animation.header.dsize;
+	} else if ( animation.frame_count == 1 ) {
+		animation.header.oframe2 = animation.header.dsize;
+	}
+	if ( anim_make_FLI_COLOUR256(palette) ) {
+		prefx->nchunks++;
+		subchnk->ctype = 4;
+		subchnk->csize = animation.buffer_write_pointer-(unsigned char *)subchnk;
+		animation.subchunk.ctype = 0;
+		animation.subchunk.csize = 0;
+		subchnk = (AnimFLIChunk *)animation.buffer_write_pointer;
+		anim_store_data(&animation.subchunk, sizeof(AnimFLIChunk));
+	}
+	int scrpoints = animation.header.height * (long)animation.header.width;
+	if (animation.frame_count == 0) {
+		long brun_size = anim_make_FLI_BRUN(animation.buffer_write_pointer, screenbuf);
+		if ( brun_size ) {
+			animation.buffer_write_pointer += brun_size;
+			prefx->nchunks++;
+			subchnk->ctype = FLI_BRUN;
+		} else {
+			anim_make_FLI_COPY(screenbuf);
+			prefx->nchunks++;
+			subchnk->ctype = FLI_COPY;
+		}
+	} else {
+		// Determining the best compression method; all are tried at once, each into its own buffer.
+		// Even padding depends on the address, so scratch data starts at the same parity as the chunk.
+		dataptr = animation.buffer_write_pointer;
+		AnimDeltaJob job;
+		job.curdat = screenbuf;
+		job.prvdat = animation.videobuf;
+		for (int i = 0; i < AnDM_COUNT; i++)
+		{
+			job.outbuf[i] = animation.deltabuf[i] + (((size_t)dataptr ^ (size_t)animation.deltabuf[i]) & 1);
+			job.size[i] = 0;
+		}
+		LbWorkersParallelFor(AnDM_COUNT, 1, anim_make_delta_chunks, &job);
+		long brun_size = job.size[AnDM_BRUN];
+		long ss2_size = job.size[AnDM_SS2];
+		long lc_size = job.size[AnDM_LC];
+		if ((lc_size < ss2_size) && (lc_size < brun_size)) {
+			// Store the LC compressed data
+			memcpy(dataptr, job.outbuf[AnDM_LC], lc_size);
+			animation.buffer_write_pointer = dataptr + lc_size;
+			prefx->nchunks++;
+			subchnk->ctype = FLI_LC;
+		} else if (ss2_size < brun_size) {
+			// Store the SS2 compressed data
+			memcpy(dataptr, job.outbuf[AnDM_SS2], ss2_size);
+			animation.buffer_write_pointer = dataptr + ss2_size;
+			prefx->nchunks++;
+			subchnk->ctype = FLI_SS2;
+		} else if ( brun_size < scrpoints+16 ) {
+			// Store the BRUN compressed data
+			memcpy(dataptr, job.outbuf[AnDM_BRUN], brun_size);
+			animation.buffer_write_pointer = dataptr + brun_size;
+			prefx->nchunks++;
+			subchnk->ctype = FLI_BRUN;
+		} else {
+			// Store uncompressed frame data
+			anim_make_FLI_COPY(screenbuf);
+			prefx->nchunks++;
+			subchnk->ctype = FLI_COPY;
+		}
+		// Compressors expect zeroed output; clear only what was written, including
+		// the few bytes SS2 may leave behind after stepping its pointer back
+		for (int i = 0; i < AnDM_COUNT; i++)
+		{
+			memset(job.outbuf[i], 0, job.size[i] + 4);
+		}
+	}
+	subchnk->csize = animation.buffer_write_pointer-(unsigned char *)subchnk;
+	prefx->csize = animation.buffer_write_pointer - animation.chunkdata;
+	long chunk_size = animation.buffer_write_pointer - animation.chunkdata;
+	TbBool written = anim_write_data(animation.chunkdata, chunk_size);
+	memset(animation.chunkdata, 0, chunk_size);
+	if (!written) {
+		return false;
+	}
+	memcpy(animation.videobuf, screenbuf, height*width);
+	memcpy(animation.palette, palette, sizeof(animation.palette));
+	animation.header.frames++;
+	animation.frame_count++;
+	animation.header.dsize += chunk_size;
+	return true;
+}
+
+void anim_encoder_thread(void)
+{
+	std::unique_lock<std::mutex> lock(anim_encoder.mutex);
+	while (true)
+	{
+		anim_encoder.frame_queued.wait(lock, [] { return anim_encoder.stopping || (anim_encoder.queued_count > 0); });
+		if (anim_encoder.queued_count == 0) {
+			// Stopping, and all captured frames are already written
+			break;
+		}
+		AnimCapturedFrame *frame = &anim_encoder.frames[anim_encoder.first_queued];
+		bool skip = anim_encoder.write_failed;
+		lock.unlock();
+		bool written = skip || anim_make_next_frame(frame->pixels, frame->palette);
+		lock.lock();
+		if (!written) {
+			anim_encoder.write_failed = true;
+		}
+		anim_encoder.first_queued = (anim_encoder.first_queued + 1) % ANIM_CAPTURE_FRAMES_COUNT;
+		anim_encoder.queued_count--;
+		anim_encoder.frame_freed.notify_one();
+	}
+}
+
+void anim_encoder_free_frames(void)
+{
+	for (int i = 0; i < ANIM_CAPTURE_FRAMES_COUNT; i++)
+	{
+		free(anim_encoder.frames[i].pixels);
+		anim_encoder.frames[i].pixels = NULL;
+	}
+}
+
+short anim_encoder_start(int width, int height)
+{
+	for (int i = 0; i < ANIM_CAPTURE_FRAMES_COUNT; i++)
+	{
+		// Compressors may read a few bytes past the frame end
+		anim_encoder.frames[i].pixels = static_cast<unsigned char *>(calloc(width * height + 16, 1));
+		if (anim_encoder.frames[i].pixels == NULL) {
+			ERRORLOG("Cannot allocate captured frame buffer.");
+			anim_encoder_free_frames();
+			return false;
+		}
+	}
+	anim_encoder.first_queued = 0;
+	anim_encoder.queued_count = 0;
+	anim_encoder.stopping = false;
+	anim_encoder.write_failed = false;
+	try {
+		anim_encoder.thread = std::thread(anim_encoder_thread);
+	} catch (const std::exception &e) {
+		ERRORLOG("Cannot start movie encoder: %s", e.what());
+		anim_encoder_free_frames();
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Waits until all captured frames are written, and stops the encoder thread.
+ * @return Returns false if writing any frame failed, true on success.
+ */
+short anim_encoder_stop(void)
+{
+	if (!anim_encoder.thread.joinable()) {
+		return true;
+	}
+	{
+		std::lock_guard<std::mutex> lock(anim_encoder.mutex);
+		anim_encoder.stopping = true;
+	}
+	anim_encoder.frame_queued.notify_one();
+	anim_encoder.thread.join();
+	anim_encoder_free_frames();
+	return !anim_encoder.write_failed;
+}
+
+/**
+ * Copies the frame into the capture ring buffer, to be encoded in background.
+ * Blocks only if the encoder has fallen behind and the ring is full.
+ * @return Returns false if the movie can no longer be written, true on success.
+ */
+TbBool anim_capture_frame(unsigned char *screenbuf, unsigned char *palette)
+{
+	std::unique_lock<std::mutex> lock(anim_encoder.mutex);
+	if (anim_encoder.write_failed) {
+		return false;
+	}
+	anim_encoder.frame_freed.wait(lock, [] { return anim_encoder.queued_count < ANIM_CAPTURE_FRAMES_COUNT; });
+	int idx = (anim_encoder.first_queued + anim_encoder.queued_count) % ANIM_CAPTURE_FRAMES_COUNT;
+	lock.unlock();
+	// The slot is not touched by the encoder until it is queued
+	AnimCapturedFrame *frame = &anim_encoder.frames[idx];
+	int width = animation.header.width;
+	int height = animation.header.height;
+	unsigned char *dst = frame->pixels;
+	unsigned char *src = screenbuf;
+	for (int h = 0; h < height; h++)
+	{
+		memcpy(dst, src, width);
+		dst += width;
+		src += LbGraphicsScreenWidth();
+	}
+	memcpy(frame->palette, palette, sizeof(frame->palette));
+	lock.lock();
+	anim_encoder.queued_count++;
+	anim_encoder.frame_queued.notify_one();
+	return true;
+}
+
 short anim_open(char *fname, int arg1, short arg2, int width, int height, int bpp, unsigned int flags)
 {
 	if ( flags & animation.state_flags ) {
@@ -1218,6 +1510,15 @@ short anim_open(char *fname, int arg1, short arg2, int width, int height, int bp
 			ERRORLOG("Cannot allocate chunk buffer.");
 			return false;
 		}
+		for (int i = 0; i < AnDM_COUNT; i++)
+		{
+			// One byte for matching parity, and slack for clearing after use
+			animation.deltabuf[i] = static_cast<unsigned char *>(calloc(max_chunk_size + 5, 1));
+			if (animation.deltabuf[i] == NULL) {
+				ERRORLOG("Cannot allocate compression buffer.");
+				return false;
+			}
+		}
 		animation.outfhndl = LbFileOpen(fname, Lb_FILE_MODE_NEW);
 		if (!animation.outfhndl) {
 			ERRORLOG("Can't open movie file.");
@@ -1251,6 +1552,10 @@ short anim_open(char *fname, int arg1, short arg2, int width, int height, int bp
 		animation.frame_count = 0;
 		animation.buffer_size = height*width + 1024;
 		memset(animation.palette, -1, sizeof(animation.palette));
+		if (!anim_encoder_start(width, height)) {
+			LbFileClose(animation.outfhndl);
+			return false;
+		}
 	}
 	if (flags & 0x02)  {
 		SYNCLOG("Resuming movie recording, \"%s\".",fname);
@@ -1290,108 +1595,6 @@ short anim_open(char *fname, int arg1, short arg2, int width, int height, int bp
 	return true;
 }
 
-TbBool anim_make_next_frame(unsigned char *screenbuf, unsigned char *palette)
-{
-	SYNCDBG(7,"Starting");
-	unsigned long max_chunk_size;
-	unsigned char *dataptr;
-	long brun_size;
-	long lc_size;
-	long ss2_size;
-	int width = animation.header.width;
-	int height = animation.header.height;
-	animation.buffer_write_pointer = animation.chunkdata;
-	max_chunk_size = anim_buffer_size(width,height,animation.header.depth);
-	memset(animation.chunkdata, 0, max_chunk_size);
-	animation.prefix.ctype = 0xF1FAu;
-	animation.prefix.nchunks = 0;
-	animation.prefix.csize = 0;
-	memset(animation.prefix.reserved, 0, sizeof(animation.prefix.reserved));
-	AnimFLIPrefix *prefx = (AnimFLIPrefix *)animation.buffer_write_pointer;
-	anim_store_data(&animation.prefix, sizeof(AnimFLIPrefix));
-	animation.subchunk.ctype = 0;
-	animation.subchunk.csize = 0;
-	AnimFLIChunk *subchnk = (AnimFLIChunk *)animation.buffer_write_pointer;
-	anim_store_data(&animation.subchunk, sizeof(AnimFLIChunk));
-	if ( animation.frame_count == 0 ) {
-		animation.header.oframe1 = animation.header.dsize;
-	} else if ( animation.frame_count == 1 ) {
-		animation.header.oframe2 = animation.header.dsize;
-	}
-	if ( anim_make_FLI_COLOUR256(palette) ) {
-		prefx->nchunks++;
-		subchnk->ctype = 4;
-		subchnk->csize = animation.buffer_write_pointer-(unsigned char *)subchnk;
-		animation.subchunk.ctype = 0;
-		animation.subchunk.csize = 0;
-		subchnk = (AnimFLIChunk *)animation.buffer_write_pointer;
-		anim_store_data(&animation.subchunk, sizeof(AnimFLIChunk));
-	}
-	int scrpoints = animation.header.height * (long)animation.header.width;
-	if (animation.frame_count == 0) {
-		if ( anim_make_FLI_BRUN(screenbuf) ) {
-			prefx->nchunks++;
-			subchnk->ctype = FLI_BRUN;
-		} else {
-			anim_make_FLI_COPY(screenbuf);
-			prefx->nchunks++;
-			subchnk->ctype = FLI_COPY;
-		}
-	} else {
-		// Determining the best compression method
-		dataptr = animation.buffer_write_pointer;
-		brun_size = anim_make_FLI_BRUN(screenbuf);
-		memset(dataptr, 0, brun_size);
-		animation.buffer_write_pointer = dataptr;
-		ss2_size = anim_make_FLI_SS2(screenbuf, animation.videobuf);
-		memset(dataptr, 0, ss2_size);
-		animation.buffer_write_pointer = dataptr;
-		lc_size = anim_make_FLI_LC(screenbuf, animation.videobuf);
-		if ((lc_size < ss2_size) && (lc_size < brun_size)) {
-			// Store the LC compressed data
-			prefx->nchunks++;
-			subchnk->ctype = FLI_LC;
-		} else if (ss2_size < brun_size) {
-			// Clear the LC compressed data
-			memset(dataptr, 0, lc_size);
-			animation.buffer_write_pointer = dataptr;
-			// Compress with SS2 method
-			anim_make_FLI_SS2(screenbuf, animation.videobuf);
-			prefx->nchunks++;
-			subchnk->ctype = FLI_SS2;
-		} else if ( brun_size < scrpoints+16 ) {
-			// Clear the LC compressed data
-			memset(dataptr, 0, lc_size);
-			animation.buffer_write_pointer = dataptr;
-			// Compress with BRUN method
-			anim_make_FLI_BRUN(screenbuf);
-			prefx->nchunks++;
-			subchnk->ctype = FLI_BRUN;
-		} else {
-			// Clear the LC compressed data
-			memset(dataptr, 0, lc_size);
-			animation.buffer_write_pointer = dataptr;
-			// Store uncompressed frame data
-			anim_make_FLI_COPY(screenbuf);
-			prefx->nchunks++;
-			subchnk->ctype = FLI_COPY;
-		}
-	}
-	subchnk->csize = animation.buffer_write_pointer-(unsigned char *)subchnk;
-	prefx->csize = animation.buffer_write_pointer - animation.chunkdata;
-	if ( !anim_write_data(animation.chunkdata, animation.buffer_write_pointer-animation.chunkdata) ) {
-		//LbSyncLog("Finished frame w/error.\n");
-		return false;
-	}
-	memcpy(animation.videobuf, screenbuf, height*width);
-	memcpy(animation.palette, palette, sizeof(animation.palette));
-	animation.header.frames++;
-	animation.frame_count++;
-	animation.header.dsize += animation.buffer_write_pointer-animation.chunkdata;
-	//LbSyncLog("Finished frame ok.\n");
-	return true;
-}
-
 } // local
 
 extern "C" short anim_stop()
@@ -1401,6 +1604,9 @@ extern "C" short anim_stop()
 	  ERRORLOG("Can't stop recording movie");
 	  return false;
 	}
+	if (!anim_encoder_stop()) {
+		ERRORLOG("Movie write error.");
+	}
 	LbFileSeek(animation.outfhndl, 0, Lb_FILE_SEEK_BEGINNING);
 	animation.header.frames--;
 	LbFileWrite(animation.outfhndl, &animation.header, sizeof(AnimFLIHeader));
@@ -1411,6 +1617,13 @@ extern "C" short anim_stop()
 	animation.outfhndl = nullptr;
 	free(animation.chunkdata);
 	animation.chunkdata=NULL;
+	free(animation.videobuf);
+	animation.videobuf=NULL;
+	for (int i = 0; i < AnDM_COUNT; i++)
+	{
+		free(animation.deltabuf[i]);
+		animation.deltabuf[i]=NULL;
+	}
 	animation.state_flags = 0;
 	return true;
 }
@@ -1422,7 +1635,7 @@ extern "C" TbBool anim_record_frame(unsigned char *screenbuf, unsigned char *pal
 	} else if (!anim_format_matches(MyScreenWidth/pixel_size,MyScreenHeight/pixel_size,LbGraphicsScreenBPP())) {
 		return false;
 	}
-	return anim_make_next_frame(screenbuf, palette);
+	return anim_capture_frame(screenbuf, palette);
 }
 
 extern "C" short anim_record()
@@ -0,0 +1,196 @@
+/******************************************************************************/
+// Bullfrog Engine Emulation Library - for use to remake classic games like
+// Syndicate Wars, Magic Carpet or Dungeon Keeper.
+/******************************************************************************/
+/** @file bflib_workers.cpp
+ *     Persistent worker thread pool for data-parallel jobs.
+ * @par Purpose:
+ *     Allows splitting per-frame work, like post-processing of rendered
+ *     frame rows, between all CPU cores.
+ * @par Comment:
+ *     Threads are started on first job and wait on a condition variable
+ *     between jobs. The calling thread takes part in processing the job,
+ *     so single core machines run jobs with no threads at all.
+ * @author   KeeperFX Team
+ * @date     19 Oct 2026 - 19 Oct 2026
+ * @par  Copying and copyrights:
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ */
+/******************************************************************************/
+#include "pre_inc.h"
+#include "bflib_workers.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "post_inc.h"
+
+namespace {
+
+struct WorkerJob {
+    LbWorkerRangeFunc func;
+    void *data;
+    long count;
+    long chunk;
+    std::atomic<long> next;
+    std::atomic<long> pending;
+};
+
+class WorkerPool {
+public:
+    WorkerPool() : m_generation(0), m_job(nullptr), m_active(0), m_quit(false) {}
+    ~WorkerPool() { Stop(); }
+
+    int ThreadsCount() const { return (int)m_threads.size(); }
+
+    void Start()
+    {
+        if (!m_threads.empty())
+            return;
+        unsigned int cores = std::thread::hardware_concurrency();
+        if (cores <= 1)
+            return;
+        unsigned int num = cores - 1;
+        if (num > WORKERS_MAX_THREADS)
+            num = WORKERS_MAX_THREADS;
+        m_quit = false;
+        for (unsigned int i = 0; i < num; i++)
+            m_threads.emplace_back(&WorkerPool::ThreadMain, this);
+    }
+
+    void Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_quit = true;
+        }
+        m_wake.notify_all();
+        for (std::thread &thr : m_threads)
+            thr.join();
+        m_threads.clear();
+    }
+
+    void Run(WorkerJob *job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_job = job;
+            m_generation++;
+        }
+        m_wake.notify_all();
+        ProcessChunks(job);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        // Wait for chunks taken by workers, and for workers to let go of the job
+        m_done.wait(lock, [&] { return (job->pending.load() == 0) && (m_active == 0); });
+        m_job = nullptr;
+    }
+
+    std::mutex m_submit;
+
+private:
+    static void ProcessChunks(WorkerJob *job)
+    {
+        while (true)
+        {
+            long begin = job->next.fetch_add(job->chunk);
+            if (begin >= job->count)
+                break;
+            long end = begin + job->chunk;
+            if (end > job->count)
+                end = job->count;
+            job->func(job->data, begin, end);
+            job->pending.fetch_sub(1);
+        }
+    }
+
+    void ThreadMain()
+    {
+        unsigned long seen_generation = 0;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_wake.wait(lock, [&] { return m_quit || ((m_job != nullptr) && (m_generation != seen_generation)); });
+            if (m_quit)
+                break;
+            seen_generation = m_generation;
+            WorkerJob *job = m_job;
+            m_active++;
+            lock.unlock();
+            ProcessChunks(job);
+            lock.lock();
+            m_active--;
+            m_done.notify_all();
+        }
+    }
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    unsigned long m_generation;
+    WorkerJob *m_job;
+    int m_active;
+    bool m_quit;
+};
+
+WorkerPool workers_pool;
+
+}
+
+/******************************************************************************/
+extern "C" {
+
+void LbWorkersParallelFor(long count, long min_chunk, LbWorkerRangeFunc func, void *data)
+{
+    if (count <= 0)
+        return;
+    if (min_chunk < 1)
+        min_chunk = 1;
+    // Nested or concurrent submissions are executed in place
+    std::unique_lock<std::mutex> submit(workers_pool.m_submit, std::try_to_lock);
+    if (!submit.owns_lock() || (count <= min_chunk))
+    {
+        func(data, 0, count);
+        return;
+    }
+    workers_pool.Start();
+    long num_threads = workers_pool.ThreadsCount() + 1;
+    if (num_threads <= 1)
+    {
+        func(data, 0, count);
+        return;
+    }
+    // Few chunks per thread, so that uneven chunk costs are balanced
+    long chunk = (count + num_threads * 4 - 1) / (num_threads * 4);
+    if (chunk < min_chunk)
+        chunk = min_chunk;
+    WorkerJob job;
+    job.func = func;
+    job.data = data;
+    job.count = count;
+    job.chunk = chunk;
+    job.next = 0;
+    job.pending = (count + chunk - 1) / chunk;
+    workers_pool.Run(&job);
+}
+
+int LbWorkersCount(void)
+{
+    int num = workers_pool.ThreadsCount();
+    return num + 1;
+}
+
+void LbWorkersShutdown(void)
+{
+    std::lock_guard<std::mutex> submit(workers_pool.m_submit);
+    workers_pool.Stop();
+}
+
+}
+/******************************************************************************/
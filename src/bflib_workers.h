@@ -0,0 +1,55 @@
+/******************************************************************************/
+// Bullfrog Engine Emulation Library - for use to remake classic games like
+// Syndicate Wars, Magic Carpet or Dungeon Keeper.
+/******************************************************************************/
+/** @file bflib_workers.h
+ *     Header file for bflib_workers.cpp.
+ * @par Purpose:
+ *     Persistent worker thread pool for data-parallel jobs.
+ * @par Comment:
+ *     Just a header file - #defines, typedefs, function prototypes etc.
+ * @author   KeeperFX Team
+ * @date     19 Oct 2026 - 19 Oct 2026
+ * @par  Copying and copyrights:
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ */
+/******************************************************************************/
+#ifndef BFLIB_WORKERS_H
+#define BFLIB_WORKERS_H
+
+#include "bflib_basics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************/
+/** Maximal amount of worker threads, not counting the calling thread. */
+#define WORKERS_MAX_THREADS 15
+
+/**
+ * Function processing items [begin,end) of a parallel job.
+ * Ranges given to one job never overlap, and may be processed concurrently.
+ */
+typedef void (*LbWorkerRangeFunc)(void *data, long begin, long end);
+
+/**
+ * Splits items [0,count) into chunks of at least min_chunk items and processes
+ * them with func on the worker threads and the calling thread.
+ * Returns when all items were processed. Jobs submitted while another job is
+ * running (ie. from within func) are executed serially on the calling thread.
+ * Range functions must not touch game state which is not owned by the job,
+ * and must not call logging or any other non thread-safe routines.
+ */
+void LbWorkersParallelFor(long count, long min_chunk, LbWorkerRangeFunc func, void *data);
+/** Returns amount of threads which execute parallel jobs, including the caller. */
+int LbWorkersCount(void);
+/** Stops and joins the worker threads; they are restarted on next job. */
+void LbWorkersShutdown(void);
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+#endif
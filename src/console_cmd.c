@@ -38,6 +38,7 @@
 #include "creature_states.h"
 #include "creature_states_hero.h"
 #include "dungeon_data.h"
+#include "engine_occlusion.h"
 #include "frontend.h"
 #include "frontmenu_ingame_evnt.h"
 #include "frontmenu_ingame_tabs.h"
@@ -526,6 +527,13 @@ TbBool cmd_frametime_max(PlayerNumber plyr_idx, char * args)
     return true;
 }
 
+TbBool cmd_occlusion(PlayerNumber plyr_idx, char * args)
+{
+    occlusion_culling_enabled = !occlusion_culling_enabled;
+    targeted_message_add(MsgType_Player, plyr_idx, plyr_idx, GUI_MESSAGES_DELAY, "Occlusion culling %s", occlusion_culling_enabled ? "on" : "off");
+    return true;
+}
+
 TbBool cmd_network_stats(PlayerNumber plyr_idx, char * args)
 {
     if (debug_display_network_stats != 0) {
@@ -1926,7 +1934,7 @@ TbBool cmd_mapwho_info(PlayerNumber plyr_idx, char * args)
                             thing_class_and_model_name(thing->class_id, thing->model));
     targeted_message_add(MsgType_Player, plyr_idx, plyr_idx, GUI_MESSAGES_DELAY, "flags: %02x,filled: %d, wib: %d, col: %04ld", block->flags,
                             block->filled_subtiles, block->wibble_value, block->col_idx);
-    targeted_message_add(MsgType_Player, plyr_idx, plyr_idx, GUI_MESSAGES_DELAY, "mapwho: %04ld, rev: %d", block->mapwho, block->revealed);
+    targeted_message_add(MsgType_Player, plyr_idx, plyr_idx, GUI_MESSAGES_DELAY, "mapwho: %04ld, rev: %d", block->mapwho, get_map_block_revealed_flags(block));
     targeted_message_add(MsgType_Player, plyr_idx, plyr_idx, GUI_MESSAGES_DELAY, "stl_x: %d, stl_y:%d", pos.x.stl.num,
                             pos.y.stl.num);
     return true;
@@ -2755,6 +2763,7 @@ static const struct ConsoleCommand console_commands[] = {
     { "ft", cmd_frametime, NULL },
     { "frametime.max", cmd_frametime_max, NULL },
     { "ft.max", cmd_frametime_max, NULL },
+    { "occlusion", cmd_occlusion, NULL },
     { "netstats", cmd_network_stats, NULL },
     { "quit", cmd_quit, NULL },
     { "time", cmd_time, NULL },
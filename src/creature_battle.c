@@ -36,10 +36,51 @@
 #include "post_inc.h"
 
 /******************************************************************************/
+/** Max amount of target candidates stored for all battles within one turn. */
+#define BATTLE_CANDIDATES_COUNT (2*CREATURES_COUNT)
+/** Allowance for movement of fighters and candidates after the candidates list was made. */
+#define BATTLE_CANDIDATES_SLACK subtile_coord(2,0)
+/** Distance a listed candidate may go from its listed position before the list is remade.
+ * Candidates are checked when they change subtile, so one subtile of the slack is kept
+ * for movement within a subtile. */
+#define BATTLE_CANDIDATES_MOVE_LIMIT (BATTLE_CANDIDATES_SLACK - COORD_PER_STL)
+/** Margin around the covered area within which creatures are listed, and their placement is checked. */
+#define BATTLE_CANDIDATES_MARGIN (BATTLE_CANDIDATES_SLACK + COORD_PER_STL)
+
+enum BattleCandidatesState {
+    BCSt_NotMade = 0,
+    BCSt_Ready,
+    BCSt_Overflow,
+};
+
+/** Creature which may be attacked by someone in a battle, with position at time the list was made. */
+struct BattleCandidate {
+    ThingIndex index;
+    int32_t creation_turn;
+    MapCoord pos_x;
+    MapCoord pos_y;
+    MapCoordDelta half_clipbox;
+};
+
+/** Candidates of a battle, and the area around battle fighters which they cover. */
+struct BattleCandidatesList {
+    unsigned char state;
+    MapCoord cover_min_x;
+    MapCoord cover_min_y;
+    MapCoord cover_max_x;
+    MapCoord cover_max_y;
+    unsigned long first;
+    unsigned long count;
+};
 
 unsigned short friendly_battler_list[3*MESSAGE_BATTLERS_COUNT];
 unsigned short enemy_battler_list[3*MESSAGE_BATTLERS_COUNT];
 
+static struct BattleCandidatesList battle_candidates_lists[BATTLES_COUNT];
+static struct BattleCandidate battle_candidates[BATTLE_CANDIDATES_COUNT];
+static unsigned long battle_candidates_used;
+static unsigned long battle_candidates_ready_count;
+
 /******************************************************************************/
 /**
  * Returns CreatureBattle of given index.
@@ -344,6 +385,7 @@ void battle_initialise(void)
     {
         memset(&game.battles[battle_idx], 0, sizeof(struct CreatureBattle));
     }
+    clear_battle_candidates();
 }
 
 BattleIndex find_next_battle_of_mine(PlayerNumber plyr_idx, BattleIndex prev_idx)
@@ -549,4 +591,209 @@ unsigned long count_active_battles(PlayerNumber plyr_idx)
     }
     return result;
 }
+
+/**
+ * Forgets target candidates of all battles.
+ * Candidates are made once per turn, so this should be called at start of every turn.
+ */
+void clear_battle_candidates(void)
+{
+    memset(battle_candidates_lists, 0, sizeof(battle_candidates_lists));
+    battle_candidates_used = 0;
+    battle_candidates_ready_count = 0;
+}
+
+/**
+ * Returns max distance from a creature at which an enemy can still be fought, not including enemy size.
+ * Combat needs the enemy to be heard or seen, so it is limited by hearing and visual range.
+ */
+static MapCoordDelta get_creature_combat_reach(const struct Thing *creatng)
+{
+    struct CreatureModelConfig* crconf = creature_stats_get_from_thing(creatng);
+    MapCoordDelta range = subtile_coord(max(crconf->hearing, crconf->visual_range), 0);
+    // One more for rounding of halved sizes
+    return range + creatng->clipbox_size_xy / 2 + 1;
+}
+
+static void make_battle_candidates(BattleIndex battle_id, struct BattleCandidatesList *bclist)
+{
+    struct CreatureBattle* battle = creature_battle_get(battle_id);
+    bclist->state = BCSt_Overflow;
+    bclist->cover_min_x = INT32_MAX;
+    bclist->cover_min_y = INT32_MAX;
+    bclist->cover_max_x = 0;
+    bclist->cover_max_y = 0;
+    // Area in which fighters of the battle may find enemies
+    unsigned long k = 0;
+    long i = battle->first_creatr;
+    while (i > 0)
+    {
+        struct Thing* thing = thing_get(i);
+        struct CreatureControl* cctrl = creature_control_get_from_thing(thing);
+        if (creature_control_invalid(cctrl))
+        {
+            ERRORLOG("Invalid control of thing in battle, index %d.",(int)i);
+            return;
+        }
+        i = cctrl->battle_prev_creatr;
+        // Per battle creature code
+        MapCoordDelta reach = get_creature_combat_reach(thing) + BATTLE_CANDIDATES_SLACK;
+        bclist->cover_min_x = min(bclist->cover_min_x, thing->mappos.x.val - reach);
+        bclist->cover_min_y = min(bclist->cover_min_y, thing->mappos.y.val - reach);
+        bclist->cover_max_x = max(bclist->cover_max_x, thing->mappos.x.val + reach);
+        bclist->cover_max_y = max(bclist->cover_max_y, thing->mappos.y.val + reach);
+        // Per battle creature code ends
+        k++;
+        if (k > CREATURES_COUNT)
+        {
+            ERRORLOG("Infinite loop detected when sweeping battle creatures list");
+            return;
+        }
+    }
+    // Creatures within that area, in the same order as in creatures list
+    bclist->first = battle_candidates_used;
+    bclist->count = 0;
+    struct StructureList* slist = get_list_for_thing_class(TCls_Creature);
+    k = 0;
+    i = slist->index;
+    while (i != 0)
+    {
+        struct Thing* thing = thing_get(i);
+        if (thing_is_invalid(thing))
+        {
+            ERRORLOG("Jump to invalid thing detected");
+            return;
+        }
+        i = thing->next_of_class;
+        // Per-thing code
+        MapCoordDelta margin = thing->clipbox_size_xy / 2 + BATTLE_CANDIDATES_MARGIN;
+        if ((thing->mappos.x.val + margin >= bclist->cover_min_x) && (thing->mappos.x.val - margin <= bclist->cover_max_x) &&
+            (thing->mappos.y.val + margin >= bclist->cover_min_y) && (thing->mappos.y.val - margin <= bclist->cover_max_y))
+        {
+            if (battle_candidates_used >= BATTLE_CANDIDATES_COUNT) {
+                return;
+            }
+            struct BattleCandidate* bcand = &battle_candidates[battle_candidates_used];
+            bcand->index = thing->index;
+            bcand->creation_turn = thing->creation_turn;
+            bcand->pos_x = thing->mappos.x.val;
+            bcand->pos_y = thing->mappos.y.val;
+            bcand->half_clipbox = thing->clipbox_size_xy / 2;
+            battle_candidates_used++;
+            bclist->count++;
+        }
+        // Per-thing code ends
+        k++;
+        if (k > slist->count)
+        {
+            ERRORLOG("Infinite loop detected when sweeping things list");
+            return;
+        }
+    }
+    bclist->state = BCSt_Ready;
+    battle_candidates_ready_count++;
+    SYNCDBG(18,"Battle %d has %lu candidates",(int)battle_id,bclist->count);
+}
+
+/**
+ * Forgets candidates of battles which could be affected by a creature placed in mapwho.
+ * Called whenever a creature is placed on the map or changes subtile, so that the lists
+ * give the same enemies as a sweep through the whole creatures list would give.
+ * Listed creatures which moved only a little keep the list, as their listed position
+ * is only used with the slack added.
+ * @param thing The creature which was placed.
+ */
+void battle_candidates_creature_placed(const struct Thing *thing)
+{
+    if ((battle_candidates_ready_count == 0) || (thing->class_id != TCls_Creature))
+        return;
+    MapCoordDelta margin = thing->clipbox_size_xy / 2 + BATTLE_CANDIDATES_MARGIN;
+    for (BattleIndex battle_id = 1; battle_id < BATTLES_COUNT; battle_id++)
+    {
+        struct BattleCandidatesList* bclist = &battle_candidates_lists[battle_id];
+        if (bclist->state != BCSt_Ready)
+            continue;
+        if ((thing->mappos.x.val + margin < bclist->cover_min_x) || (thing->mappos.x.val - margin > bclist->cover_max_x) ||
+            (thing->mappos.y.val + margin < bclist->cover_min_y) || (thing->mappos.y.val - margin > bclist->cover_max_y))
+            continue;
+        TbBool listed_nearby = false;
+        for (unsigned long n = 0; n < bclist->count; n++)
+        {
+            struct BattleCandidate* bcand = &battle_candidates[bclist->first + n];
+            if ((bcand->index == thing->index) && (bcand->creation_turn == thing->creation_turn))
+            {
+                listed_nearby = (abs(bcand->pos_x - thing->mappos.x.val) <= BATTLE_CANDIDATES_MOVE_LIMIT) &&
+                    (abs(bcand->pos_y - thing->mappos.y.val) <= BATTLE_CANDIDATES_MOVE_LIMIT);
+                break;
+            }
+        }
+        if (listed_nearby)
+            continue;
+        // The list will be made again by next fighter which needs it
+        bclist->state = BCSt_NotMade;
+        battle_candidates_ready_count--;
+    }
+}
+
+/**
+ * Finds the highest scoring enemy among target candidates of the battle given creature fights in.
+ * Gives the same thing get_nth_thing_of_class_with_filter() would give for the first match,
+ * as long as the filter cannot accept a creature which is beyond hearing and visual range.
+ * Candidates are shared by all fighters of the battle; they're made on first use in a turn,
+ * and made again when a creature is placed near the battle.
+ * @param fightng The creature looking for an enemy.
+ * @param filter Filter function, scoring the enemies.
+ * @param param Filter parameters.
+ * @param outtng Returns the best enemy, or invalid thing if none was accepted.
+ * @return True if candidates were used; false if they cannot be used and whole list should be searched.
+ */
+TbBool get_battle_candidate_with_filter(const struct Thing *fightng, Thing_Maximizer_Filter filter, MaxTngFilterParam param, struct Thing **outtng)
+{
+    struct CreatureControl* figctrl = creature_control_get_from_thing(fightng);
+    if (creature_control_invalid(figctrl) || (figctrl->battle_id < 1) || (figctrl->battle_id >= BATTLES_COUNT))
+        return false;
+    struct BattleCandidatesList* bclist = &battle_candidates_lists[figctrl->battle_id];
+    if (bclist->state == BCSt_NotMade)
+        make_battle_candidates(figctrl->battle_id, bclist);
+    if (bclist->state != BCSt_Ready)
+        return false;
+    // Fighter could have joined the battle, or moved, after the list was made
+    MapCoordDelta reach = get_creature_combat_reach(fightng);
+    if ((fightng->mappos.x.val - reach < bclist->cover_min_x) || (fightng->mappos.x.val + reach > bclist->cover_max_x) ||
+        (fightng->mappos.y.val - reach < bclist->cover_min_y) || (fightng->mappos.y.val + reach > bclist->cover_max_y))
+        return false;
+    long maximizer = 0;
+    long curindex = 0;
+    struct Thing* retng = INVALID_THING;
+    for (unsigned long n = 0; n < bclist->count; n++)
+    {
+        struct BattleCandidate* bcand = &battle_candidates[bclist->first + n];
+        MapCoordDelta cand_reach = reach + bcand->half_clipbox + BATTLE_CANDIDATES_SLACK;
+        if ((abs(bcand->pos_x - fightng->mappos.x.val) > cand_reach) || (abs(bcand->pos_y - fightng->mappos.y.val) > cand_reach))
+            continue;
+        struct Thing* thing = thing_get(bcand->index);
+        // Skip creatures which died since the list was made
+        if (!thing_is_creature(thing) || (thing->creation_turn != bcand->creation_turn))
+            continue;
+        long score = filter(thing, param, maximizer);
+        if (score > maximizer)
+        {
+            retng = thing;
+            maximizer = score;
+            curindex = 0;
+        } else
+        if (score == maximizer)
+        {
+            if (curindex <= 0) {
+                retng = thing;
+            }
+            if (maximizer == INT32_MAX) {
+                break;
+            }
+            curindex++;
+        }
+    }
+    *outtng = retng;
+    return true;
+}
 /******************************************************************************/
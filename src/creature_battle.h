@@ -21,6 +21,7 @@
 
 #include "bflib_basics.h"
 #include "globals.h"
+#include "thing_list.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -77,6 +78,9 @@ void maintain_my_battle_list(void);
 TbBool step_battles_forward(PlayerNumber plyr_idx);
 long battle_move_player_towards_battle(struct PlayerInfo *player, BattleIndex battle_id);
 void battle_initialise(void);
+void clear_battle_candidates(void);
+void battle_candidates_creature_placed(const struct Thing *thing);
+TbBool get_battle_candidate_with_filter(const struct Thing *fightng, Thing_Maximizer_Filter filter, MaxTngFilterParam param, struct Thing **outtng);
 /******************************************************************************/
 #ifdef __cplusplus
 }
@@ -39,6 +39,92 @@
 const int CREATURE_EXPLORE_DISTANCE = 7;
 const int CREATURE_EXPLORE_DISTANCE_POSSESSED = 10;
 
+/** Amount of entries in line of sight results cache; must be power of 2. */
+#define LINE_OF_SIGHT_CACHE_SIZE 1024
+
+enum LineOfSightVariant {
+    LoSV_None = 0,
+    LoSV_Plain2D,
+    LoSV_Plain3D,
+    LoSV_LavaOwnDoor3D,
+    LoSV_NoWibble3D,
+};
+
+struct LineOfSightCacheEntry {
+    unsigned long stamp;
+    MapCoord from_x;
+    MapCoord from_y;
+    MapCoord from_z;
+    MapCoord to_x;
+    MapCoord to_y;
+    MapCoord to_z;
+    unsigned char variant;
+    PlayerNumber plyr_idx;
+    TbBool result;
+};
+
+typedef TbBool (*LineOfSightFunc)(const struct Coord3d *frpos, const struct Coord3d *topos, PlayerNumber plyr_idx);
+
+TbBool line_of_sight_cache_enabled = true;
+struct LineOfSightCacheStats line_of_sight_cache_stats;
+
+static struct LineOfSightCacheEntry line_of_sight_cache[LINE_OF_SIGHT_CACHE_SIZE];
+static unsigned long line_of_sight_cache_stamp = 1;
+/******************************************************************************/
+/**
+ * Forgets all cached line of sight results.
+ * Needs to be called whenever anything the sight depends on changes - map columns,
+ * door locks or alliances; also at start of every game turn, to cover loading and resyncs.
+ */
+void invalidate_line_of_sight_cache(void)
+{
+    line_of_sight_cache_stamp++;
+    if (line_of_sight_cache_stamp == 0)
+    {
+        memset(line_of_sight_cache, 0, sizeof(line_of_sight_cache));
+        line_of_sight_cache_stamp = 1;
+    }
+}
+
+/**
+ * Returns result of given line of sight function, using result cache if possible.
+ * The cache is keyed by exact positions, so results are always the same as the function would return.
+ */
+static TbBool cached_line_of_sight(LineOfSightFunc los_func, unsigned char variant,
+    const struct Coord3d *frpos, const struct Coord3d *topos, PlayerNumber plyr_idx)
+{
+    if (!line_of_sight_cache_enabled)
+        return los_func(frpos, topos, plyr_idx);
+    unsigned long hash = variant * 31 + plyr_idx;
+    hash = hash * 2654435761UL + frpos->x.val;
+    hash = hash * 2654435761UL + frpos->y.val;
+    hash = hash * 2654435761UL + frpos->z.val;
+    hash = hash * 2654435761UL + topos->x.val;
+    hash = hash * 2654435761UL + topos->y.val;
+    hash = hash * 2654435761UL + topos->z.val;
+    struct LineOfSightCacheEntry *entry = &line_of_sight_cache[(hash ^ (hash >> 16)) & (LINE_OF_SIGHT_CACHE_SIZE - 1)];
+    if ((entry->stamp == line_of_sight_cache_stamp) && (entry->variant == variant) && (entry->plyr_idx == plyr_idx) &&
+        (entry->from_x == frpos->x.val) && (entry->from_y == frpos->y.val) && (entry->from_z == frpos->z.val) &&
+        (entry->to_x == topos->x.val) && (entry->to_y == topos->y.val) && (entry->to_z == topos->z.val))
+    {
+        line_of_sight_cache_stats.hits++;
+        return entry->result;
+    }
+    line_of_sight_cache_stats.misses++;
+    TbBool result = los_func(frpos, topos, plyr_idx);
+    entry->stamp = line_of_sight_cache_stamp;
+    entry->variant = variant;
+    entry->plyr_idx = plyr_idx;
+    entry->from_x = frpos->x.val;
+    entry->from_y = frpos->y.val;
+    entry->from_z = frpos->z.val;
+    entry->to_x = topos->x.val;
+    entry->to_y = topos->y.val;
+    entry->to_z = topos->z.val;
+    entry->result = result;
+    return result;
+}
+
 /******************************************************************************/
 TbBool sibling_line_of_sight_ignoring_door(const struct Coord3d *prevpos,
     const struct Coord3d *nextpos, const struct Thing *doortng)
@@ -496,7 +582,7 @@ TbBool sibling_line_of_sight_3d_including_lava_check_ignoring_own_door(const str
     return true;
 }
 
-TbBool jonty_line_of_sight_3d_including_lava_check_ignoring_own_door(const struct Coord3d *frpos,
+static TbBool line_of_sight_3d_including_lava_check_ignoring_own_door_uncached(const struct Coord3d *frpos,
     const struct Coord3d *topos, PlayerNumber plyr_idx)
 {
     MapCoordDelta dx = topos->x.val - (MapCoordDelta)frpos->x.val;
@@ -593,6 +679,13 @@ TbBool jonty_line_of_sight_3d_including_lava_check_ignoring_own_door(const struc
     return true;
 }
 
+TbBool jonty_line_of_sight_3d_including_lava_check_ignoring_own_door(const struct Coord3d *frpos,
+    const struct Coord3d *topos, PlayerNumber plyr_idx)
+{
+    return cached_line_of_sight(line_of_sight_3d_including_lava_check_ignoring_own_door_uncached,
+        LoSV_LavaOwnDoor3D, frpos, topos, plyr_idx);
+}
+
 TbBool creature_can_see_thing(struct Thing *creatng, struct Thing *thing)
 {
     struct Coord3d thing_pos;
@@ -734,7 +827,7 @@ TbBool jonty_creature_can_see_thing_including_lava_check(const struct Thing *cre
     }
 }
 
-TbBool line_of_sight_2d(const struct Coord3d *frpos, const struct Coord3d *topos)
+static TbBool line_of_sight_2d_uncached(const struct Coord3d *frpos, const struct Coord3d *topos, PlayerNumber plyr_idx)
 {
 
     MapCoordDelta pos_delta_x;
@@ -802,7 +895,7 @@ TbBool line_of_sight_2d(const struct Coord3d *frpos, const struct Coord3d *topos
     return false;
 }
 
-TbBool line_of_sight_3d(const struct Coord3d *frpos, const struct Coord3d *topos)
+static TbBool line_of_sight_3d_uncached(const struct Coord3d *frpos, const struct Coord3d *topos, PlayerNumber plyr_idx)
 {
     MapCoordDelta dx = topos->x.val - (MapCoordDelta)frpos->x.val;
     MapCoordDelta dy = topos->y.val - (MapCoordDelta)frpos->y.val;
@@ -912,7 +1005,17 @@ TbBool line_of_sight_3d(const struct Coord3d *frpos, const struct Coord3d *topos
     return true;
 }
 
-TbBool nowibble_line_of_sight_3d(const struct Coord3d *frpos, const struct Coord3d *topos)
+TbBool line_of_sight_2d(const struct Coord3d *frpos, const struct Coord3d *topos)
+{
+    return cached_line_of_sight(line_of_sight_2d_uncached, LoSV_Plain2D, frpos, topos, 0);
+}
+
+TbBool line_of_sight_3d(const struct Coord3d *frpos, const struct Coord3d *topos)
+{
+    return cached_line_of_sight(line_of_sight_3d_uncached, LoSV_Plain3D, frpos, topos, 0);
+}
+
+static TbBool nowibble_line_of_sight_3d_uncached(const struct Coord3d *frpos, const struct Coord3d *topos, PlayerNumber plyr_idx)
 {
     MapCoordDelta dx,dy,dz;
     dx = topos->x.val - (MapCoordDelta)frpos->x.val;
@@ -1019,6 +1122,11 @@ TbBool nowibble_line_of_sight_3d(const struct Coord3d *frpos, const struct Coord
     return true;
 }
 
+TbBool nowibble_line_of_sight_3d(const struct Coord3d *frpos, const struct Coord3d *topos)
+{
+    return cached_line_of_sight(nowibble_line_of_sight_3d_uncached, LoSV_NoWibble3D, frpos, topos, 0);
+}
+
 TbBool line_of_room_move_2d(const struct Coord3d *frpos, const struct Coord3d *topos, struct Room *room)
 {
     MapCoordDelta delta_x;
@@ -33,6 +33,16 @@ extern "C" {
 struct Thing;
 
 #pragma pack()
+
+/** Counters of line of sight results cache, for debugging and benchmarks. */
+struct LineOfSightCacheStats {
+    unsigned long hits;
+    unsigned long misses;
+};
+/******************************************************************************/
+/** When false, line of sight is always computed; results are identical either way. */
+extern TbBool line_of_sight_cache_enabled;
+extern struct LineOfSightCacheStats line_of_sight_cache_stats;
 /******************************************************************************/
 TbBool jonty_creature_can_see_thing_including_lava_check(const struct Thing *creatng, const struct Thing *thing);
 TbBool sibling_line_of_sight_ignoring_door(const struct Coord3d *prevpos,
@@ -48,6 +58,7 @@ TbBool creature_can_see_thing(struct Thing *creatng, struct Thing *thing);
 TbBool creature_can_see_thing_ignoring_specific_door(struct Thing *creatng, struct Thing *thing,struct Thing *doortng);
 
 long get_explore_sight_distance_in_slabs(const struct Thing *thing);
+void invalidate_line_of_sight_cache(void);
 /******************************************************************************/
 #ifdef __cplusplus
 }
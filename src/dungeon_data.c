@@ -546,6 +546,8 @@ void init_dungeons(void)
         dungeon->num_active_creatrs = 0;
         dungeon->creatr_list_start = 0;
         dungeon->digger_list_start = 0;
+        memset(dungeon->creatr_list_of_model, 0, sizeof(dungeon->creatr_list_of_model));
+        memset(dungeon->digger_list_of_model, 0, sizeof(dungeon->digger_list_of_model));
         dungeon->owner = i;
         dungeon->max_creatures_attracted = game.conf.rules[i].rooms.default_max_crtrs_gen_entrance;
         dungeon->dead_creatures_count = 0;
@@ -179,6 +179,10 @@ struct Dungeon {
     unsigned short num_active_diggers;
     unsigned short num_active_creatrs;
     unsigned short owned_creatures_of_model[CREATURE_TYPES_MAX];
+    /** Amount of creatures of each model on creatr_list, including ones not counted as owned. Updated along with the list. */
+    unsigned short creatr_list_of_model[CREATURE_TYPES_MAX];
+    /** Amount of creatures of each model on digger_list, including ones not counted as owned. Updated along with the list. */
+    unsigned short digger_list_of_model[CREATURE_TYPES_MAX];
     /** Total amount of rooms in possession of a player. Rooms which can never be built are not counted. */
     unsigned char total_rooms;
     unsigned short total_doors;
@@ -58,6 +58,7 @@ extern RotPers_Func rotpers_routines[];
 /******************************************************************************/
 void perspective_standard(struct XYZ *cor, struct PolyPoint *ppt);
 void perspective_fisheye(struct XYZ *cor, struct PolyPoint *ppt);
+void pers_set_transform_matrix(struct EngineCoord *epos, const struct M33 *matx);
 void rotpers_parallel(struct EngineCoord *epos, const struct M33 *matx);
 void rotpers_standard(struct EngineCoord *epos, const struct M33 *matx);
 void rotpers_circular(struct EngineCoord *epos, const struct M33 *matx);
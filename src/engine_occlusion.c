@@ -0,0 +1,268 @@
+/******************************************************************************/
+// Free implementation of Bullfrog's Dungeon Keeper strategy game.
+/******************************************************************************/
+/** @file engine_occlusion.c
+ *     Coarse occlusion buffer for skipping hidden geometry in perspective views.
+ * @par Purpose:
+ *     Stores, for screen split into cells, the depth behind which everything
+ *     is hidden by opaque walls. Column cubes and sprites whose screen bounds
+ *     fall entirely into cells with nearer occluders can be skipped.
+ * @par Comment:
+ *     Occluders are convex view space polygons, rasterized conservatively:
+ *     a cell is marked only if it lies completely inside the polygon, and it
+ *     receives the farthest depth of the polygon within the cell.
+ *     Works for pinhole projections only, where straight lines stay straight.
+ * @author   KeeperFX Team
+ * @date     19 Oct 2026 - 19 Oct 2026
+ * @par  Copying and copyrights:
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ */
+/******************************************************************************/
+#include "pre_inc.h"
+#include "engine_occlusion.h"
+
+#include <limits.h>
+#include <string.h>
+#include "globals.h"
+#include "bflib_basics.h"
+#include "engine_lenses.h"
+#include "post_inc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************/
+/** Max vertices of a quad after clipping by near plane. */
+#define OCCLUDER_MAX_VERTICES 5
+
+struct OccluderPoint {
+    float x;
+    float y;
+    float w; // Inverse of view space depth
+};
+
+TbBool occlusion_culling_enabled = true;
+struct OcclusionStats occlusion_stats;
+
+static TbBool occlusion_active;
+static struct OcclusionStats occlusion_frame_stats;
+static int32_t occlusion_depth[OCCLUSION_MAX_CELLS * OCCLUSION_MAX_CELLS];
+static long occlusion_cells_x;
+static long occlusion_cells_y;
+static long occlusion_cell_size;
+static long occlusion_proj_scale;
+static long occlusion_center_x;
+static long occlusion_center_y;
+// Corner rows used when rasterizing; corner count is one more than cell count
+static float occlusion_corner_w[2][OCCLUSION_MAX_CELLS + 1];
+static unsigned char occlusion_corner_in[2][OCCLUSION_MAX_CELLS + 1];
+/******************************************************************************/
+/**
+ * Prepares the buffer for a new frame.
+ * @param active Whether culling may be used for the frame at all.
+ * @param proj_scale Projection scale, so that screen x = center_x + x * proj_scale / z.
+ */
+void occlusion_begin_frame(TbBool active, long view_width, long view_height, long proj_scale, long center_x, long center_y)
+{
+    memset(&occlusion_frame_stats, 0, sizeof(occlusion_frame_stats));
+    occlusion_active = active && occlusion_culling_enabled && (view_width > 0) && (view_height > 0) && (proj_scale > 0);
+    if (!occlusion_active)
+        return;
+    long max_dim = max(view_width, view_height);
+    occlusion_cell_size = (max_dim + OCCLUSION_MAX_CELLS - 1) / OCCLUSION_MAX_CELLS;
+    if (occlusion_cell_size < OCCLUSION_MIN_CELL_SIZE)
+        occlusion_cell_size = OCCLUSION_MIN_CELL_SIZE;
+    occlusion_cells_x = (view_width + occlusion_cell_size - 1) / occlusion_cell_size;
+    occlusion_cells_y = (view_height + occlusion_cell_size - 1) / occlusion_cell_size;
+    occlusion_proj_scale = proj_scale;
+    occlusion_center_x = center_x;
+    occlusion_center_y = center_y;
+    long count = occlusion_cells_x * occlusion_cells_y;
+    for (long i = 0; i < count; i++)
+        occlusion_depth[i] = INT32_MAX;
+}
+
+/**
+ * Publishes counters of the frame, to be shown in debug overlay.
+ */
+void occlusion_end_frame(void)
+{
+    occlusion_stats = occlusion_frame_stats;
+    occlusion_active = false;
+}
+
+TbBool occlusion_is_active(void)
+{
+    return occlusion_active;
+}
+
+static int clip_occluder_near(const struct XYZ *vtx, int count, struct XYZ *out)
+{
+    int n = 0;
+    for (int i = 0; i < count; i++)
+    {
+        const struct XYZ *cur = &vtx[i];
+        const struct XYZ *nxt = &vtx[(i + 1) % count];
+        TbBool cur_in = (cur->z >= OCCLUSION_NEAR_Z);
+        TbBool nxt_in = (nxt->z >= OCCLUSION_NEAR_Z);
+        if (cur_in)
+            out[n++] = *cur;
+        if (cur_in != nxt_in)
+        {
+            // Edge crosses the near plane; add the intersection point
+            long long dz = nxt->z - cur->z;
+            long long t = OCCLUSION_NEAR_Z - cur->z;
+            out[n].x = cur->x + (long)((nxt->x - cur->x) * t / dz);
+            out[n].y = cur->y + (long)((nxt->y - cur->y) * t / dz);
+            out[n].z = OCCLUSION_NEAR_Z;
+            n++;
+        }
+    }
+    return n;
+}
+
+static inline float occluder_edge(const struct OccluderPoint *a, const struct OccluderPoint *b, float px, float py)
+{
+    return (b->x - a->x) * (py - a->y) - (b->y - a->y) * (px - a->x);
+}
+
+/**
+ * Adds an opaque planar quad, given in view space, to the occlusion buffer.
+ * Vertices must be in order around the quad.
+ */
+void occlusion_add_quad(const struct XYZ *vtx)
+{
+    if (!occlusion_active)
+        return;
+    struct XYZ clipped[OCCLUDER_MAX_VERTICES];
+    int count = clip_occluder_near(vtx, 4, clipped);
+    if (count < 3)
+        return;
+    struct OccluderPoint pts[OCCLUDER_MAX_VERTICES];
+    float min_x = 1e30f;
+    float max_x = -1e30f;
+    float min_y = 1e30f;
+    float max_y = -1e30f;
+    for (int i = 0; i < count; i++)
+    {
+        float z = (float)clipped[i].z;
+        pts[i].x = occlusion_center_x + (float)clipped[i].x * occlusion_proj_scale / z;
+        pts[i].y = occlusion_center_y - (float)clipped[i].y * occlusion_proj_scale / z;
+        pts[i].w = 1.0f / z;
+        min_x = min(min_x, pts[i].x);
+        max_x = max(max_x, pts[i].x);
+        min_y = min(min_y, pts[i].y);
+        max_y = max(max_y, pts[i].y);
+    }
+    // Inverse depth is linear in screen space for planar polygons; w = a*x + b*y + c
+    float area = occluder_edge(&pts[0], &pts[1], pts[2].x, pts[2].y);
+    if ((area > -1.0f) && (area < 1.0f))
+        return;
+    float plane_a = ((pts[1].w - pts[0].w) * (pts[2].y - pts[0].y) - (pts[2].w - pts[0].w) * (pts[1].y - pts[0].y)) / area;
+    float plane_b = ((pts[2].w - pts[0].w) * (pts[1].x - pts[0].x) - (pts[1].w - pts[0].w) * (pts[2].x - pts[0].x)) / area;
+    float plane_c = pts[0].w - plane_a * pts[0].x - plane_b * pts[0].y;
+    float orient = (area > 0) ? 1.0f : -1.0f;
+    // Range of cell corners within the polygon bounds
+    long size = occlusion_cell_size;
+    long c0 = (long)(min_x / size);
+    long c1 = (long)(max_x / size) + 1;
+    long r0 = (long)(min_y / size);
+    long r1 = (long)(max_y / size) + 1;
+    if (c0 < 0) c0 = 0;
+    if (r0 < 0) r0 = 0;
+    if (c1 > occlusion_cells_x) c1 = occlusion_cells_x;
+    if (r1 > occlusion_cells_y) r1 = occlusion_cells_y;
+    if ((c0 >= c1) || (r0 >= r1))
+        return;
+    occlusion_frame_stats.occluders++;
+    for (long r = r0; r <= r1; r++)
+    {
+        int row = r & 1;
+        float py = (float)(r * size);
+        for (long c = c0; c <= c1; c++)
+        {
+            float px = (float)(c * size);
+            unsigned char inside = 1;
+            for (int i = 0; (i < count) && inside; i++)
+            {
+                if (orient * occluder_edge(&pts[i], &pts[(i + 1) % count], px, py) < 0)
+                    inside = 0;
+            }
+            occlusion_corner_in[row][c] = inside;
+            occlusion_corner_w[row][c] = plane_a * px + plane_b * py + plane_c;
+        }
+        if (r == r0)
+            continue;
+        int prow = row ^ 1;
+        int32_t *depth = &occlusion_depth[(r - 1) * occlusion_cells_x];
+        for (long c = c0; c < c1; c++)
+        {
+            if (!(occlusion_corner_in[prow][c] && occlusion_corner_in[prow][c + 1] &&
+                  occlusion_corner_in[row][c] && occlusion_corner_in[row][c + 1]))
+                continue;
+            // Farthest point of the polygon within the cell is where w is smallest
+            float wmin = min(min(occlusion_corner_w[prow][c], occlusion_corner_w[prow][c + 1]),
+                             min(occlusion_corner_w[row][c], occlusion_corner_w[row][c + 1]));
+            if (wmin <= 0.0f)
+                continue;
+            float far_z = 1.0f / wmin + 1.0f;
+            if (far_z < (float)depth[c])
+                depth[c] = (int32_t)far_z;
+        }
+    }
+}
+
+/**
+ * Checks whether a screen rectangle with given nearest depth is hidden behind occluders.
+ * Parts of the rectangle outside of the screen are ignored; rectangles completely
+ * outside are reported as not hidden, leaving them to normal clipping.
+ */
+TbBool occlusion_rect_hidden(long min_x, long min_y, long max_x, long max_y, long min_depth)
+{
+    if (!occlusion_active)
+        return false;
+    long size = occlusion_cell_size;
+    if ((max_x < 0) || (max_y < 0) || (min_x > max_x) || (min_y > max_y))
+        return false;
+    long c0 = (min_x < 0) ? 0 : min_x / size;
+    long r0 = (min_y < 0) ? 0 : min_y / size;
+    long c1 = max_x / size;
+    long r1 = max_y / size;
+    if (c1 >= occlusion_cells_x) c1 = occlusion_cells_x - 1;
+    if (r1 >= occlusion_cells_y) r1 = occlusion_cells_y - 1;
+    if ((c0 > c1) || (r0 > r1))
+        return false;
+    for (long r = r0; r <= r1; r++)
+    {
+        const int32_t *depth = &occlusion_depth[r * occlusion_cells_x];
+        for (long c = c0; c <= c1; c++)
+        {
+            if (depth[c] >= min_depth)
+                return false;
+        }
+    }
+    return true;
+}
+
+void occlusion_count_column(TbBool culled)
+{
+    if (culled)
+        occlusion_frame_stats.columns_culled++;
+    else
+        occlusion_frame_stats.columns_drawn++;
+}
+
+void occlusion_count_sprite(TbBool culled)
+{
+    if (culled)
+        occlusion_frame_stats.sprites_culled++;
+    else
+        occlusion_frame_stats.sprites_drawn++;
+}
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,63 @@
+/******************************************************************************/
+// Free implementation of Bullfrog's Dungeon Keeper strategy game.
+/******************************************************************************/
+/** @file engine_occlusion.h
+ *     Header file for engine_occlusion.c.
+ * @par Purpose:
+ *     Coarse occlusion buffer for skipping hidden geometry in perspective views.
+ * @par Comment:
+ *     Just a header file - #defines, typedefs, function prototypes etc.
+ * @author   KeeperFX Team
+ * @date     19 Oct 2026 - 19 Oct 2026
+ * @par  Copying and copyrights:
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ */
+/******************************************************************************/
+#ifndef DK_ENGNOCCLUS_H
+#define DK_ENGNOCCLUS_H
+
+#include "bflib_basics.h"
+#include "globals.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************/
+/** Max amount of occlusion buffer cells in each dimension; cells grow on large screens. */
+#define OCCLUSION_MAX_CELLS 256
+/** Minimal size of occlusion buffer cell side, in screen units. */
+#define OCCLUSION_MIN_CELL_SIZE 8
+/** Occluder polygons are clipped at this view space depth. */
+#define OCCLUSION_NEAR_Z 64
+
+struct XYZ;
+
+/** Culling counters of one rendered frame. */
+struct OcclusionStats {
+    unsigned long columns_drawn;
+    unsigned long columns_culled;
+    unsigned long sprites_drawn;
+    unsigned long sprites_culled;
+    unsigned long occluders;
+};
+/******************************************************************************/
+/** User toggle; when false, occlusion buffer is never activated. */
+extern TbBool occlusion_culling_enabled;
+/** Counters of the last finished frame. */
+extern struct OcclusionStats occlusion_stats;
+/******************************************************************************/
+void occlusion_begin_frame(TbBool active, long view_width, long view_height, long proj_scale, long center_x, long center_y);
+void occlusion_end_frame(void);
+TbBool occlusion_is_active(void);
+void occlusion_add_quad(const struct XYZ *vtx);
+TbBool occlusion_rect_hidden(long min_x, long min_y, long max_x, long max_y, long min_depth);
+void occlusion_count_column(TbBool culled);
+void occlusion_count_sprite(TbBool culled);
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+#endif
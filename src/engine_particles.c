@@ -0,0 +1,478 @@
+/******************************************************************************/
+// Free implementation of Bullfrog's Dungeon Keeper strategy game.
+/******************************************************************************/
+/** @file engine_particles.c
+ *     Lightweight particles used instead of simple effect element things.
+ * @par Purpose:
+ *     Effect elements which only fly, fall and animate don't need to be things.
+ *     They are stored here in compact per-field arrays, don't use thing slots,
+ *     and are updated when a frame is drawn rather than within game turn.
+ * @par Comment:
+ *     Particles are not synchronized, like the effect elements they replace.
+ *     Updates are still done in steps of one game turn, with the same rules
+ *     as update_thing() and update_effect_element() use; for drawing, each
+ *     particle is copied into a temporary thing, so that the usual sprite
+ *     drawing and interpolation code can be used.
+ *     Only effect elements without lights, sub-effects, transformations,
+ *     impact effects, size changes and wind reactions qualify.
+ * @author   KeeperFX Team
+ * @date     19 Oct 2026 - 19 Oct 2026
+ * @par  Copying and copyrights:
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ */
+/******************************************************************************/
+#include "pre_inc.h"
+#include "engine_particles.h"
+
+#include <string.h>
+#include "globals.h"
+#include "bflib_basics.h"
+#include "config_effects.h"
+#include "creature_graphics.h"
+#include "engine_arrays.h"
+#include "game_legacy.h"
+#include "game_merge.h"
+#include "map_data.h"
+#include "map_utils.h"
+#include "thing_data.h"
+#include "thing_effects.h"
+#include "thing_objects.h"
+#include "thing_physics.h"
+#include "post_inc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************/
+/** Particles data, stored per field so that update loops go through continuous memory. */
+struct EffectParticles {
+    unsigned long count;
+    MapCoord pos_x[PARTICLES_COUNT];
+    MapCoord pos_y[PARTICLES_COUNT];
+    MapCoord pos_z[PARTICLES_COUNT];
+    // Position before last update step, for interpolation
+    MapCoord prev_x[PARTICLES_COUNT];
+    MapCoord prev_y[PARTICLES_COUNT];
+    MapCoord prev_z[PARTICLES_COUNT];
+    MapCoord floor_z[PARTICLES_COUNT];
+    MapCoordDelta vel_x[PARTICLES_COUNT];
+    MapCoordDelta vel_y[PARTICLES_COUNT];
+    MapCoordDelta vel_z[PARTICLES_COUNT];
+    // Gravity pull added to vertical velocity at next step
+    MapCoordDelta push_z[PARTICLES_COUNT];
+    int32_t anim_time[PARTICLES_COUNT];
+    GameTurn creation_turn[PARTICLES_COUNT];
+    short anim_speed[PARTICLES_COUNT];
+    short life[PARTICLES_COUNT];
+    short move_angle[PARTICLES_COUNT];
+    unsigned short anim_sprite[PARTICLES_COUNT];
+    unsigned short sprite_size[PARTICLES_COUNT];
+    unsigned short rendering_flags[PARTICLES_COUNT];
+    ThingModel model[PARTICLES_COUNT];
+    unsigned char max_frames[PARTICLES_COUNT];
+    unsigned char current_frame[PARTICLES_COUNT];
+    PlayerNumber owner[PARTICLES_COUNT];
+    // Per frame lists of particles on map blocks; block is only written when linking
+    unsigned long linked_count;
+    SubtlCodedCoords block[PARTICLES_COUNT];
+    ParticleIndex next_on_block[PARTICLES_COUNT];
+};
+
+TbBool effect_particles_enabled = true;
+
+static struct EffectParticles particles;
+/** Last game turn for which particles were updated. */
+static GameTurn particles_turn;
+static ParticleIndex particles_on_block[MAX_SUBTILES_X*MAX_SUBTILES_Y];
+/** Temporary things used to draw particles; one per particle, so that every particle can be drawn. */
+static struct Thing particle_render_things[PARTICLES_COUNT];
+/******************************************************************************/
+/**
+ * Returns whether effect elements of given model may be created as particles.
+ * These are elements which don't affect anything besides their own look.
+ */
+TbBool effect_element_is_particle(ThingModel eelmodel)
+{
+    if (!effect_particles_enabled)
+        return false;
+    if ((eelmodel <= 0) || (eelmodel >= EFFECTSELLEMENTS_TYPES_MAX))
+        return false;
+    const struct EffectElementConfigStats* eestat = get_effect_element_model_stats(eelmodel);
+    if ((eestat->sprite_idx == -1) || (eestat->draw_class != ODC_Default))
+        return false;
+    if ((eestat->light_radius != 0) || (eestat->subeffect_delay != 0) || (eestat->transform_model != 0))
+        return false;
+    if (eestat->impacts || eestat->affected_by_wind || (eestat->unanimated == 1))
+        return false;
+    if (eestat->size_change != TSC_DontChangeSize)
+        return false;
+    switch (eestat->move_type)
+    {
+    case 1:
+    case 3:
+    case 5:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static void remove_effect_particle(unsigned long n)
+{
+    unsigned long last = particles.count - 1;
+    if (n != last)
+    {
+        particles.pos_x[n] = particles.pos_x[last];
+        particles.pos_y[n] = particles.pos_y[last];
+        particles.pos_z[n] = particles.pos_z[last];
+        particles.prev_x[n] = particles.prev_x[last];
+        particles.prev_y[n] = particles.prev_y[last];
+        particles.prev_z[n] = particles.prev_z[last];
+        particles.floor_z[n] = particles.floor_z[last];
+        particles.vel_x[n] = particles.vel_x[last];
+        particles.vel_y[n] = particles.vel_y[last];
+        particles.vel_z[n] = particles.vel_z[last];
+        particles.push_z[n] = particles.push_z[last];
+        particles.anim_time[n] = particles.anim_time[last];
+        particles.creation_turn[n] = particles.creation_turn[last];
+        particles.anim_speed[n] = particles.anim_speed[last];
+        particles.life[n] = particles.life[last];
+        particles.move_angle[n] = particles.move_angle[last];
+        particles.anim_sprite[n] = particles.anim_sprite[last];
+        particles.sprite_size[n] = particles.sprite_size[last];
+        particles.rendering_flags[n] = particles.rendering_flags[last];
+        particles.model[n] = particles.model[last];
+        particles.max_frames[n] = particles.max_frames[last];
+        particles.current_frame[n] = particles.current_frame[last];
+        particles.owner[n] = particles.owner[last];
+    }
+    particles.count = last;
+}
+
+static MapCoord get_particle_floor_height(MapCoord pos_x, MapCoord pos_y, MapCoord pos_z)
+{
+    MapSubtlCoord floor_height;
+    MapSubtlCoord ceiling_height;
+    MapSubtlCoord stl_x = coord_subtile(pos_x);
+    MapSubtlCoord stl_y = coord_subtile(pos_y);
+    get_min_floor_and_ceiling_heights_for_rect(stl_x, stl_y, stl_x, stl_y, &floor_height, &ceiling_height);
+    // Same as get_thing_height_at() for a thing of size 1
+    if (subtile_coord(floor_height, 0) + 1 >= subtile_coord(ceiling_height, 0))
+        return pos_z;
+    return subtile_coord(floor_height, 0);
+}
+
+/**
+ * Creates a particle looking like effect element of given model.
+ * Caller is responsible for checking whether the particle is close enough to be seen.
+ * @return Index of the new particle, or 0 if none was created.
+ */
+ParticleIndex create_effect_particle(const struct Coord3d *pos, ThingModel eelmodel, PlayerNumber owner)
+{
+    if (particles.count >= PARTICLES_COUNT)
+        return 0;
+    const struct EffectElementConfigStats* eestat = get_effect_element_model_stats(eelmodel);
+    unsigned long n = particles.count;
+    particles.count++;
+    particles.pos_x[n] = pos->x.val;
+    particles.pos_y[n] = pos->y.val;
+    particles.pos_z[n] = pos->z.val;
+    particles.prev_x[n] = pos->x.val;
+    particles.prev_y[n] = pos->y.val;
+    particles.prev_z[n] = pos->z.val;
+    particles.floor_z[n] = get_particle_floor_height(pos->x.val, pos->y.val, pos->z.val);
+    particles.vel_x[n] = 0;
+    particles.vel_y[n] = 0;
+    particles.vel_z[n] = 0;
+    particles.push_z[n] = 0;
+    particles.creation_turn[n] = get_gameturn();
+    particles.move_angle[n] = 0;
+    particles.model[n] = eelmodel;
+    particles.owner[n] = owner;
+    // Random values are taken in the same order as in create_effect_element()
+    long size = eestat->sprite_size_min + UNSYNC_RANDOM(eestat->sprite_size_max - (int)eestat->sprite_size_min + 1);
+    long speed = eestat->sprite_speed_min + UNSYNC_RANDOM(eestat->sprite_speed_max - (int)eestat->sprite_speed_min + 1);
+    particles.anim_sprite[n] = get_td_animation_sprite(eestat->sprite_idx);
+    particles.max_frames[n] = keepersprite_frames(particles.anim_sprite[n]);
+    particles.anim_speed[n] = speed;
+    particles.anim_time[n] = 0;
+    particles.current_frame[n] = 0;
+    particles.sprite_size[n] = size;
+    unsigned short rflags = 0;
+    set_flag_value(rflags, TRF_Unshaded, eestat->unshaded);
+    rflags |= (TRF_Transpar_8 * eestat->transparent) & TRF_Transpar_Flags;
+    set_flag_value(rflags, TRF_AnimateOnce, eestat->animate_once);
+    particles.rendering_flags[n] = rflags;
+    if (eestat->lifespan > 0)
+    {
+        particles.life[n] = eestat->lifespan + UNSYNC_RANDOM(eestat->lifespan_random - (long)eestat->lifespan + 1);
+    } else
+    if (speed > 0)
+    {
+        particles.life[n] = get_lifespan_of_animation(particles.anim_sprite[n], speed);
+    } else
+    {
+        particles.life[n] = particles.max_frames[n];
+    }
+    return n + 1;
+}
+
+/**
+ * Sets initial velocity of a new particle, like push velocity of effect element.
+ */
+void set_effect_particle_velocity(ParticleIndex part_idx, MapCoordDelta vel_x, MapCoordDelta vel_y, MapCoordDelta vel_z, short move_angle)
+{
+    if ((part_idx < 1) || (part_idx > particles.count))
+        return;
+    unsigned long n = part_idx - 1;
+    // Push is added to base velocity before first move, so it can be set directly
+    particles.vel_x[n] += vel_x;
+    particles.vel_y[n] += vel_y;
+    particles.vel_z[n] += vel_z;
+    particles.move_angle[n] = move_angle;
+}
+
+void set_effect_particle_angle(ParticleIndex part_idx, short move_angle)
+{
+    if ((part_idx < 1) || (part_idx > particles.count))
+        return;
+    particles.move_angle[part_idx - 1] = move_angle;
+}
+
+/**
+ * Clears map block lists made for the previous frame.
+ * Blocks of all particles linked then are still stored, even if the particles were removed since.
+ */
+static void unlink_effect_particles(void)
+{
+    for (unsigned long n = 0; n < particles.linked_count; n++)
+    {
+        particles_on_block[particles.block[n]] = 0;
+    }
+    particles.linked_count = 0;
+}
+
+void clear_effect_particles(void)
+{
+    unlink_effect_particles();
+    particles.count = 0;
+    particles_turn = get_gameturn();
+}
+
+unsigned long count_effect_particles(void)
+{
+    return particles.count;
+}
+
+static void move_effect_particle(unsigned long n, const struct EffectElementConfigStats *eestat,
+    MapCoordDelta vel_x, MapCoordDelta vel_y, MapCoordDelta vel_z)
+{
+    struct Coord3d curpos;
+    curpos.x.val = particles.pos_x[n];
+    curpos.y.val = particles.pos_y[n];
+    curpos.z.val = particles.pos_z[n];
+    struct CoordDelta3d velocity;
+    velocity.x.val = vel_x;
+    velocity.y.val = vel_y;
+    velocity.z.val = vel_z;
+    struct Coord3d pos;
+    TbBool within_map_limits = set_coords_add_velocity(&pos, &curpos, &velocity, MapCoord_ClipX|MapCoord_ClipY|MapCoord_ClipZ);
+    if ((pos.x.val == curpos.x.val) && (pos.y.val == curpos.y.val) && (pos.z.val == curpos.z.val))
+        return;
+    if (!eestat->through_walls)
+    {
+        if ((!within_map_limits) ||
+            (map_is_solid_at_height(pos.x.stl.num, pos.y.stl.num, pos.z.val, pos.z.val + 1) &&
+             map_is_solid_at_height(curpos.x.stl.num, curpos.y.stl.num, curpos.z.val, curpos.z.val + 1)))
+        {
+            // Simplified sliding - the particle stops moving along any axis which leads into a wall
+            if (map_is_solid_at_height(pos.x.stl.num, curpos.y.stl.num, curpos.z.val, curpos.z.val + 1)) {
+                pos.x.val = curpos.x.val;
+                particles.vel_x[n] = 0;
+            }
+            if (map_is_solid_at_height(curpos.x.stl.num, pos.y.stl.num, curpos.z.val, curpos.z.val + 1)) {
+                pos.y.val = curpos.y.val;
+                particles.vel_y[n] = 0;
+            }
+        }
+    }
+    particles.move_angle[n] = get_angle_xy_to(&curpos, &pos);
+    particles.pos_x[n] = pos.x.val;
+    particles.pos_y[n] = pos.y.val;
+    particles.pos_z[n] = pos.z.val;
+    particles.floor_z[n] = get_particle_floor_height(pos.x.val, pos.y.val, pos.z.val);
+}
+
+/**
+ * Updates all particles by one game turn.
+ * Follows update_thing() and update_effect_element() for things which qualify as particles.
+ */
+static void step_effect_particles(GameTurn turn)
+{
+    // Position before the step is kept for interpolation
+    memcpy(particles.prev_x, particles.pos_x, particles.count * sizeof(MapCoord));
+    memcpy(particles.prev_y, particles.pos_y, particles.count * sizeof(MapCoord));
+    memcpy(particles.prev_z, particles.pos_z, particles.count * sizeof(MapCoord));
+    for (unsigned long n = 0; n < particles.count; n++)
+    {
+        particles.vel_z[n] += particles.push_z[n];
+        particles.push_z[n] = 0;
+    }
+    unsigned long n = 0;
+    while (n < particles.count)
+    {
+        // Particles created during the turn are updated starting from the next one, like things
+        if (particles.creation_turn[n] >= turn) {
+            n++;
+            continue;
+        }
+        if (particles.life[n] <= 0)
+        {
+            remove_effect_particle(n);
+            continue;
+        }
+        particles.life[n]--;
+        const struct EffectElementConfigStats* eestat = get_effect_element_model_stats(particles.model[n]);
+        if (!eestat->animate_on_floor && (particles.floor_z[n] >= particles.pos_z[n]))
+            particles.anim_speed[n] = 0;
+        // Velocity is taken before the element changes it, as in update_thing()
+        MapCoordDelta vel_x = particles.vel_x[n];
+        MapCoordDelta vel_y = particles.vel_y[n];
+        MapCoordDelta vel_z = particles.vel_z[n];
+        switch (eestat->move_type)
+        {
+        case 1:
+            move_effect_particle(n, eestat, vel_x, vel_y, vel_z);
+            break;
+        case 3:
+            particles.vel_z[n] = 32;
+            move_effect_particle(n, eestat, vel_x, vel_y, vel_z);
+            break;
+        default:
+            break;
+        }
+        if (particles.pos_z[n] > particles.floor_z[n])
+        {
+            particles.vel_x[n] = particles.vel_x[n] * (256 - eestat->inertia_air) / 256;
+            particles.vel_y[n] = particles.vel_y[n] * (256 - eestat->inertia_air) / 256;
+            particles.push_z[n] -= eestat->fall_acceleration;
+        } else
+        {
+            particles.vel_x[n] = particles.vel_x[n] * (256 - eestat->inertia_floor) / 256;
+            particles.vel_y[n] = particles.vel_y[n] * (256 - eestat->inertia_floor) / 256;
+            particles.pos_z[n] = particles.floor_z[n];
+            particles.vel_z[n] = 0;
+        }
+        n++;
+    }
+    // Animation, same as for things
+    for (n = 0; n < particles.count; n++)
+    {
+        if ((particles.anim_speed[n] == 0) || (particles.max_frames[n] == 0))
+            continue;
+        int32_t anim_len = (particles.max_frames[n] << 8);
+        particles.anim_time[n] += particles.anim_speed[n];
+        while (particles.anim_time[n] < 0)
+            particles.anim_time[n] += anim_len;
+        if (particles.anim_time[n] > anim_len - 1)
+        {
+            if ((particles.rendering_flags[n] & TRF_AnimateOnce) != 0)
+            {
+                particles.anim_speed[n] = 0;
+                particles.anim_time[n] = anim_len - 1;
+            } else
+            {
+                particles.anim_time[n] %= anim_len;
+            }
+        }
+        particles.current_frame[n] = particles.anim_time[n] >> 8;
+    }
+}
+
+/**
+ * Brings particles up to current game turn and prepares them to be drawn.
+ * Should be called once per drawn frame, before the map is drawn.
+ */
+void update_effect_particles_for_frame(void)
+{
+    unsigned long n;
+    unlink_effect_particles();
+    // Last turn which was already processed by update_things()
+    GameTurn last_turn = get_gameturn() - 1;
+    if ((last_turn < particles_turn) || (last_turn - particles_turn > PARTICLES_MAX_CATCHUP_TURNS))
+    {
+        // Game was loaded, or nothing was drawn for a long time
+        particles.count = 0;
+        particles_turn = last_turn;
+    }
+    while (particles_turn < last_turn)
+    {
+        particles_turn++;
+        step_effect_particles(particles_turn);
+    }
+    // Link particles into per map block lists; order of drawing within a block is not important
+    for (n = 0; n < particles.count; n++)
+    {
+        SubtlCodedCoords stl_num = get_subtile_number(coord_subtile(particles.pos_x[n]), coord_subtile(particles.pos_y[n]));
+        particles.block[n] = stl_num;
+        particles.next_on_block[n] = particles_on_block[stl_num];
+        particles_on_block[stl_num] = n + 1;
+    }
+    particles.linked_count = particles.count;
+}
+
+ParticleIndex get_first_particle_on_map_block(const struct Map *mapblk)
+{
+    return particles_on_block[mapblk - &game.map[0]];
+}
+
+ParticleIndex get_next_particle_on_map_block(ParticleIndex part_idx)
+{
+    return particles.next_on_block[part_idx - 1];
+}
+
+/**
+ * Fills a temporary thing which can be passed to sprite drawing routines.
+ * The thing is valid until next frame, and isn't a part of things array.
+ * @return The thing, or NULL if the particle index is invalid.
+ */
+struct Thing *get_particle_render_thing(ParticleIndex part_idx)
+{
+    if ((part_idx < 1) || (part_idx > particles.count))
+        return NULL;
+    unsigned long n = part_idx - 1;
+    struct Thing* thing = &particle_render_things[n];
+    memset(thing, 0, sizeof(struct Thing));
+    thing->class_id = TCls_EffectElem;
+    thing->model = particles.model[n];
+    thing->owner = particles.owner[n];
+    // Interpolation is left to interpolate_thing(), like for real things
+    thing->mappos.x.val = particles.pos_x[n];
+    thing->mappos.y.val = particles.pos_y[n];
+    thing->mappos.z.val = particles.pos_z[n];
+    thing->previous_mappos.x.val = particles.prev_x[n];
+    thing->previous_mappos.y.val = particles.prev_y[n];
+    thing->previous_mappos.z.val = particles.prev_z[n];
+    thing->floor_height = particles.floor_z[n];
+    thing->previous_floor_height = particles.floor_z[n];
+    thing->creation_turn = particles.creation_turn[n];
+    thing->draw_class = ODC_Default;
+    thing->anim_sprite = particles.anim_sprite[n];
+    thing->max_frames = particles.max_frames[n];
+    thing->anim_speed = particles.anim_speed[n];
+    thing->anim_time = particles.anim_time[n];
+    thing->current_frame = particles.current_frame[n];
+    thing->sprite_size = particles.sprite_size[n];
+    thing->rendering_flags = particles.rendering_flags[n];
+    thing->move_angle_xy = particles.move_angle[n];
+    thing->clipbox_size_xy = 1;
+    thing->clipbox_size_z = 1;
+    return thing;
+}
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
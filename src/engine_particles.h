@@ -0,0 +1,59 @@
+/******************************************************************************/
+// Free implementation of Bullfrog's Dungeon Keeper strategy game.
+/******************************************************************************/
+/** @file engine_particles.h
+ *     Header file for engine_particles.c.
+ * @par Purpose:
+ *     Lightweight particles used instead of simple effect element things.
+ * @par Comment:
+ *     Just a header file - #defines, typedefs, function prototypes etc.
+ * @author   KeeperFX Team
+ * @date     19 Oct 2026 - 19 Oct 2026
+ * @par  Copying and copyrights:
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ */
+/******************************************************************************/
+#ifndef DK_ENGNPARTCL_H
+#define DK_ENGNPARTCL_H
+
+#include "bflib_basics.h"
+#include "globals.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************/
+/** Max amount of particles existing at once. */
+#define PARTICLES_COUNT 4096
+/** If rendering was stopped for more turns than this, particles are dropped instead of updated. */
+#define PARTICLES_MAX_CATCHUP_TURNS 16
+
+/** Index of a particle increased by one; 0 is used as list terminator. */
+typedef unsigned short ParticleIndex;
+
+struct Thing;
+struct Map;
+struct Coord3d;
+/******************************************************************************/
+/** Whether effect elements are allowed to be created as particles. */
+extern TbBool effect_particles_enabled;
+/******************************************************************************/
+TbBool effect_element_is_particle(ThingModel eelmodel);
+ParticleIndex create_effect_particle(const struct Coord3d *pos, ThingModel eelmodel, PlayerNumber owner);
+void set_effect_particle_velocity(ParticleIndex part_idx, MapCoordDelta vel_x, MapCoordDelta vel_y, MapCoordDelta vel_z, short move_angle);
+void set_effect_particle_angle(ParticleIndex part_idx, short move_angle);
+void clear_effect_particles(void);
+unsigned long count_effect_particles(void);
+
+void update_effect_particles_for_frame(void);
+ParticleIndex get_first_particle_on_map_block(const struct Map *mapblk);
+ParticleIndex get_next_particle_on_map_block(ParticleIndex part_idx);
+struct Thing *get_particle_render_thing(ParticleIndex part_idx);
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -19,6 +19,7 @@
 #include "pre_inc.h"
 #include "kfx/renderer/RendererManager.h"
 #include <stddef.h>
+#include <limits.h>
 
 #include "engine_render.h"
 #include "globals.h"
@@ -47,6 +48,8 @@
 #include "engine_arrays.h"
 #include "engine_camera.h"
 #include "engine_lenses.h"
+#include "engine_occlusion.h"
+#include "engine_particles.h"
 #include "engine_redraw.h"
 #include "engine_textures.h"
 #include "local_camera.h"
@@ -318,6 +321,12 @@ struct BucketKindRoomFlag { // BasicQ type 17,19
 
 struct EngineCol {
     struct EngineCoord cors[16];
+    // Screen bounds and nearest depth of points filled for the current plane, for occlusion tests
+    long scr_min_x;
+    long scr_max_x;
+    long scr_min_y;
+    long scr_max_y;
+    long min_depth;
 };
 
 struct SideOri {
@@ -491,6 +500,7 @@ static const char splittypes[64] = {
 #endif
 /******************************************************************************/
 static void do_map_who(short tnglist_idx);
+static void do_map_who_particles(const struct Map *mapblk);
 static void (*render_sprite_debug_fn) (struct Thing*, long scrpos_x, long scrpos_y) = NULL;
 static int render_sprite_debug_level = 0;
 static void draw_keepsprite_unscaled_in_buffer(unsigned short kspr_n, short angle, unsigned char current_frame, unsigned char *outbuf);
@@ -974,6 +984,185 @@ static struct BasicQ *get_bucket_item(int min_cor_z, enum QKinds kind, size_t si
     return kspr;
 }
 
+/** Amount of subtiles around the camera, in each dimension, which have their transformed points cached. */
+#define VERTEX_CACHE_SPAN 64
+/** Cached points per subtile corner - one for each cube height, and the ceiling. */
+#define VERTEX_CACHE_SLOTS (COLUMN_STACK_HEIGHT + 2)
+#define VERTEX_CACHE_CEILING_SLOT (COLUMN_STACK_HEIGHT + 1)
+
+/** Everything besides the point coordinates which affects the result of rotpers(). */
+struct EngineVertexCacheKey {
+    struct M33 matrix;
+    long origin_x;
+    long origin_y;
+    long origin_z;
+    RotPers_Func rotpers;
+    long lens;
+    long view_width_over_2;
+    long view_height_over_2;
+    long window_width;
+    long window_height;
+    long fade_max;
+    long z_threshold_near;
+    long split_2;
+    long zoom;
+    long cells_away;
+};
+
+/** Point transformed by rotpers(), together with its coordinates before transformation. */
+struct CachedEngineCoord {
+    uint32_t generation;
+    int32_t src_x;
+    int32_t src_y;
+    int32_t src_z;
+    int32_t view_width;
+    int32_t view_height;
+    int32_t render_distance;
+    int32_t x;
+    int32_t y;
+    int32_t z;
+    unsigned short clip_flags;
+};
+
+static struct CachedEngineCoord engine_vertex_cache[VERTEX_CACHE_SPAN * VERTEX_CACHE_SPAN * VERTEX_CACHE_SLOTS];
+static struct EngineVertexCacheKey engine_vertex_cache_key;
+static uint32_t engine_vertex_cache_generation;
+static MapSubtlCoord engine_vertex_cache_stl_x;
+static MapSubtlCoord engine_vertex_cache_stl_y;
+
+/**
+ * Prepares the transformed points cache for drawing a perspective frame.
+ * Cached points stay valid as long as the camera orientation and projection don't change.
+ * Points are indexed relative to the camera subtile and store their input coordinates,
+ * so moving the camera by whole subtiles keeps the points which still get the same input.
+ */
+static void engine_vertex_cache_begin_frame(void)
+{
+    struct EngineVertexCacheKey key;
+    memset(&key, 0, sizeof(key));
+    key.matrix = camera_matrix;
+    key.origin_x = object_origin.x;
+    key.origin_y = object_origin.y;
+    key.origin_z = object_origin.z;
+    key.rotpers = rotpers;
+    key.lens = lens;
+    key.view_width_over_2 = view_width_over_2;
+    key.view_height_over_2 = view_height_over_2;
+    key.window_width = vec_window_width;
+    key.window_height = vec_window_height;
+    key.fade_max = fade_max;
+    key.z_threshold_near = z_threshold_near;
+    key.split_2 = split_2;
+    key.zoom = camera_zoom / pixel_size;
+    key.cells_away = cells_away;
+    if ((engine_vertex_cache_generation == 0) || (memcmp(&key, &engine_vertex_cache_key, sizeof(key)) != 0))
+    {
+        engine_vertex_cache_key = key;
+        engine_vertex_cache_generation++;
+        if (engine_vertex_cache_generation == 0)
+        {
+            // Counter wrapped; make sure no old entry matches the new generation
+            memset(engine_vertex_cache, 0, sizeof(engine_vertex_cache));
+            engine_vertex_cache_generation = 1;
+        }
+    }
+    engine_vertex_cache_stl_x = coord_subtile(map_x_pos);
+    engine_vertex_cache_stl_y = coord_subtile(map_y_pos);
+}
+
+/**
+ * Transforms given point like rotpers(), reusing the result from previous frames if possible.
+ * The point must have clip flags cleared, as the cached flags replace them.
+ * @param stl_x,stl_y Subtile which the point belongs to.
+ * @param slot Index of the point within the subtile corner.
+ */
+static void rotpers_cached(struct EngineCoord *epos, MapSubtlCoord stl_x, MapSubtlCoord stl_y, int slot)
+{
+    long cell_x = stl_x - engine_vertex_cache_stl_x + VERTEX_CACHE_SPAN / 2;
+    long cell_y = stl_y - engine_vertex_cache_stl_y + VERTEX_CACHE_SPAN / 2;
+    if ((cell_x < 0) || (cell_x >= VERTEX_CACHE_SPAN) || (cell_y < 0) || (cell_y >= VERTEX_CACHE_SPAN))
+    {
+        rotpers(epos, &camera_matrix);
+        return;
+    }
+    struct CachedEngineCoord *cached = &engine_vertex_cache[(cell_y * VERTEX_CACHE_SPAN + cell_x) * VERTEX_CACHE_SLOTS + slot];
+    if ((cached->generation == engine_vertex_cache_generation) && (cached->src_x == epos->x)
+      && (cached->src_y == epos->y) && (cached->src_z == epos->z))
+    {
+        epos->view_width = cached->view_width;
+        epos->view_height = cached->view_height;
+        epos->render_distance = cached->render_distance;
+        epos->clip_flags = cached->clip_flags;
+        epos->x = cached->x;
+        epos->y = cached->y;
+        epos->z = cached->z;
+        return;
+    }
+    cached->generation = engine_vertex_cache_generation;
+    cached->src_x = epos->x;
+    cached->src_y = epos->y;
+    cached->src_z = epos->z;
+    rotpers(epos, &camera_matrix);
+    cached->view_width = epos->view_width;
+    cached->view_height = epos->view_height;
+    cached->render_distance = epos->render_distance;
+    cached->clip_flags = epos->clip_flags;
+    cached->x = epos->x;
+    cached->y = epos->y;
+    cached->z = epos->z;
+}
+
+/**
+ * Stores screen bounds of column points filled for the current plane - cubes hmin..hmax and the ceiling.
+ * Points too near to the camera make the bounds unusable, which is marked by negative depth.
+ */
+static void update_engine_col_bounds(struct EngineCol *ecol, long hmin, long hmax)
+{
+    ecol->scr_min_x = LONG_MAX;
+    ecol->scr_max_x = LONG_MIN;
+    ecol->scr_min_y = LONG_MAX;
+    ecol->scr_max_y = LONG_MIN;
+    ecol->min_depth = LONG_MAX;
+    for (long h = hmin; h <= hmax + 1; h++)
+    {
+        struct EngineCoord *ecord;
+        ecord = (h > hmax) ? &ecol->cors[8] : &ecol->cors[h];
+        if ((ecord->clip_flags & 0x0100) != 0) {
+            ecol->min_depth = -1;
+            return;
+        }
+        ecol->scr_min_x = min(ecol->scr_min_x, ecord->view_width);
+        ecol->scr_max_x = max(ecol->scr_max_x, ecord->view_width);
+        ecol->scr_min_y = min(ecol->scr_min_y, ecord->view_height);
+        ecol->scr_max_y = max(ecol->scr_max_y, ecord->view_height);
+        ecol->min_depth = min(ecol->min_depth, ecord->z);
+    }
+}
+
+/**
+ * Checks whether column cube between given engine columns is hidden behind occluders.
+ */
+static TbBool engine_column_occluded(const struct EngineCol *bec, const struct EngineCol *fec)
+{
+    const struct EngineCol *cols[4] = {&bec[0], &bec[1], &fec[0], &fec[1]};
+    long scr_min_x = LONG_MAX;
+    long scr_max_x = LONG_MIN;
+    long scr_min_y = LONG_MAX;
+    long scr_max_y = LONG_MIN;
+    long min_depth = LONG_MAX;
+    for (int i = 0; i < 4; i++)
+    {
+        if (cols[i]->min_depth < 0)
+            return false;
+        scr_min_x = min(scr_min_x, cols[i]->scr_min_x);
+        scr_max_x = max(scr_max_x, cols[i]->scr_max_x);
+        scr_min_y = min(scr_min_y, cols[i]->scr_min_y);
+        scr_max_y = max(scr_max_y, cols[i]->scr_max_y);
+        min_depth = min(min_depth, cols[i]->min_depth);
+    }
+    return occlusion_rect_hidden(scr_min_x, scr_min_y, scr_max_x, scr_max_y, min_depth);
+}
+
 static void fill_in_points_perspective(struct Camera *cam, long bstl_x, long bstl_y, struct MinMax *mm)
 {
     if ((bstl_y < 0) || (bstl_y > game.map_subtiles_y-1)) {
@@ -1085,7 +1274,7 @@ static void fill_in_points_perspective(struct Camera *cam, long bstl_x, long bst
             ecord->shade_intensity = lightness;
             wibl += 2;
             hpos += COORD_PER_STL;
-            rotpers(ecord, &camera_matrix);
+            rotpers_cached(ecord, stl_x, stl_y, ecord - ecol->cors);
             ecord++;
         }
         wibl -= 2;
@@ -1105,7 +1294,11 @@ static void fill_in_points_perspective(struct Camera *cam, long bstl_x, long bst
             ecord->clip_flags = 0;
             // Use lightness from last cube
             ecord->shade_intensity = lightness;
-            rotpers(ecord, &camera_matrix);
+            rotpers_cached(ecord, stl_x, stl_y, VERTEX_CACHE_CEILING_SLOT);
+        }
+        if (occlusion_is_active())
+        {
+            update_engine_col_bounds(ecol, hmin, hmax);
         }
         stl_x++;
         ecol++;
@@ -3802,62 +3995,46 @@ static void do_a_trig_gourad_bl(struct EngineCoord *engine_coordinate_1, struct
 static TbBool add_light_to_nearest_list(struct NearestLights* nlgt, int32_t * nlgt_dist, const struct Light* lgt, long dist)
 {
     int i;
-    for (i = settings.video_shadows-1; i > 0; i--)
+    for (i = settings.video_shadows-1; (i > 0) && (nlgt_dist[i-1] > dist); i--)
     {
         nlgt_dist[i] = nlgt_dist[i-1];
         nlgt->coord[i] = nlgt->coord[i-1];
     }
-    nlgt_dist[0] = dist;
-    nlgt->coord[0] = lgt->mappos;
+    nlgt_dist[i] = dist;
+    nlgt->coord[i] = lgt->mappos;
     return true;
 }
 
-static void find_closest_lights_on_list(struct NearestLights *nlgt, int32_t *nlgt_dist, const struct Coord3d *pos, ThingIndex list_start_idx)
+static long find_closest_lights(const struct Coord3d* pos, struct NearestLights* nlgt)
 {
+    long count;
+    int32_t nlgt_dist[SHADOW_SOURCES_MAX_COUNT];
     long i;
-    unsigned long k;
+    for (i = 0; i < SHADOW_SOURCES_MAX_COUNT; i++) {
+        nlgt_dist[i] = INT32_MAX;
+    }
     if (settings.video_shadows < 1)
-        return;
-    i = list_start_idx;
-    k = 0;
-    while (i > 0)
-    {
-        struct Light *lgt;
-        lgt = &game.lish.lights[i];
-        i = lgt->next_in_list;
-        // Per-light code
-        if ((lgt->flags & LgtF_Allocated) != 0)
+        return 0;
+    // Only lights closer than this cast shadows, so neighbouring light grid cells are enough
+    const MapCoordDelta max_dist = 2560;
+    struct LightGridIterator iter;
+    light_grid_iterate_start(&iter, coord_subtile(pos->x.val - max_dist), coord_subtile(pos->y.val - max_dist),
+        coord_subtile(pos->x.val + max_dist), coord_subtile(pos->y.val + max_dist));
+    struct Light *lgt;
+    while ((lgt = light_grid_iterate_next(&iter)) != NULL)
+    {
+        // Lights turned off stay in the grid, but not on the lights lists
+        if ((lgt->flags & (LgtF_Allocated|LgtF_CanTurnOff)) == (LgtF_Allocated|LgtF_CanTurnOff))
         {
             long dist;
             dist = get_chessboard_distance(pos, &lgt->mappos);
-            if ((dist < 2560) && (nlgt_dist[settings.video_shadows-1] > dist)
+            if ((dist < max_dist) && (nlgt_dist[settings.video_shadows-1] > dist)
                 && (pos->x.val != lgt->mappos.x.val) && (pos->y.val != lgt->mappos.y.val))
             {
                 add_light_to_nearest_list(nlgt, nlgt_dist, lgt, dist);
             }
         }
-        // Per-light code ends
-        k++;
-        if (k > LIGHTS_COUNT)
-        {
-            ERRORLOG("Infinite loop detected when sweeping lights list");
-            break;
-        }
-    }
-}
-
-static long find_closest_lights(const struct Coord3d* pos, struct NearestLights* nlgt)
-{
-    long count;
-    int32_t nlgt_dist[SHADOW_SOURCES_MAX_COUNT];
-    long i;
-    for (i = 0; i < SHADOW_SOURCES_MAX_COUNT; i++) {
-        nlgt_dist[i] = INT32_MAX;
     }
-    i = game.thing_lists[TngList_StaticLights].index;
-    find_closest_lights_on_list(nlgt, nlgt_dist, pos, i);
-    i = game.thing_lists[TngList_DynamLights].index;
-    find_closest_lights_on_list(nlgt, nlgt_dist, pos, i);
     count = 0;
     for (i = 0; i < SHADOW_SOURCES_MAX_COUNT; i++) {
         if (nlgt_dist[i] == INT32_MAX)
@@ -4084,8 +4261,22 @@ static void do_a_plane_of_engine_columns_perspective(long stl_x, long stl_y, lon
             n = get_mapwho_thing_index(mapblk);
             if (n != 0)
                 do_map_who(n);
+            do_map_who_particles(mapblk);
             colmn = get_map_column(mapblk);
         }
+        // Skip cubes hidden behind walls; things were checked separately
+        if (occlusion_is_active())
+        {
+            TbBool culled = engine_column_occluded(bec, fec);
+            occlusion_count_column(culled);
+            if (culled)
+            {
+                bec++;
+                fec++;
+                center_block_idx++;
+                continue;
+            }
+        }
         // Retrieve solidmasks for surrounding area
         unsigned short solidmsk_center;
         unsigned short solidmsk_top;
@@ -4474,6 +4665,7 @@ static void do_a_plane_of_engine_columns_cluedo(long stl_x, long stl_y, long pla
             if (i > 0) {
               do_map_who(i);
             }
+            do_map_who_particles(cur_mapblk);
             cur_colmn = get_map_column(cur_mapblk);
             solidmsk_cur_raw = cur_colmn->solidmask;
             solidmsk_cur = solidmsk_cur_raw;
@@ -4670,6 +4862,7 @@ static void do_a_plane_of_engine_columns_isometric(long stl_x, long stl_y, long
             if (i > 0) {
               do_map_who(i);
             }
+            do_map_who_particles(cur_mapblk);
             cur_colmn = get_map_column(cur_mapblk);
         }
         // Get solidmasks of sibling columns
@@ -6823,6 +7016,153 @@ static void draw_plane_of_engine_columns(struct Camera *cam, long aposc, long bp
     }
 }
 
+/** Minimal amount of solid cubes, counting from floor, for a column to hide things behind it. */
+#define OCCLUDER_MIN_HEIGHT 3
+/** Distance by which occluders are moved into walls; larger than any wibble offset. */
+#define OCCLUDER_INSET 64
+
+static unsigned char occluder_heights[MINMAX_LENGTH][MINMAX_LENGTH];
+
+/**
+ * Returns height of the opaque part of column at given subtile, or 0 if it's too low to occlude.
+ * Doors and rooms are skipped, as they may contain see-through cubes.
+ */
+static unsigned char get_column_occluder_height(MapSubtlCoord stl_x, MapSubtlCoord stl_y, const struct Column *blank_colmn)
+{
+    struct Map *mapblk = get_map_block_at(stl_x, stl_y);
+    const struct Column *colmn = blank_colmn;
+    if (map_block_revealed(mapblk, my_player_number))
+    {
+        if ((mapblk->flags & (SlbAtFlg_IsDoor|SlbAtFlg_IsRoom)) != 0)
+            return 0;
+        colmn = get_map_column(mapblk);
+    }
+    unsigned short mask = colmn->solidmask;
+    unsigned char height = 0;
+    while ((mask & 1) != 0)
+    {
+        height++;
+        mask >>= 1;
+    }
+    return (height >= OCCLUDER_MIN_HEIGHT) ? height : 0;
+}
+
+/**
+ * Adds vertical wall rectangle between given map positions to the occlusion buffer.
+ */
+static void add_occluder_quad(long pos_x1, long pos_y1, long pos_x2, long pos_y2, long height)
+{
+    long pos_x[4] = {pos_x1, pos_x2, pos_x2, pos_x1};
+    long pos_y[4] = {pos_y1, pos_y2, pos_y2, pos_y1};
+    long pos_z[4] = {OCCLUDER_INSET, OCCLUDER_INSET, height - OCCLUDER_INSET, height - OCCLUDER_INSET};
+    struct XYZ vtx[4];
+    for (int i = 0; i < 4; i++)
+    {
+        struct EngineCoord ecor;
+        ecor.x = pos_x[i] - map_x_pos;
+        ecor.y = pos_z[i] - view_alt;
+        ecor.z = map_y_pos - pos_y[i];
+        pers_set_transform_matrix(&ecor, &camera_matrix);
+        vtx[i].x = ecor.x;
+        vtx[i].y = ecor.y;
+        vtx[i].z = ecor.z;
+    }
+    occlusion_add_quad(vtx);
+}
+
+/**
+ * Fills occlusion buffer with walls from the area which will be drawn by draw_view_map_plane().
+ * Runs of solid columns of equal height are merged into single occluder faces, placed
+ * inside the columns on the camera side.
+ */
+static void add_map_occluders(long xcell, long ycell)
+{
+    const struct Column *blank_colmn = get_column(game.unrevealed_column_idx);
+    long first = MINMAX_ALMOST_HALF - cells_away;
+    if (first < 0)
+        first = 0;
+    long planes = 2 * cells_away - 1;
+    if (first + planes >= MINMAX_LENGTH)
+        planes = MINMAX_LENGTH - first - 1;
+    if (planes <= 0)
+        return;
+    long cidx_min = MINMAX_LENGTH;
+    long cidx_max = 0;
+    // Faces perpendicular to Y axis, made of runs within one plane
+    for (long k = 1; k <= planes; k++)
+    {
+        unsigned char *heights = occluder_heights[k];
+        memset(heights, 0, MINMAX_LENGTH);
+        MapSubtlCoord stl_y = ycell + k;
+        if ((stl_y <= 0) || (stl_y >= game.map_subtiles_y))
+            continue;
+        struct MinMax *mm = &minmaxs[first + k];
+        long stl_x_beg = max(xcell + mm->min, 1);
+        long stl_x_end = min(xcell + mm->max, game.map_subtiles_x);
+        stl_x_beg = max(stl_x_beg, xcell - MINMAX_ALMOST_HALF);
+        stl_x_end = min(stl_x_end, xcell + MINMAX_LENGTH - MINMAX_ALMOST_HALF);
+        if (stl_x_beg >= stl_x_end)
+            continue;
+        cidx_min = min(cidx_min, stl_x_beg - xcell + MINMAX_ALMOST_HALF);
+        cidx_max = max(cidx_max, stl_x_end - xcell + MINMAX_ALMOST_HALF);
+        for (long stl_x = stl_x_beg; stl_x < stl_x_end; stl_x++)
+        {
+            heights[stl_x - xcell + MINMAX_ALMOST_HALF] = get_column_occluder_height(stl_x, stl_y, blank_colmn);
+        }
+        long face_y;
+        if (map_y_pos >= subtile_coord(stl_y + 1, 0)) {
+            face_y = subtile_coord(stl_y + 1, 0) - OCCLUDER_INSET;
+        } else
+        if (map_y_pos < subtile_coord(stl_y, 0)) {
+            face_y = subtile_coord(stl_y, 0) + OCCLUDER_INSET;
+        } else {
+            continue;
+        }
+        long stl_x = stl_x_beg;
+        while (stl_x < stl_x_end)
+        {
+            unsigned char height = heights[stl_x - xcell + MINMAX_ALMOST_HALF];
+            long run_end = stl_x + 1;
+            while ((run_end < stl_x_end) && (heights[run_end - xcell + MINMAX_ALMOST_HALF] == height))
+                run_end++;
+            if (height > 0)
+            {
+                add_occluder_quad(subtile_coord(stl_x, 0) + OCCLUDER_INSET, face_y,
+                    subtile_coord(run_end, 0) - OCCLUDER_INSET, face_y, subtile_coord(height, 0));
+            }
+            stl_x = run_end;
+        }
+    }
+    // Faces perpendicular to X axis, made of runs across planes
+    for (long cidx = cidx_min; cidx < cidx_max; cidx++)
+    {
+        MapSubtlCoord stl_x = xcell + cidx - MINMAX_ALMOST_HALF;
+        long face_x;
+        if (map_x_pos >= subtile_coord(stl_x + 1, 0)) {
+            face_x = subtile_coord(stl_x + 1, 0) - OCCLUDER_INSET;
+        } else
+        if (map_x_pos < subtile_coord(stl_x, 0)) {
+            face_x = subtile_coord(stl_x, 0) + OCCLUDER_INSET;
+        } else {
+            continue;
+        }
+        long k = 1;
+        while (k <= planes)
+        {
+            unsigned char height = occluder_heights[k][cidx];
+            long run_end = k + 1;
+            while ((run_end <= planes) && (occluder_heights[run_end][cidx] == height))
+                run_end++;
+            if (height > 0)
+            {
+                add_occluder_quad(face_x, subtile_coord(ycell + k, 0) + OCCLUDER_INSET,
+                    face_x, subtile_coord(ycell + run_end, 0) - OCCLUDER_INSET, subtile_coord(height, 0));
+            }
+            k = run_end;
+        }
+    }
+}
+
 /**
  * Draws rectangular area of engine columns.
  * @param aposc
@@ -6866,6 +7206,7 @@ void draw_view(struct Camera *cam, unsigned char a2)
     long y = cam->mappos.y.val;
     long z = cam->mappos.z.val;
 
+    update_effect_particles_for_frame();
     getpoly = poly_pool;
     memset(buckets, 0, sizeof(buckets));
     if (map_volume_box.visible)
@@ -6917,6 +7258,17 @@ void draw_view(struct Camera *cam, unsigned char a2)
     ycell = (y >> 8) - (cells_away+1);
     find_gamut();
     fiddle_gamut(xcell, ycell + (cells_away+1));
+    if (lens_mode != 0)
+    {
+        engine_vertex_cache_begin_frame();
+    }
+    // Only pinhole perspective keeps walls straight on screen, as occlusion buffer requires
+    occlusion_begin_frame((lens_mode == 1) || (lens_mode == 2), 2*view_width_over_2, 2*view_height_over_2,
+        lens, view_width_over_2, view_height_over_2);
+    if (occlusion_is_active())
+    {
+        add_map_occluders(xcell, ycell);
+    }
 
     draw_view_map_plane(cam, aposc, bposc, xcell, ycell);
 
@@ -6927,6 +7279,7 @@ void draw_view(struct Camera *cam, unsigned char a2)
     }
 
     display_drawlist();
+    occlusion_end_frame();
     cam->zoom = zoom_mem;//TODO [zoom] remove when all cam->zoom will be changed to camera_zoom
     SYNCDBG(9,"Finished");
 }
@@ -8733,6 +9086,32 @@ TbBool placing_same_room_type(RoomIndex room_index)
     return true;
 }
 
+/** Distance around thing position which its sprite is assumed to fit in. */
+#define OCCLUDER_SPRITE_EXTENT 512
+
+/**
+ * Checks whether sprite of given thing is hidden behind occluders, and counts the result.
+ * Sprite size isn't known at this point, so the test uses generous bounds around
+ * the thing position, which was already transformed into given coordinates.
+ */
+static TbBool thing_sprite_occluded(const struct Thing *thing, const struct EngineCoord *ecor)
+{
+    if (!occlusion_is_active())
+        return false;
+    long extent = OCCLUDER_SPRITE_EXTENT + max(thing->clipbox_size_xy, thing->clipbox_size_z);
+    long near_z = ecor->z - extent;
+    TbBool culled = false;
+    if ((near_z >= OCCLUSION_NEAR_Z) && ((ecor->clip_flags & 0x0100) == 0))
+    {
+        // Square bounds, as camera roll may turn the sprite on screen
+        long scr_extent = (extent * lens) / near_z + 1;
+        culled = occlusion_rect_hidden(ecor->view_width - scr_extent, ecor->view_height - scr_extent,
+            ecor->view_width + scr_extent, ecor->view_height + scr_extent, near_z);
+    }
+    occlusion_count_sprite(culled);
+    return culled;
+}
+
 static void do_map_who_for_thing(struct Thing *thing)
 {
     int bckt_idx;
@@ -8782,6 +9161,10 @@ static void do_map_who_for_thing(struct Thing *thing)
             }
         }
         rotpers(&ecor, &camera_matrix);
+        if (thing_sprite_occluded(thing, &ecor))
+        {
+            break;
+        }
         if (getpoly < poly_pool_end)
         {
             if ( lens_mode )
@@ -8899,6 +9282,23 @@ static void do_map_who(short tnglist_idx)
     }
 }
 
+/**
+ * Draws effect particles which are on given map block.
+ * Particles are drawn through temporary things, the same way effect elements are.
+ */
+static void do_map_who_particles(const struct Map *mapblk)
+{
+    ParticleIndex part_idx = get_first_particle_on_map_block(mapblk);
+    while (part_idx != 0)
+    {
+        struct Thing* thing = get_particle_render_thing(part_idx);
+        if (thing == NULL)
+            break;
+        do_map_who_for_thing(thing);
+        part_idx = get_next_particle_on_map_block(part_idx);
+    }
+}
+
 static void draw_frontview_thing_on_element(struct Thing *thing, struct Map *map, struct Camera *cam)
 {
     // The draw_frontview_thing_on_element() function is the FrontView equivalent of do_map_who_for_thing()
@@ -9004,6 +9404,15 @@ static void draw_frontview_things_on_element(struct Map *mapblk, struct Camera *
             break;
         }
     }
+    ParticleIndex part_idx = get_first_particle_on_map_block(mapblk);
+    while (part_idx != 0)
+    {
+        thing = get_particle_render_thing(part_idx);
+        if (thing == NULL)
+            break;
+        draw_frontview_thing_on_element(thing, mapblk, cam);
+        part_idx = get_next_particle_on_map_block(part_idx);
+    }
 }
 
 void draw_frontview_engine(struct Camera *cam)
@@ -9032,6 +9441,7 @@ void draw_frontview_engine(struct Camera *cam)
     int32_t i;
     SYNCDBG(9,"Starting");
     player = get_my_player();
+    update_effect_particles_for_frame();
     if (cam->zoom > FRONTVIEW_CAMERA_ZOOM_MAX)
         cam->zoom = FRONTVIEW_CAMERA_ZOOM_MAX;
     calculate_hud_scale(cam);
@@ -746,19 +746,21 @@ TbResult frontend_load_data(void)
     // TODO: There is no "frontend_unload_data", find a better spot for this
     free_spritesheet(&frontend_sprite);
     ret = Lb_SUCCESS;
-    frontend_background = (unsigned char *)game.map;
 #ifdef SPRITE_FORMAT_V2
     fname = prepare_file_fmtpath(FGrp_LoData,"front-%d.raw",64);
 #else
     fname = prepare_file_path(FGrp_LoData,"front.raw");
 #endif
-    len = LbFileLoadAt(fname, frontend_background);
+    len = LbFileLengthRnc(fname);
+    if (len > (long)sizeof(frontend_background)) {
+        WARNLOG("Frontend background file too large, %ld bytes.",len);
+        len = -1;
+    } else {
+        len = LbFileLoadAt(fname, frontend_background);
+    }
     if (len < 307200) {
         ret = Lb_FAIL;
     }
-    if (len > sizeof(game.map)) {
-        WARNLOG("Reused memory area exceeded for frontend background.");
-    }
     char dat_fname[2048];
     char tab_fname[2048];
 #ifdef SPRITE_FORMAT_V2
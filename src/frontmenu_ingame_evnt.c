@@ -48,6 +48,8 @@
 #include "local_camera.h"
 #include "sprites.h"
 #include "timer.h"
+#include "lens_api.h"
+#include "engine_occlusion.h"
 
 #include "keeperfx.hpp"
 #include "post_inc.h"
@@ -858,6 +860,24 @@ void draw_frametime()
             LbTextDrawResized(0, (iStartLine+i)*tx_units_per_px, tx_units_per_px, text);
     }
 
+    // Lens effects cost, summed over rendering threads
+    iStartLine += TOTAL_FRAMERATE_KINDS;
+    struct LensEffectTiming lens_timings[8];
+    int lens_timings_count = LensManager_GetEffectTimings(LensManager_GetInstance(), lens_timings, sizeof(lens_timings)/sizeof(lens_timings[0]));
+    for (int i = 0; i < lens_timings_count; i++) {
+        snprintf(text, sizeof(text), "%s: %07.3f ms", lens_timings[i].name, lens_timings[i].time_ns / 1000000.0);
+        LbTextDrawResized(0, (iStartLine+i)*tx_units_per_px, tx_units_per_px, text);
+    }
+
+    // Occlusion culling results of the last perspective frame
+    iStartLine += lens_timings_count;
+    if (occlusion_stats.columns_drawn + occlusion_stats.columns_culled > 0) {
+        snprintf(text, sizeof(text), "Columns: %lu drawn, %lu culled", occlusion_stats.columns_drawn, occlusion_stats.columns_culled);
+        LbTextDrawResized(0, iStartLine*tx_units_per_px, tx_units_per_px, text);
+        snprintf(text, sizeof(text), "Sprites: %lu drawn, %lu culled", occlusion_stats.sprites_drawn, occlusion_stats.sprites_culled);
+        LbTextDrawResized(0, (iStartLine+1)*tx_units_per_px, tx_units_per_px, text);
+    }
+
     RendererSetDrawFlags(Lb_TEXT_HALIGN_LEFT);
 }
 
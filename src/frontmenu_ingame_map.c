@@ -105,6 +105,27 @@ static unsigned char PanelColours[16*PnC_End];
 static long PrevRoomHighlight;
 static long PrevDoorHighlight;
 static unsigned short PanelMap[MAX_SUBTILES_X*MAX_SUBTILES_Y];
+/** Slabs whose PanelMap entries need to be recomputed before drawing. */
+static unsigned char PanelMapDirtySlabs[MAX_TILES_X*MAX_TILES_Y];
+/** Bounds of dirty slabs area; end coords are exclusive. */
+static MapSlabCoord PanelMapDirtyStartX, PanelMapDirtyStartY;
+static MapSlabCoord PanelMapDirtyEndX, PanelMapDirtyEndY;
+/** Player for whom PanelMap was computed. */
+static PlayerNumber PanelMapPlayer = -1;
+/** Increased every time any PanelMap entry changes. */
+static unsigned long PanelMapGeneration;
+
+/** Colour indices of the map area, computed for the view parameters below. */
+static uint32_t *PanelMapCache = NULL;
+static int32_t *PanelMapCacheStart = NULL;
+static int32_t *PanelMapCacheEnd = NULL;
+static long PanelMapCacheLength;
+static unsigned long PanelMapCacheGeneration;
+static TbBool PanelMapCacheValid;
+static MapCoord PanelMapCacheCamX, PanelMapCacheCamY;
+static long PanelMapCacheAngle;
+static long PanelMapCacheZoom;
+static MapSubtlCoord PanelMapCacheSizeX, PanelMapCacheSizeY;
 
 long clicked_on_small_map;
 unsigned char grabbed_small_map;
@@ -778,28 +799,80 @@ void panel_map_update_subtile(PlayerNumber plyr_idx, MapSubtlCoord stl_x, MapSub
 
     }
     ushort *mapptr = &PanelMap[stl_num];
-    *mapptr = col;
+    if (*mapptr != col)
+    {
+        *mapptr = col;
+        PanelMapGeneration++;
+    }
 }
 
+/**
+ * Marks map panel area as requiring update. The area is recomputed when the map panel is drawn.
+ */
 void panel_map_update(long x, long y, long w, long h)
 {
     SYNCDBG(17,"Starting for rect (%ld,%ld) at (%ld,%ld)",w,h,x,y);
-    MapSubtlCoord stl_x;
-    MapSubtlCoord stl_y;
-    for (stl_y = y; stl_y < y + h; stl_y++)
+    MapSlabCoord start_x = max(subtile_slab(max(x, 0)), 0);
+    MapSlabCoord start_y = max(subtile_slab(max(y, 0)), 0);
+    MapSlabCoord end_x = min(subtile_slab(x + w - 1) + 1, game.map_tiles_x);
+    MapSlabCoord end_y = min(subtile_slab(y + h - 1) + 1, game.map_tiles_y);
+    if ((start_x >= end_x) || (start_y >= end_y))
+        return;
+    for (MapSlabCoord slb_y = start_y; slb_y < end_y; slb_y++)
     {
-        if (stl_y > game.map_subtiles_y)
-            break;
-        for (stl_x = x; stl_x < x + w; stl_x++)
+        memset(&PanelMapDirtySlabs[get_slab_number(start_x, slb_y)], 1, end_x - start_x);
+    }
+    if (PanelMapDirtyStartX >= PanelMapDirtyEndX)
+    {
+        PanelMapDirtyStartX = start_x;
+        PanelMapDirtyStartY = start_y;
+        PanelMapDirtyEndX = end_x;
+        PanelMapDirtyEndY = end_y;
+    } else
+    {
+        PanelMapDirtyStartX = min(PanelMapDirtyStartX, start_x);
+        PanelMapDirtyStartY = min(PanelMapDirtyStartY, start_y);
+        PanelMapDirtyEndX = max(PanelMapDirtyEndX, end_x);
+        PanelMapDirtyEndY = max(PanelMapDirtyEndY, end_y);
+    }
+}
+
+void panel_map_update_slab(MapSlabCoord slb_x, MapSlabCoord slb_y)
+{
+    panel_map_update(slab_subtile(slb_x,0), slab_subtile(slb_y,0), STL_PER_SLB, STL_PER_SLB);
+}
+
+/**
+ * Recomputes PanelMap entries of slabs marked by panel_map_update().
+ */
+static void panel_map_update_dirty_slabs(PlayerNumber plyr_idx)
+{
+    if (PanelMapPlayer != plyr_idx)
+    {
+        PanelMapPlayer = plyr_idx;
+        panel_map_update(0, 0, game.map_subtiles_x+1, game.map_subtiles_y+1);
+    }
+    MapSlabCoord end_x = min(PanelMapDirtyEndX, game.map_tiles_x);
+    MapSlabCoord end_y = min(PanelMapDirtyEndY, game.map_tiles_y);
+    for (MapSlabCoord slb_y = PanelMapDirtyStartY; slb_y < end_y; slb_y++)
+    {
+        for (MapSlabCoord slb_x = PanelMapDirtyStartX; slb_x < end_x; slb_x++)
         {
-            if (stl_x > game.map_subtiles_x)
-                break;
-            if (subtile_has_slab(stl_x, stl_y))
+            unsigned char *dirty = &PanelMapDirtySlabs[get_slab_number(slb_x, slb_y)];
+            if (*dirty == 0)
+                continue;
+            *dirty = 0;
+            for (MapSubtlCoord stl_y = slab_subtile(slb_y,0); stl_y < slab_subtile(slb_y,STL_PER_SLB); stl_y++)
             {
-                panel_map_update_subtile(my_player_number, stl_x, stl_y); //player->id number is still unitialized when this function is called at level start
+                for (MapSubtlCoord stl_x = slab_subtile(slb_x,0); stl_x < slab_subtile(slb_x,STL_PER_SLB); stl_x++)
+                {
+                    panel_map_update_subtile(plyr_idx, stl_x, stl_y);
+                }
             }
         }
     }
+    PanelMapDirtyStartX = PanelMapDirtyEndX = 0;
+    PanelMapDirtyStartY = PanelMapDirtyEndY = 0;
 }
 
 static void do_map_rotate_stuff(float relpos_x, float relpos_y, float *coord_x, float *coord_y, long zoom)
@@ -1239,18 +1312,36 @@ void auto_gen_tables(long units_per_px)
     }
 }
 
-void panel_map_draw_slabs(long x, long y, long units_per_px, long zoom)
+/**
+ * Allocates the map area cache for current map diagonal length.
+ */
+static TbBool setup_panel_map_cache(void)
 {
-    PanelMapX = scale_value_for_resolution_with_upp(x,units_per_px);
-    PanelMapY = scale_value_for_resolution_with_upp(y,units_per_px);
-    auto_gen_tables(units_per_px);
-    update_panel_colors();
-    struct PlayerInfo *player = get_my_player();
-    struct Camera *cam = get_local_camera(get_player_active_camera(player));
-
-    if ((cam == NULL) || (MapDiagonalLength < 1))
-        return;
+    if (PanelMapCacheLength != MapDiagonalLength)
+    {
+        free(PanelMapCache);
+        free(PanelMapCacheStart);
+        free(PanelMapCacheEnd);
+        PanelMapCache = (uint32_t *)calloc(MapDiagonalLength*MapDiagonalLength, sizeof(uint32_t));
+        PanelMapCacheStart = (int32_t *)calloc(MapDiagonalLength, sizeof(int32_t));
+        PanelMapCacheEnd = (int32_t *)calloc(MapDiagonalLength, sizeof(int32_t));
+        PanelMapCacheLength = MapDiagonalLength;
+        PanelMapCacheValid = false;
+    }
+    if ((PanelMapCache == NULL) || (PanelMapCacheStart == NULL) || (PanelMapCacheEnd == NULL))
+    {
+        PanelMapCacheLength = 0;
+        return false;
+    }
+    return true;
+}
 
+/**
+ * Fills the map area cache with colour indices of map subtiles seen from given camera.
+ * Only needs to be called when the camera or PanelMap changes; drawing then just maps indices to colours.
+ */
+static void update_panel_map_cache(const struct Camera *cam, long zoom)
+{
     const int32_t shift_x = -LbSinL(cam->rotation_angle_x) * zoom / 256;
     const int32_t shift_y = LbCosL(cam->rotation_angle_x) * zoom / 256;
     int32_t shift_stl_x = (cam->mappos.x.val << 8) - MapDiagonalLength * shift_x / 2 - MapDiagonalLength * shift_y / 2;
@@ -1258,8 +1349,8 @@ void panel_map_draw_slabs(long x, long y, long units_per_px, long zoom)
 
     TbPixel *bkgnd_line;
     bkgnd_line = MapBackground;
-    TbPixel *out_line;
-    out_line = &lbDisplay.WScreen[PanelMapX + lbDisplay.GraphicsScreenWidth * PanelMapY];
+    uint32_t *cache_line;
+    cache_line = PanelMapCache;
     int h;
     for (h = 0; h < MapDiagonalLength; h++)
     {
@@ -1289,10 +1380,12 @@ void panel_map_draw_slabs(long x, long y, long units_per_px, long zoom)
             subpos_y += shift_y;
             subpos_x -= shift_x;
         }
+        PanelMapCacheStart[h] = start_w;
+        PanelMapCacheEnd[h] = end_w;
         TbPixel *bkgnd;
         bkgnd = &bkgnd_line[start_w];
-        TbPixel *out;
-        out = &out_line[start_w];
+        uint32_t *cache;
+        cache = &cache_line[start_w];
         unsigned int precor_y;
         unsigned int precor_x;
         precor_x = subpos_y;
@@ -1302,19 +1395,70 @@ void panel_map_draw_slabs(long x, long y, long units_per_px, long zoom)
         {
             int pnmap_idx;
             pnmap_idx = ((precor_x>>16)) + (((precor_y>>16)) * (game.map_subtiles_x + 1) );
-            int pncol_idx;
             //TODO reenable background
-            pncol_idx = PanelMap[pnmap_idx] + (*bkgnd * PnC_End);
-            *out = PanelColours[pncol_idx];
+            *cache = PanelMap[pnmap_idx] + (*bkgnd * PnC_End);
             precor_x += shift_y;
             precor_y -= shift_x;
-            out++;
+            cache++;
             bkgnd++;
         }
-        out_line += lbDisplay.GraphicsScreenWidth;
+        cache_line += MapDiagonalLength;
         bkgnd_line += MapDiagonalLength;
         shift_stl_x += shift_x;
         shift_stl_y += shift_y;
     }
+    PanelMapCacheGeneration = PanelMapGeneration;
+    PanelMapCacheCamX = cam->mappos.x.val;
+    PanelMapCacheCamY = cam->mappos.y.val;
+    PanelMapCacheAngle = cam->rotation_angle_x;
+    PanelMapCacheZoom = zoom;
+    PanelMapCacheSizeX = game.map_subtiles_x;
+    PanelMapCacheSizeY = game.map_subtiles_y;
+    PanelMapCacheValid = true;
+}
+
+static TbBool panel_map_cache_is_current(const struct Camera *cam, long zoom)
+{
+    return PanelMapCacheValid && (PanelMapCacheGeneration == PanelMapGeneration)
+        && (PanelMapCacheCamX == cam->mappos.x.val) && (PanelMapCacheCamY == cam->mappos.y.val)
+        && (PanelMapCacheAngle == cam->rotation_angle_x) && (PanelMapCacheZoom == zoom)
+        && (PanelMapCacheSizeX == game.map_subtiles_x) && (PanelMapCacheSizeY == game.map_subtiles_y);
+}
+
+void panel_map_draw_slabs(long x, long y, long units_per_px, long zoom)
+{
+    PanelMapX = scale_value_for_resolution_with_upp(x,units_per_px);
+    PanelMapY = scale_value_for_resolution_with_upp(y,units_per_px);
+    if (PrevPixelSize != 256 * units_per_px / 16) {
+        PanelMapCacheValid = false;
+    }
+    auto_gen_tables(units_per_px);
+    update_panel_colors();
+    struct PlayerInfo *player = get_my_player();
+    struct Camera *cam = get_local_camera(get_player_active_camera(player));
+
+    if ((cam == NULL) || (MapDiagonalLength < 1))
+        return;
+    if (!setup_panel_map_cache())
+        return;
+    panel_map_update_dirty_slabs(player->id_number);
+    if (!panel_map_cache_is_current(cam, zoom))
+        update_panel_map_cache(cam, zoom);
+
+    const uint32_t *cache_line;
+    cache_line = PanelMapCache;
+    TbPixel *out_line;
+    out_line = &lbDisplay.WScreen[PanelMapX + lbDisplay.GraphicsScreenWidth * PanelMapY];
+    int h;
+    for (h = 0; h < MapDiagonalLength; h++)
+    {
+        int w;
+        for (w = PanelMapCacheStart[h]; w < PanelMapCacheEnd[h]; w++)
+        {
+            out_line[w] = PanelColours[cache_line[w]];
+        }
+        out_line += lbDisplay.GraphicsScreenWidth;
+        cache_line += MapDiagonalLength;
+    }
 }
 /******************************************************************************/
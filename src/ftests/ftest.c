@@ -10,7 +10,10 @@
 #include "../slab_data.h"
 #include "../room_util.h"
 #include "../player_instances.h"
-#includw "../gui_msgs.h"
+#include "../gui_msgs.h"
+#include "../bflib_datetm.h"
+
+#include <stdarg.h>
 
 #include "../post_inc.h"
 
@@ -32,7 +35,10 @@ struct ftest_donottouch__variables ftest_donottouch__vars = {
     .current_action = 0,
     .previous_action = UINT32_MAX,
     .is_restarting_actions_queue = false,
-    .current_turn_counter = 0
+    .current_turn_counter = 0,
+    .test_started_at_game_turn = 0,
+    .test_started_at_clock = 0,
+    .failure_reason = ""
 };
 
 const char* FTestFrameworkState_Strings[] = {
@@ -174,6 +180,106 @@ TbBool ftest_parse_arg(char * const arg)
     return false;
 }
 
+void ftest_set_failure_reason(const char* format, ...)
+{
+    struct ftest_donottouch__variables* const vars = &ftest_donottouch__vars;
+    if(vars->failure_reason[0] != '\0')
+    {
+        return;
+    }
+
+    va_list val;
+    va_start(val, format);
+    vsnprintf(vars->failure_reason, sizeof(vars->failure_reason), format, val);
+    va_end(val);
+}
+
+/**
+ * @brief Checks whether test_name is one of the comma separated names in name_list.
+ * This allows a test runner to execute a shard of tests within a single process, eg: -ftests test_a,test_b
+ */
+static TbBool ftest_name_in_list(const char* name_list, const char* test_name)
+{
+    const size_t test_name_len = strnlen(test_name, FTEST_MAX_NAME_LENGTH);
+    const char* token = name_list;
+    while(*token != '\0')
+    {
+        const char* token_end = strchr(token, ',');
+        size_t token_len = (token_end != NULL) ? (size_t)(token_end - token) : strlen(token);
+        if((token_len == test_name_len) && (strncmp(token, test_name, token_len) == 0))
+        {
+            return true;
+        }
+        if(token_end == NULL)
+        {
+            break;
+        }
+        token = token_end + 1;
+    }
+    return false;
+}
+
+static void ftest_write_json_string(FILE* fp, const char* str)
+{
+    fputc('"', fp);
+    for(const char* c = str; *c != '\0'; ++c)
+    {
+        switch(*c)
+        {
+            case '"':  fputs("\\\"", fp); break;
+            case '\\': fputs("\\\\", fp); break;
+            case '\n': fputs("\\n", fp); break;
+            case '\r': fputs("\\r", fp); break;
+            case '\t': fputs("\\t", fp); break;
+            default:
+                if((unsigned char)*c < 0x20)
+                    fprintf(fp, "\\u%04x", (unsigned char)*c);
+                else
+                    fputc(*c, fp);
+                break;
+        }
+    }
+    fputc('"', fp);
+}
+
+/**
+ * @brief Appends the result of the given test to the report file provided with -ftest_report.
+ * Each result is written as a single JSON object per line, so several processes (or shards) can be aggregated by the test runner.
+ */
+static void ftest_report_result(const struct FTestConfig* const test_config, const char* result)
+{
+    struct ftest_donottouch__variables* const vars = &ftest_donottouch__vars;
+
+    if(start_params.functest_report_fname[0] == '\0')
+    {
+        return;
+    }
+
+    FILE* fp = fopen(start_params.functest_report_fname, "a");
+    if(fp == NULL)
+    {
+        FTESTLOG("Unable to open report file '%s'", start_params.functest_report_fname);
+        return;
+    }
+
+    GameTurn turns = get_gameturn() - vars->test_started_at_game_turn;
+    TbClockMSec wall_time = LbTimerClock() - vars->test_started_at_clock;
+    // Turns per second don't depend on the frame rate settings, so they can be compared between runs
+    double turns_per_second = (wall_time > 0) ? ((double)turns * 1000.0 / (double)wall_time) : 0.0;
+
+    fputs("{\"test\":", fp);
+    ftest_write_json_string(fp, test_config->test_name);
+    fputs(",\"result\":", fp);
+    ftest_write_json_string(fp, result);
+    fprintf(fp, ",\"turns\":%lu,\"wall_time_ms\":%ld,\"turns_per_second\":%.1f,\"level_file\":",
+        (unsigned long)turns, (long)wall_time, turns_per_second);
+    ftest_write_json_string(fp, test_config->level_file);
+    fprintf(fp, ",\"level\":%ld,\"seed\":%u,\"message\":", (long)test_config->level, test_config->seed);
+    ftest_write_json_string(fp, vars->failure_reason);
+    fputs("}\n", fp);
+    fclose(fp);
+}
+
 TbBool ftest_fill_teststorun_by_name(char* const name)
 {
     struct ftest_onlyappendtests__config* const conf = &ftest_onlyappendtests__conf;
@@ -235,7 +341,7 @@ TbBool ftest_fill_teststorun_by_name(char* const name)
                 FTESTLOG("Added test '%s' via wildcard match", test_config->test_name);
                 vars->tests_to_run[vars->total_tests++] = test_config;
             }
-            else if(strcmp(name, test_config->test_name) == 0)
+            else if(ftest_name_in_list(name, test_config->test_name))
             {
                 FTESTLOG("Added test '%s' via exact match", test_config->test_name);
                 vars->tests_to_run[vars->total_tests++] = test_config;
@@ -308,6 +414,7 @@ TbBool ftest_setup_test(struct FTestConfig* const test_config)
     }
 
     ftest_clear_actions();
+    vars->failure_reason[0] = '\0';
 
     //queue init for corresponding test level
     vars->pending_init = test_config;
@@ -453,6 +560,8 @@ FTestFrameworkState ftest_update(FTestFrameworkState* const out_prev_state)
         {
             message_add_fmt(MsgType_Player, PLAYER0, "Initializing Functional Test %s", vars->pending_init->test_name);
             FTESTLOG("Initializing Functional Test %s", vars->pending_init->test_name);
+            vars->test_started_at_game_turn = get_gameturn();
+            vars->test_started_at_clock = LbTimerClock();
             if(vars->pending_init->init_func)
             {
                 vars->pending_init->init_func();
@@ -522,10 +631,28 @@ FTestFrameworkState ftest_update(FTestFrameworkState* const out_prev_state)
             }
         }
 
+        // enforce the limits given by the test runner, so a stuck test cannot hang the whole run
+        const char* limit_result = NULL;
+        if((vars->current_action < ftest_actions_length) && !flag_is_set(start_params.functest_flags, FTF_TestFailed))
+        {
+            if((start_params.functest_max_turns > 0) && (get_gameturn() - vars->test_started_at_game_turn >= start_params.functest_max_turns))
+            {
+                FTEST_FAIL_TEST("Test %s exceeded the turn limit (%lu)", current_test_config->test_name, (unsigned long)start_params.functest_max_turns);
+                limit_result = "timeout";
+            }
+            else if((start_params.functest_max_time > 0) && ((unsigned long)(LbTimerClock() - vars->test_started_at_clock) >= start_params.functest_max_time))
+            {
+                FTEST_FAIL_TEST("Test %s exceeded the time limit (%lu ms)", current_test_config->test_name, start_params.functest_max_time);
+                limit_result = "timeout";
+            }
+        }
+
         TbBool test_failed = flag_is_set(start_params.functest_flags, FTF_TestFailed);
         TbBool is_done_actions = vars->current_action >= ftest_actions_length || test_failed; // actions completed, OR test failed
         if(is_done_actions)
         {
+            ftest_report_result(current_test_config, test_failed ? ((limit_result != NULL) ? limit_result : "failed") : "passed");
+
             if(!test_failed)
             {
                 FTESTLOG("Test %s passed!", current_test_config->test_name);
@@ -26,6 +26,7 @@ extern "C" {
     set_flag(start_params.functest_flags, FTF_TestFailed); \
     FTESTLOG("Failing test"); \
     FTESTLOG(format, ##__VA_ARGS__); \
+    ftest_set_failure_reason("%s: " format, __func__, ##__VA_ARGS__); \
 }
 
 #define FTEST_FRAMEWORK_ABORT(format, ...) { \
@@ -37,6 +38,7 @@ extern "C" {
 #define FTEST_MAX_NAME_LENGTH 128
 #define FTEST_MAX_TESTS 128
 #define FTEST_MAX_ACTIONS_PER_TEST 100
+#define FTEST_MAX_REASON_LENGTH 256
 
 typedef unsigned char TbBool; //redefine rather than include extraneus header info
 
@@ -156,6 +158,10 @@ struct ftest_donottouch__variables
 
     GameTurn current_turn_counter;
 
+    GameTurn test_started_at_game_turn;
+    TbClockMSec test_started_at_clock;
+    char failure_reason[FTEST_MAX_REASON_LENGTH];
+
     FTest_Action_Func           actions_func_list[FTEST_MAX_ACTIONS_PER_TEST];
     GameTurn                    actions_func_turn_list[FTEST_MAX_ACTIONS_PER_TEST];
 
@@ -183,6 +189,12 @@ TbBool ftest_append_action(FTest_Action_Func func, GameTurn turn_delay, void* da
 
 TbBool ftest_parse_arg(char* const arg);
 
+/**
+ * @brief Stores the reason of the current test failure, so it can be written to the results report.
+ * Only the first reason is kept; it is cleared when the next test starts.
+ */
+void ftest_set_failure_reason(const char* format, ...);
+
 void ftest_srand();
 
 TbBool ftest_init();
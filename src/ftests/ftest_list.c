@@ -16,6 +16,8 @@
 #include "tests/ftest_bug_invisible_units_cant_select.h"
 #include "tests/ftest_bug_pathing_stair_treasury.h"
 #include "tests/ftest_bug_ai_bridge.h"
+#include "tests/ftest_bench_line_of_sight.h"
+#include "tests/ftest_bench_spiral.h"
 // append your test include here, eg: #include "tests/ftest_your_test_header.h"
 
 #include "../post_inc.h"
@@ -48,6 +50,8 @@ struct ftest_onlyappendtests__config ftest_onlyappendtests__conf = {
     // place long-running tests in this list, to include them use the -includelongtests flag
     .long_running_tests_list = {
         { .test_name="bug_ai_bridge",                      .init_func=ftest_bug_ai_bridge_init,                    .level_file="keeporig", .level=15, .frame_skip=128, .seed=1, .repeat_n_times=100 },
+        { .test_name="bench_line_of_sight",                .init_func=ftest_bench_line_of_sight_init,              .level_file="keeporig", .level=1,  .frame_skip=0 },
+        { .test_name="bench_spiral",                       .init_func=ftest_bench_spiral_init,                     .level_file="keeporig", .level=1,  .frame_skip=0 },
     }
 };
 
@@ -15,6 +15,7 @@
 #include "../frontend.h"
 #include "../bflib_mouse.h"
 #include "../bflib_planar.h"
+#include "../bflib_datetm.h"
 
 #include "../post_inc.h"
 
@@ -454,6 +455,49 @@ struct Thing* ftest_util_create_door_for_player_with_health(MapSlabCoord slb_x,
     return new_door;
 }
 
+unsigned long ftest_util_random(unsigned long* random_state, unsigned long range)
+{
+    *random_state = *random_state * 1103515245ul + 12345ul;
+    return ((*random_state >> 16) & 0x7FFF) % range;
+}
+
+static TbClockMSec ftest_util_bench_run(FTestBenchQuery query, FTestBenchReset reset, void* data,
+    int items_count, int passes, long* reference_results, TbBool store, unsigned long* mismatches)
+{
+    if (reset != NULL) {
+        reset(data);
+    }
+    TbClockMSec start = LbTimerClock();
+    for (int pass = 0; pass < passes; ++pass)
+    {
+        for (int i = 0; i < items_count; ++i)
+        {
+            long item_result = query(data, i);
+            if (store) {
+                reference_results[i] = item_result;
+            } else
+            if (item_result != reference_results[i]) {
+                (*mismatches)++;
+            }
+        }
+    }
+    return LbTimerClock() - start;
+}
+
+void ftest_util_bench_compare(TbBool* optimization_enabled, FTestBenchQuery query, FTestBenchReset reset, void* data,
+    int items_count, int passes, long* reference_results, struct FTestBenchResult* result)
+{
+    TbBool prev_enabled = *optimization_enabled;
+    result->mismatches = 0;
+
+    *optimization_enabled = false;
+    result->reference_time = ftest_util_bench_run(query, reset, data, items_count, passes, reference_results, true, &result->mismatches);
+
+    *optimization_enabled = true;
+    result->optimized_time = ftest_util_bench_run(query, reset, data, items_count, passes, reference_results, false, &result->mismatches);
+
+    *optimization_enabled = prev_enabled;
+}
 
 #ifdef __cplusplus
 }
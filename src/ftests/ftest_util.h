@@ -183,6 +183,48 @@ struct ftest_util_action__create_and_fill_torture_room__variables
     TbBool only_run_once;
 };
 
+/**
+ * @brief Returns pseudo-random number below range, from a generator local to the test
+ * (so that benchmarks don't disturb synced random state)
+ *
+ * @param random_state state of the generator, to be initialized by the test
+ * @param range
+ * @return unsigned long
+ */
+unsigned long ftest_util_random(unsigned long* random_state, unsigned long range);
+
+/**
+ * @brief Query compared by ftest_util_bench_compare(), returns the result for the given item
+ */
+typedef long (*FTestBenchQuery)(void* data, int item);
+/**
+ * @brief Called before each run of ftest_util_bench_compare(), ie. to clear caches
+ */
+typedef void (*FTestBenchReset)(void* data);
+
+struct FTestBenchResult
+{
+    TbClockMSec reference_time;
+    TbClockMSec optimized_time;
+    unsigned long mismatches;
+};
+
+/**
+ * @brief Runs query over all items with the optimization switched off, then with it switched on,
+ * timing both runs and counting results of the second run which differ from the first one.
+ * The optimization switch is restored afterwards.
+ *
+ * @param optimization_enabled switch of the optimization being benchmarked
+ * @param query
+ * @param reset optional, may be NULL
+ * @param data passed to query and reset
+ * @param items_count
+ * @param passes how many times each item is queried within a run
+ * @param reference_results buffer for items_count results of the first run
+ * @param result
+ */
+void ftest_util_bench_compare(TbBool* optimization_enabled, FTestBenchQuery query, FTestBenchReset reset, void* data,
+    int items_count, int passes, long* reference_results, struct FTestBenchResult* result);
 
 #ifdef __cplusplus
 }
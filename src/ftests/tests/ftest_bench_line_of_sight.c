@@ -0,0 +1,103 @@
+#include "ftest_bench_line_of_sight.h"
+
+#ifdef FUNCTESTING
+
+#include "../../pre_inc.h"
+
+#include <string.h>
+
+#include "../ftest.h"
+#include "../ftest_util.h"
+
+#include "../../game_legacy.h"
+#include "../../keeperfx.hpp"
+#include "../../creature_senses.h"
+#include "../../bflib_datetm.h"
+
+#include "../../post_inc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FTEST_BENCH_LINE_OF_SIGHT__PAIRS 4096
+// each pair is queried this many times within a turn, like many creatures looking at the same target
+#define FTEST_BENCH_LINE_OF_SIGHT__PASSES 4
+
+struct ftest_bench_line_of_sight__variables
+{
+    struct Coord3d pos_from[FTEST_BENCH_LINE_OF_SIGHT__PAIRS];
+    struct Coord3d pos_to[FTEST_BENCH_LINE_OF_SIGHT__PAIRS];
+    long result_uncached[FTEST_BENCH_LINE_OF_SIGHT__PAIRS];
+    unsigned long random_state;
+};
+struct ftest_bench_line_of_sight__variables ftest_bench_line_of_sight__vars = {
+    .random_state = 12345,
+};
+
+// forward declarations - tests
+FTestActionResult ftest_bench_line_of_sight_action001__compare_cached(struct FTestActionArgs* const args);
+
+TbBool ftest_bench_line_of_sight_init()
+{
+    ftest_append_action(ftest_bench_line_of_sight_action001__compare_cached, 20, &ftest_bench_line_of_sight__vars);
+
+    return true;
+}
+
+static void ftest_bench_line_of_sight__random_pos(struct ftest_bench_line_of_sight__variables* const vars, struct Coord3d* pos)
+{
+    // stay near each other, far lines mostly hit a wall after a few subtiles
+    pos->x.val = subtile_coord(1 + ftest_util_random(&vars->random_state, game.map_subtiles_x - 2), 0);
+    pos->y.val = subtile_coord(1 + ftest_util_random(&vars->random_state, game.map_subtiles_y - 2), 0);
+    pos->z.val = subtile_coord(1, 0);
+}
+
+static long ftest_bench_line_of_sight__query(void* data, int item)
+{
+    struct ftest_bench_line_of_sight__variables* const vars = data;
+    return line_of_sight_3d(&vars->pos_from[item], &vars->pos_to[item]);
+}
+
+static void ftest_bench_line_of_sight__reset(void* data)
+{
+    invalidate_line_of_sight_cache();
+    memset(&line_of_sight_cache_stats, 0, sizeof(line_of_sight_cache_stats));
+}
+
+FTestActionResult ftest_bench_line_of_sight_action001__compare_cached(struct FTestActionArgs* const args)
+{
+    struct ftest_bench_line_of_sight__variables* const vars = args->data;
+
+    for (int i = 0; i < FTEST_BENCH_LINE_OF_SIGHT__PAIRS; ++i)
+    {
+        ftest_bench_line_of_sight__random_pos(vars, &vars->pos_from[i]);
+        vars->pos_to[i] = vars->pos_from[i];
+        vars->pos_to[i].x.val += ((long)ftest_util_random(&vars->random_state, 21) - 10) * COORD_PER_STL;
+        vars->pos_to[i].y.val += ((long)ftest_util_random(&vars->random_state, 21) - 10) * COORD_PER_STL;
+        vars->pos_to[i].x.val = clamp(vars->pos_to[i].x.val, COORD_PER_STL, subtile_coord(game.map_subtiles_x - 1, 0));
+        vars->pos_to[i].y.val = clamp(vars->pos_to[i].y.val, COORD_PER_STL, subtile_coord(game.map_subtiles_y - 1, 0));
+    }
+
+    struct FTestBenchResult result;
+    ftest_util_bench_compare(&line_of_sight_cache_enabled, ftest_bench_line_of_sight__query, ftest_bench_line_of_sight__reset, vars,
+        FTEST_BENCH_LINE_OF_SIGHT__PAIRS, FTEST_BENCH_LINE_OF_SIGHT__PASSES, vars->result_uncached, &result);
+    invalidate_line_of_sight_cache();
+
+    FTESTLOG("%d queries: uncached %lu ms, cached %lu ms, cache hits %lu, misses %lu",
+        FTEST_BENCH_LINE_OF_SIGHT__PAIRS * FTEST_BENCH_LINE_OF_SIGHT__PASSES,
+        (unsigned long)result.reference_time, (unsigned long)result.optimized_time,
+        line_of_sight_cache_stats.hits, line_of_sight_cache_stats.misses);
+    if (result.mismatches > 0)
+    {
+        FTEST_FAIL_TEST("Cached line of sight differs from computed one in %lu queries", result.mismatches);
+    }
+
+    return FTRs_Go_To_Next_Action;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FUNCTESTING
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "../../globals.h"
+
+#ifdef FUNCTESTING
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef unsigned char TbBool;
+
+/**
+ * @brief Measures line of sight queries with and without the per-turn results cache
+ *
+ */
+TbBool ftest_bench_line_of_sight_init();
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FUNCTESTING
@@ -0,0 +1,110 @@
+#include "ftest_bench_spiral.h"
+
+#ifdef FUNCTESTING
+
+#include "../../pre_inc.h"
+
+#include <string.h>
+
+#include "../ftest.h"
+#include "../ftest_util.h"
+
+#include "../../game_legacy.h"
+#include "../../keeperfx.hpp"
+#include "../../map_utils.h"
+#include "../../thing_list.h"
+#include "../../bflib_datetm.h"
+
+#include "../../post_inc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FTEST_BENCH_SPIRAL__POSITIONS 4096
+// digger job searches use short spirals, combat target searches use long ones
+#define FTEST_BENCH_SPIRAL__DIGGER_LEN 25
+#define FTEST_BENCH_SPIRAL__COMBAT_LEN 400
+
+struct ftest_bench_spiral__variables
+{
+    struct Coord3d pos[FTEST_BENCH_SPIRAL__POSITIONS];
+    long result_checked[FTEST_BENCH_SPIRAL__POSITIONS];
+    long spiral_len;
+    unsigned long random_state;
+};
+struct ftest_bench_spiral__variables ftest_bench_spiral__vars = {
+    .random_state = 54321,
+};
+
+// forward declarations - tests
+FTestActionResult ftest_bench_spiral_action001__compare_fast_path(struct FTestActionArgs* const args);
+
+TbBool ftest_bench_spiral_init()
+{
+    ftest_append_action(ftest_bench_spiral_action001__compare_fast_path, 20, &ftest_bench_spiral__vars);
+
+    return true;
+}
+
+static TbBool ftest_bench_spiral__count_thing(struct Thing *thing)
+{
+    return true;
+}
+
+static long ftest_bench_spiral__accept_position(const struct Coord3d *pos, MaxCoordFilterParam param, long maximizer)
+{
+    // prefer the position furthest along the spiral, so that every step is visited
+    return maximizer + 1;
+}
+
+static long ftest_bench_spiral__query(void* data, int item)
+{
+    struct ftest_bench_spiral__variables* const vars = data;
+    struct Coord3d retpos;
+    long result = do_to_things_spiral_near_map_block(vars->pos[item].x.val, vars->pos[item].y.val, vars->spiral_len, ftest_bench_spiral__count_thing);
+    if (get_position_spiral_near_map_block_with_filter(&retpos, vars->pos[item].x.val, vars->pos[item].y.val, vars->spiral_len, ftest_bench_spiral__accept_position, NULL)) {
+        result += get_subtile_number(retpos.x.stl.num, retpos.y.stl.num);
+    }
+    return result;
+}
+
+FTestActionResult ftest_bench_spiral_action001__compare_fast_path(struct FTestActionArgs* const args)
+{
+    struct ftest_bench_spiral__variables* const vars = args->data;
+
+    for (int i = 0; i < FTEST_BENCH_SPIRAL__POSITIONS; ++i)
+    {
+        // whole map, so that spirals crossing map edges are included
+        vars->pos[i].x.val = subtile_coord_center(ftest_util_random(&vars->random_state, game.map_subtiles_x));
+        vars->pos[i].y.val = subtile_coord_center(ftest_util_random(&vars->random_state, game.map_subtiles_y));
+        vars->pos[i].z.val = 0;
+    }
+
+    const long spiral_lens[] = {FTEST_BENCH_SPIRAL__DIGGER_LEN, FTEST_BENCH_SPIRAL__COMBAT_LEN};
+    unsigned long mismatches = 0;
+    for (int n = 0; n < sizeof(spiral_lens)/sizeof(spiral_lens[0]); ++n)
+    {
+        struct FTestBenchResult result;
+        vars->spiral_len = spiral_lens[n];
+        ftest_util_bench_compare(&spiral_fast_path_enabled, ftest_bench_spiral__query, NULL, vars,
+            FTEST_BENCH_SPIRAL__POSITIONS, 1, vars->result_checked, &result);
+        mismatches += result.mismatches;
+        FTESTLOG("%d spirals of length %ld: checked %lu ms, fast path %lu ms",
+            FTEST_BENCH_SPIRAL__POSITIONS, spiral_lens[n],
+            (unsigned long)result.reference_time, (unsigned long)result.optimized_time);
+    }
+
+    if (mismatches > 0)
+    {
+        FTEST_FAIL_TEST("Spiral fast path differs from checked one at %lu positions", mismatches);
+    }
+
+    return FTRs_Go_To_Next_Action;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FUNCTESTING
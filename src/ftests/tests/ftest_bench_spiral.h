@@ -0,0 +1,24 @@
+#pragma once
+
+#include "../../globals.h"
+
+#ifdef FUNCTESTING
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef unsigned char TbBool;
+
+/**
+ * @brief Measures spiral searches around map positions with and without the unchecked fast path
+ *
+ */
+TbBool ftest_bench_spiral_init();
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FUNCTESTING
@@ -242,11 +242,12 @@ struct Game {
     struct LightsShadows lish;
     struct CreatureControl cctrl_data[CREATURES_COUNT];
     struct Thing things_data[THINGS_COUNT];
-    NavColour navigation_map[MAX_SUBTILES_X*MAX_SUBTILES_Y];
-    struct Map map[MAX_SUBTILES_X*MAX_SUBTILES_Y];
+    /** Map storage is sized to the level and kept outside; see setup_map_storage(). */
+    NavColour *navigation_map;
+    struct Map *map;
     struct ComputerTask computer_task[COMPUTER_TASKS_COUNT];
     struct Computer2 computer[PLAYERS_COUNT];
-    struct SlabMap slabmap[MAX_TILES_X*MAX_TILES_Y];
+    struct SlabMap *slabmap;
     struct Room rooms[ROOMS_COUNT];
     struct Dungeon dungeon[DUNGEONS_COUNT];
     struct StructureList thing_lists[13];
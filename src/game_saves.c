@@ -50,6 +50,7 @@
 #include "keeperfx.hpp"
 #include "api.h"
 #include "lvl_filesdk1.h"
+#include "map_data.h"
 #include "lua_base.h"
 #include "lua_triggers.h"
 #include "moonphase.h"
@@ -137,6 +138,29 @@ TbBool is_primitive_save_version(long filesize)
     return false;
 }
 
+/**
+ * Writes map data chunk; only the part of map storage used by current level is saved.
+ */
+static TbBool save_map_data_chunk(TbFileHandle fhandle)
+{
+    struct FileChunkHeader hdr;
+    hdr.id = SGC_MapData;
+    hdr.ver = 0;
+    hdr.len = get_map_storage_data_size();
+    unsigned char* buf = (unsigned char*)malloc(hdr.len);
+    if (buf == NULL) {
+        WARNLOG("Could not allocate memory for MapData chunk");
+        return false;
+    }
+    pack_map_storage(buf);
+    TbBool result = false;
+    if (LbFileWrite(fhandle, &hdr, sizeof(struct FileChunkHeader)) == sizeof(struct FileChunkHeader))
+    if (LbFileWrite(fhandle, buf, hdr.len) == hdr.len)
+        result = true;
+    free(buf);
+    return result;
+}
+
 TbBool save_game_chunks(TbFileHandle fhandle, struct CatalogueEntry *centry)
 {
     struct FileChunkHeader hdr;
@@ -159,6 +183,8 @@ TbBool save_game_chunks(TbFileHandle fhandle, struct CatalogueEntry *centry)
         if (LbFileWrite(fhandle, &game, sizeof(struct Game)) == sizeof(struct Game))
             chunks_done |= SGF_GameOrig;
     }
+    if (save_map_data_chunk(fhandle))
+        chunks_done |= SGF_MapData;
     { // IntralevelData data chunk
         hdr.id = SGC_IntralevelData;
         hdr.ver = 0;
@@ -218,6 +244,8 @@ TbBool save_packet_chunks(TbFileHandle fhandle,struct CatalogueEntry *centry)
             if (LbFileWrite(fhandle, &game, sizeof(struct Game)) == sizeof(struct Game))
                 chunks_done |= SGF_GameOrig;
         }
+        if (save_map_data_chunk(fhandle))
+            chunks_done |= SGF_MapData;
     }
     { // Packet file data start indicator
         hdr.id = SGC_PacketData;
@@ -272,6 +300,32 @@ int load_game_chunks(TbFileHandle fhandle, struct CatalogueEntry *centry)
             } else {
                 WARNLOG("Could not read GameOrig chunk");
             }
+            // Map storage pointers were overwritten; storage is also resized to the loaded map
+            if (!setup_map_storage()) {
+                return GLoad_Failed;
+            }
+            break;
+        case SGC_MapData:
+            if (((chunks_done & SGF_GameOrig) == 0) || (hdr.len != get_map_storage_data_size()))
+            {
+                if (LbFileSeek(fhandle, hdr.len, Lb_FILE_SEEK_CURRENT) < 0)
+                    LbFileSeek(fhandle, 0, Lb_FILE_SEEK_END);
+                WARNLOG("Incompatible MapData chunk");
+                break;
+            }
+            {
+                unsigned char* map_data = (unsigned char*)malloc(hdr.len);
+                if (map_data == NULL) {
+                    WARNLOG("Could not allocate memory for MapData chunk");
+                    break;
+                }
+                if ((LbFileRead(fhandle, map_data, hdr.len) == hdr.len) && unpack_map_storage(map_data, hdr.len)) {
+                    chunks_done |= SGF_MapData;
+                } else {
+                    WARNLOG("Could not read MapData chunk");
+                }
+                free(map_data);
+            }
             break;
         case SGC_PacketHeader:
             if (hdr.len != sizeof(struct PacketSaveHead))
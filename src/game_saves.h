@@ -44,20 +44,22 @@ enum SaveGameChunks {
      SGC_PacketHeader   = 0x52444850, //"PHDR"
      SGC_PacketData     = 0x544B4350, //"PCKT"
      SGC_IntralevelData = 0x4C564C49, //"ILVL"
-     SGC_LuaData        = 0x2041554C  //"LUA "
+     SGC_LuaData        = 0x2041554C, //"LUA "
+     SGC_MapData        = 0x4450414D  //"MAPD"
 };
 
 enum SaveGameChunkFlags {
      SGF_InfoBlock      = 0x0001,
      SGF_GameOrig       = 0x0002,
+     SGF_MapData        = 0x0004,
      SGF_PacketHeader   = 0x0100,
      SGF_PacketData     = 0x0200,
      SGF_IntralevelData = 0x0400,
      SGF_LuaData        = 0x0800,
 };
-#define SGF_SavedGame      (SGF_InfoBlock|SGF_GameOrig|SGF_IntralevelData|SGF_LuaData)
+#define SGF_SavedGame      (SGF_InfoBlock|SGF_GameOrig|SGF_MapData|SGF_IntralevelData|SGF_LuaData)
 #define SGF_PacketStart    (SGF_PacketHeader|SGF_PacketData|SGF_InfoBlock)
-#define SGF_PacketContinue (SGF_PacketHeader|SGF_PacketData|SGF_InfoBlock|SGF_GameOrig)
+#define SGF_PacketContinue (SGF_PacketHeader|SGF_PacketData|SGF_InfoBlock|SGF_GameOrig|SGF_MapData)
 
 enum GameLoadStatus {
     GLoad_Failed = 0,
@@ -44,7 +44,9 @@
 #include "map_columns.h"
 #include "map_events.h"
 #include "map_blocks.h"
+#include "creature_battle.h"
 #include "creature_control.h"
+#include "creature_senses.h"
 #include "creature_states.h"
 #include "light_data.h"
 #include "magic_powers.h"
@@ -313,6 +315,9 @@ static void process_dungeons(void)
   process_entrance_generation();
   process_payday();
   process_things_in_dungeon_hand();
+#if (BFDEBUG_LEVEL > 0)
+  check_dungeons_creature_list_counters();
+#endif
   SYNCDBG(9,"Finished");
 }
 
@@ -512,6 +517,9 @@ void update(void)
     struct PlayerInfo *player;
     SYNCDBG(4,"Starting for turn %ld",(long)get_gameturn());
 
+    // Game state might have been loaded or resynced since last turn
+    invalidate_line_of_sight_cache();
+    clear_battle_candidates();
     process_packets();
     update_local_cameras();
     api_update_server();
@@ -46,7 +46,7 @@ extern "C" {
 /******************************************************************************/
 char gui_textbuf[TEXT_BUFFER_LENGTH];
 unsigned char *gui_slab;
-unsigned char *frontend_background;
+unsigned char frontend_background[FRONTEND_BACKGROUND_SIZE];
 struct TbSpriteSheet * frontend_sprite = NULL;
 int gui_blink_rate = 1; // Number of frames before menu/map effects flash. Default value, overwritten by cfg setting.
 int neutral_flash_rate = 1; // Number of frames before neutral rooms/creatures cycle colours. Default value, overwritten by cfg setting.
@@ -38,6 +38,8 @@
 #define POS_GAMECTR  999
 #define ROUNDSLAB64K_LIGHT 0
 #define ROUNDSLAB64K_DARK 1
+/** Size of the buffer for frontend background image, 640x480 at 8bpp. */
+#define FRONTEND_BACKGROUND_SIZE (640*480)
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -48,7 +50,7 @@ struct GuiButton;
 /******************************************************************************/
 extern struct TbSpriteSheet * gui_panel_sprites;
 extern unsigned char *gui_slab;
-extern unsigned char *frontend_background;
+extern unsigned char frontend_background[FRONTEND_BACKGROUND_SIZE];
 extern struct TbSpriteSheet * frontend_sprite;
 extern int gui_blink_rate;
 extern int neutral_flash_rate;
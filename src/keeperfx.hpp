@@ -145,8 +145,11 @@ struct StartupParameters {
     unsigned char startup_flags;
 #ifdef FUNCTESTING
     unsigned char functest_flags;
-    char functest_name[FTEST_MAX_NAME_LENGTH];
+    char functest_name[CMDLN_MAXLEN+1];
     unsigned int functest_seed;
+    GameTurn functest_max_turns;
+    unsigned long functest_max_time;
+    char functest_report_fname[CMDLN_MAXLEN+1];
 #endif
 };
 
@@ -42,9 +42,6 @@ DisplacementEffect::DisplacementEffect()
     , m_algorithm(DisplaceAlgo_Sinusoidal)
     , m_magnitude(0)
     , m_period(0)
-    , m_lookup_table(nullptr)
-    , m_table_width(0)
-    , m_table_height(0)
 {
 }
 
@@ -53,37 +50,15 @@ DisplacementEffect::~DisplacementEffect()
     Cleanup();
 }
 
-void DisplacementEffect::FreeLookupTable()
-{
-    if (m_lookup_table != nullptr)
-    {
-        free(m_lookup_table);
-        m_lookup_table = nullptr;
-    }
-    m_table_width = 0;
-    m_table_height = 0;
-}
-
 /**
- * Build pre-computed lookup table for current resolution.
+ * Build pre-computed lookup table for given resolution.
  * Computes displacement in virtual 640x480 space, then maps to actual coords.
  */
-void DisplacementEffect::BuildLookupTable(long width, long height)
+void DisplacementEffect::BuildLookupTable(const LensLookupKey& key, uint32_t* offsets)
 {
-    // Free existing table if any
-    FreeLookupTable();
-    
-    // Allocate lookup table
-    size_t table_size = width * height * sizeof(DisplaceLookupEntry);
-    m_lookup_table = (DisplaceLookupEntry*)malloc(table_size);
-    if (m_lookup_table == nullptr)
-    {
-        ERRORLOG("Failed to allocate displacement lookup table (%" PRIuSIZE " bytes)", SZCAST(table_size));
-        return;
-    }
-    
-    m_table_width = width;
-    m_table_height = height;
+    const long width = key.width;
+    const long height = key.height;
+    const DisplacementAlgorithm algorithm = (DisplacementAlgorithm)key.algorithm;
     
     // Fixed-point scale factors (16.16 format)
     const unsigned int scale_x = (REF_WIDTH << 16) / width;
@@ -94,12 +69,12 @@ void DisplacementEffect::BuildLookupTable(long width, long height)
     // Pre-compute constants
     const double ref_center_x = REF_WIDTH * 0.5;
     const double ref_center_y = REF_HEIGHT * 0.5;
-    const double flmag = m_magnitude;
-    const double flperiod = m_period;
-    const double flmag_sq = m_magnitude * (double)m_magnitude;
+    const double flmag = key.magnitude;
+    const double flperiod = key.period;
+    const double flmag_sq = key.magnitude * (double)key.magnitude;
     const double fldivs = sqrt(ref_center_y * ref_center_y + ref_center_x * ref_center_x + flmag_sq);
     
-    DisplaceLookupEntry* entry = m_lookup_table;
+    uint32_t* entry = offsets;
     
     for (long y = 0; y < height; y++)
     {
@@ -113,7 +88,7 @@ void DisplacementEffect::BuildLookupTable(long width, long height)
             
             long src_virtual_x, src_virtual_y;
             
-            switch (m_algorithm)
+            switch (algorithm)
             {
             case DisplaceAlgo_Linear:
                 src_virtual_x = (virtual_x + (REF_WIDTH >> 1)) / 2;
@@ -131,8 +106,8 @@ void DisplacementEffect::BuildLookupTable(long width, long height)
                     src_virtual_x = (long)(fldist * flpos_x + ref_center_x);
                     src_virtual_y = (long)(fldist * flpos_y + ref_center_y);
                     
-                    if ((m_period & 1) == 0 && src_virtual_x < 0) src_virtual_x = 0;
-                    if ((m_period & 2) == 0 && src_virtual_y < 0) src_virtual_y = 0;
+                    if ((key.period & 1) == 0 && src_virtual_x < 0) src_virtual_x = 0;
+                    if ((key.period & 2) == 0 && src_virtual_y < 0) src_virtual_y = 0;
                 }
                 break;
                 
@@ -155,13 +130,10 @@ void DisplacementEffect::BuildLookupTable(long width, long height)
             if (actual_src_x >= width)  actual_src_x = width - 1;
             if (actual_src_y >= height) actual_src_y = height - 1;
             
-            entry->src_x = (short)actual_src_x;
-            entry->src_y = (short)actual_src_y;
+            *entry = (uint32_t)(actual_src_y * key.srcpitch + actual_src_x);
             entry++;
         }
     }
-    
-    SYNCDBG(7, "Built displacement lookup table %ldx%ld", width, height);
 }
 
 TbBool DisplacementEffect::Setup(long lens_idx)
@@ -181,8 +153,8 @@ TbBool DisplacementEffect::Setup(long lens_idx)
         return false;
     }
     
-    // Note: Lookup table built on first Draw() when we know the resolution
-    FreeLookupTable();
+    // Note: Lookup table acquired on first Draw() when we know the resolution
+    m_lookup_table.reset();
     
     m_current_lens = lens_idx;
     SYNCDBG(7, "Displacement effect ready (algo=%d, mag=%d, period=%d)",
@@ -192,43 +164,45 @@ TbBool DisplacementEffect::Setup(long lens_idx)
 
 void DisplacementEffect::Cleanup()
 {
-    FreeLookupTable();
+    m_lookup_table.reset();
     m_current_lens = -1;
 }
 
-TbBool DisplacementEffect::Draw(LensRenderContext* ctx)
+TbBool DisplacementEffect::PrepareRows(const LensRenderContext* ctx)
 {
     if (m_current_lens < 0)
     {
         return false;
     }
     
-    // Build lookup table if needed (resolution may have changed)
-    if (m_lookup_table == nullptr || 
-        m_table_width != ctx->width || 
-        m_table_height != ctx->height)
-    {
-        BuildLookupTable(ctx->width, ctx->height);
-        if (m_lookup_table == nullptr)
-        {
-            return false;
-        }
-    }
-    
-    // Fast lookup-based rendering
-    unsigned char* viewport_src = ctx->srcbuf + ctx->viewport_x;
-    unsigned char* dst = ctx->dstbuf;
-    DisplaceLookupEntry* entry = m_lookup_table;
-    
-    for (long y = 0; y < ctx->height; y++)
+    // Get lookup table for current resolution (cached between lens and resolution changes)
+    LensLookupKey key;
+    key.effect_type = (int)m_type;
+    key.algorithm = m_algorithm;
+    key.magnitude = m_magnitude;
+    key.period = m_period;
+    key.width = ctx->width;
+    key.height = ctx->height;
+    key.srcpitch = ctx->srcpitch;
+    m_lookup_table = LensLookupCache::Acquire(key, BuildLookupTable);
+    return (m_lookup_table != nullptr);
+}
+
+void DisplacementEffect::DrawRows(const LensRenderContext* ctx, const unsigned char* inbuf, long inpitch,
+                                  long y_begin, long y_end) const
+{
+    // Remapping always reads the unmodified source, the table includes its pitch
+    LensLookupCache::GatherRows(*m_lookup_table, ctx->width, ctx->dstbuf, ctx->dstpitch,
+                                ctx->srcbuf + ctx->viewport_x, y_begin, y_end);
+}
+
+TbBool DisplacementEffect::Draw(LensRenderContext* ctx)
+{
+    if (!PrepareRows(ctx))
     {
-        for (long x = 0; x < ctx->width; x++)
-        {
-            dst[x] = viewport_src[entry->src_y * ctx->srcpitch + entry->src_x];
-            entry++;
-        }
-        dst += ctx->dstpitch;
+        return false;
     }
+    DrawRows(ctx, ctx->srcbuf + ctx->viewport_x, ctx->srcpitch, 0, ctx->height);
     
     ctx->buffer_copied = true;
     return true;
@@ -20,6 +20,7 @@
 #define KFX_DISPLACEMENTEFFECT_H
 
 #include "LensEffect.h"
+#include "LensLookupTable.h"
 
 /******************************************************************************/
 
@@ -30,15 +31,6 @@ enum DisplacementAlgorithm {
     DisplaceAlgo_Compound = 3  // Compound eye - handled by FlyeyeEffect
 };
 
-/**
- * Pre-computed displacement lookup table entry.
- * Stores the source pixel offset for each destination pixel.
- */
-struct DisplaceLookupEntry {
-    short src_x;
-    short src_y;
-};
-
 class DisplacementEffect : public LensEffect {
 public:
     DisplacementEffect();
@@ -48,19 +40,21 @@ public:
     virtual void Cleanup() override;
     virtual TbBool Draw(LensRenderContext* ctx) override;
     
+    virtual TbBool PrepareRows(const LensRenderContext* ctx) override;
+    virtual TbBool RemapsRows() const override { return true; }
+    virtual void DrawRows(const LensRenderContext* ctx, const unsigned char* inbuf, long inpitch,
+                          long y_begin, long y_end) const override;
+    
 private:
-    void BuildLookupTable(long width, long height);
-    void FreeLookupTable();
+    static void BuildLookupTable(const LensLookupKey& key, uint32_t* offsets);
     
     long m_current_lens;
     DisplacementAlgorithm m_algorithm;
     int m_magnitude;
     int m_period;
     
-    // Pre-computed lookup table for current resolution
-    DisplaceLookupEntry* m_lookup_table;
-    long m_table_width;
-    long m_table_height;
+    // Pre-computed lookup table for current resolution, shared through the cache
+    LensLookupTableRef m_lookup_table;
 };
 
 /******************************************************************************/
@@ -217,9 +217,6 @@ static void RasterizeHexRef(int hex_x, int hex_y)
 FlyeyeEffect::FlyeyeEffect()
     : LensEffect(LensEffectType::Flyeye, "Flyeye")
     , m_current_lens(-1)
-    , m_lookup_table(nullptr)
-    , m_table_width(0)
-    , m_table_height(0)
 {
 }
 
@@ -228,31 +225,29 @@ FlyeyeEffect::~FlyeyeEffect()
     Cleanup();
 }
 
-void FlyeyeEffect::FreeLookupTable()
-{
-    if (m_lookup_table != nullptr)
-    {
-        free(m_lookup_table);
-        m_lookup_table = nullptr;
-    }
-    m_table_width = 0;
-    m_table_height = 0;
-}
-
 /**
  * Build lookup table:
  * 1. Rasterize hexes in reference 640x480 space
  * 2. Convert reference scanlines to screen-resolution lookup table
  */
-void FlyeyeEffect::BuildLookupTable(long width, long height)
+void FlyeyeEffect::BuildLookupTable(const LensLookupKey& key, uint32_t* offsets)
 {
-    FreeLookupTable();
+    const long width = key.width;
+    const long height = key.height;
     
     // Allocate reference scanlines
     g_ref_scanlines = (FlyeyeScanline*)malloc(REF_HEIGHT * sizeof(FlyeyeScanline));
     if (g_ref_scanlines == nullptr)
     {
         ERRORLOG("Failed to allocate flyeye reference scanlines");
+        // Leave the view unwarped rather than reading uninitialized offsets
+        for (long y = 0; y < height; y++)
+        {
+            for (long x = 0; x < width; x++)
+            {
+                offsets[y * width + x] = (uint32_t)(y * key.srcpitch + x);
+            }
+        }
         return;
     }
     
@@ -271,26 +266,12 @@ void FlyeyeEffect::BuildLookupTable(long width, long height)
         }
     }
     
-    // Allocate lookup table for actual resolution
-    size_t table_size = width * height * sizeof(FlyeyeLookupEntry);
-    m_lookup_table = (FlyeyeLookupEntry*)malloc(table_size);
-    if (m_lookup_table == nullptr)
-    {
-        ERRORLOG("Failed to allocate flyeye lookup table (%" PRIuSIZE " bytes)", SZCAST(table_size));
-        free(g_ref_scanlines);
-        g_ref_scanlines = nullptr;
-        return;
-    }
-    
-    m_table_width = width;
-    m_table_height = height;
-    
     // Scale factors
     double scale_x = (double)width / REF_WIDTH;
     double scale_y = (double)height / REF_HEIGHT;
     
     // Convert reference scanlines to screen-resolution lookup table
-    FlyeyeLookupEntry* entry = m_lookup_table;
+    uint32_t* entry = offsets;
     
     for (long y = 0; y < height; y++)
     {
@@ -340,23 +321,20 @@ void FlyeyeEffect::BuildLookupTable(long width, long height)
             if (src_x >= width) src_x = width - 1;
             if (src_y >= height) src_y = height - 1;
             
-            entry->src_x = (short)src_x;
-            entry->src_y = (short)src_y;
+            *entry = (uint32_t)(src_y * key.srcpitch + src_x);
             entry++;
         }
     }
     
     free(g_ref_scanlines);
     g_ref_scanlines = nullptr;
-    
-    SYNCDBG(7, "Built flyeye lookup table %ldx%ld", width, height);
 }
 
 TbBool FlyeyeEffect::Setup(long lens_idx)
 {
     SYNCDBG(8, "Setting up flyeye effect for lens %ld", lens_idx);
     
-    FreeLookupTable();
+    m_lookup_table.reset();
     m_current_lens = lens_idx;
     
     SYNCDBG(7, "Flyeye effect ready");
@@ -365,44 +343,47 @@ TbBool FlyeyeEffect::Setup(long lens_idx)
 
 void FlyeyeEffect::Cleanup()
 {
-    FreeLookupTable();
+    m_lookup_table.reset();
     m_current_lens = -1;
 }
 
-TbBool FlyeyeEffect::Draw(LensRenderContext* ctx)
+TbBool FlyeyeEffect::PrepareRows(const LensRenderContext* ctx)
 {
     if (m_current_lens < 0)
     {
         return false;
     }
     
-    // Build lookup table if needed
-    if (m_lookup_table == nullptr ||
-        m_table_width != ctx->width ||
-        m_table_height != ctx->height)
-    {
-        BuildLookupTable(ctx->width, ctx->height);
-        if (m_lookup_table == nullptr)
-        {
-            return false;
-        }
-    }
-    
-    // Fast lookup-based rendering
-    unsigned char* viewport_src = ctx->srcbuf + ctx->viewport_x;
-    unsigned char* dst = ctx->dstbuf;
-    FlyeyeLookupEntry* entry = m_lookup_table;
-    
-    for (long y = 0; y < ctx->height; y++)
+    // Hex tiling has no parameters, so the table only depends on frame geometry
+    LensLookupKey key;
+    key.effect_type = (int)m_type;
+    key.algorithm = 0;
+    key.magnitude = 0;
+    key.period = 0;
+    key.width = ctx->width;
+    key.height = ctx->height;
+    key.srcpitch = ctx->srcpitch;
+    m_lookup_table = LensLookupCache::Acquire(key, BuildLookupTable);
+    return (m_lookup_table != nullptr);
+}
+
+void FlyeyeEffect::DrawRows(const LensRenderContext* ctx, const unsigned char* inbuf, long inpitch,
+                            long y_begin, long y_end) const
+{
+    LensLookupCache::GatherRows(*m_lookup_table, ctx->width, ctx->dstbuf, ctx->dstpitch,
+                                ctx->srcbuf + ctx->viewport_x, y_begin, y_end);
+}
+
+TbBool FlyeyeEffect::Draw(LensRenderContext* ctx)
+{
+    if (!PrepareRows(ctx))
     {
-        for (long x = 0; x < ctx->width; x++)
-        {
-            dst[x] = viewport_src[entry->src_y * ctx->srcpitch + entry->src_x];
-            entry++;
-        }
-        dst += ctx->dstpitch;
+        return false;
     }
+    DrawRows(ctx, ctx->srcbuf + ctx->viewport_x, ctx->srcpitch, 0, ctx->height);
     
     ctx->buffer_copied = true;
     return true;
-}
\ No newline at end of file
+}
+
+/******************************************************************************/
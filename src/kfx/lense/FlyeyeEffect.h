@@ -20,17 +20,10 @@
 #define KFX_FLYEYEEFFECT_H
 
 #include "LensEffect.h"
+#include "LensLookupTable.h"
 
 /******************************************************************************/
 
-/**
- * Pre-computed flyeye lookup table entry.
- */
-struct FlyeyeLookupEntry {
-    short src_x;
-    short src_y;
-};
-
 class FlyeyeEffect : public LensEffect {
 public:
     FlyeyeEffect();
@@ -40,16 +33,18 @@ public:
     virtual void Cleanup() override;
     virtual TbBool Draw(LensRenderContext* ctx) override;
     
+    virtual TbBool PrepareRows(const LensRenderContext* ctx) override;
+    virtual TbBool RemapsRows() const override { return true; }
+    virtual void DrawRows(const LensRenderContext* ctx, const unsigned char* inbuf, long inpitch,
+                          long y_begin, long y_end) const override;
+    
 private:
-    void BuildLookupTable(long width, long height);
-    void FreeLookupTable();
+    static void BuildLookupTable(const LensLookupKey& key, uint32_t* offsets);
     
     long m_current_lens;
     
-    // Pre-computed lookup table
-    FlyeyeLookupEntry* m_lookup_table;
-    long m_table_width;
-    long m_table_height;
+    // Pre-computed lookup table, shared through the cache
+    LensLookupTableRef m_lookup_table;
 };
 
 /******************************************************************************/
@@ -64,7 +64,23 @@ public:
     virtual TbBool Setup(long lens_idx) = 0;
     virtual void Cleanup() = 0;
     virtual TbBool Draw(LensRenderContext* ctx) = 0;
-    
+
+    // Row-partitioned rendering (optional, override in derived classes).
+    // Effects supporting it are fused by LensManager into one pass over the
+    // frame, split into row ranges executed on worker threads.
+    // PrepareRows() is called on the main thread before the pass; returning
+    // false makes the manager fall back to Draw().
+    virtual TbBool PrepareRows(const LensRenderContext* ctx) { return false; }
+    // Remapping effects read pixels from other rows, so they must be the first
+    // stage and read the source buffer; other stages process pixels in place.
+    virtual TbBool RemapsRows() const { return false; }
+    // Processes rows [y_begin,y_end) from inbuf into ctx->dstbuf. Called
+    // concurrently for different row ranges, so must not modify the effect.
+    virtual void DrawRows(const LensRenderContext* ctx, const unsigned char* inbuf, long inpitch,
+                          long y_begin, long y_end) const {}
+    // Called on the main thread after the whole frame was processed.
+    virtual void FinishRows() {}
+
     // Configuration
     void SetEnabled(TbBool enabled) { m_enabled = enabled; }
     TbBool IsEnabled() const { return m_enabled; }
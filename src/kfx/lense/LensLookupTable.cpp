@@ -0,0 +1,114 @@
+/******************************************************************************/
+// Free implementation of Bullfrog's Dungeon Keeper strategy game.
+/******************************************************************************/
+/** @file LensLookupTable.cpp
+ *     Cache of pixel remapping tables for lens effects.
+ * @par Purpose:
+ *     Keeps pre-computed source offset tables of warping lens effects.
+ * @par Comment:
+ *     Cache is only accessed from the rendering thread; workers only
+ *     read the tables through references taken before the job starts.
+ * @author   KeeperFX Team
+ * @date     19 Oct 2026
+ * @par  Copying and copyrights:
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ */
+/******************************************************************************/
+#include "../../pre_inc.h"
+#include "LensLookupTable.h"
+
+#include <list>
+#include <new>
+#include <utility>
+
+#include "../../keeperfx.hpp"
+#include "../../post_inc.h"
+
+/******************************************************************************/
+
+namespace {
+
+typedef std::pair<LensLookupKey, LensLookupTableRef> LensLookupCacheEntry;
+
+// Most recently used entry is first
+std::list<LensLookupCacheEntry> lookup_cache;
+
+}
+
+bool LensLookupKey::operator==(const LensLookupKey& other) const
+{
+    return (effect_type == other.effect_type) && (algorithm == other.algorithm) &&
+        (magnitude == other.magnitude) && (period == other.period) &&
+        (width == other.width) && (height == other.height) && (srcpitch == other.srcpitch);
+}
+
+LensLookupTableRef LensLookupCache::Acquire(const LensLookupKey& key, LensLookupBuilder builder)
+{
+    for (auto it = lookup_cache.begin(); it != lookup_cache.end(); ++it)
+    {
+        if (it->first == key)
+        {
+            lookup_cache.splice(lookup_cache.begin(), lookup_cache, it);
+            return lookup_cache.front().second;
+        }
+    }
+    if ((key.width <= 0) || (key.height <= 0) || (key.srcpitch < key.width))
+    {
+        return LensLookupTableRef();
+    }
+    std::shared_ptr<LensLookupTable> table;
+    size_t table_len = (size_t)key.width * key.height;
+    try {
+        table = std::make_shared<LensLookupTable>(table_len);
+    } catch (const std::bad_alloc&) {
+        ERRORLOG("Failed to allocate lens lookup table (%" PRIuSIZE " bytes)", SZCAST(table_len * sizeof(uint32_t)));
+        return LensLookupTableRef();
+    }
+    builder(key, table->data());
+    lookup_cache.emplace_front(key, table);
+    while (lookup_cache.size() > LENS_LOOKUP_CACHE_SIZE)
+    {
+        lookup_cache.pop_back();
+    }
+    SYNCDBG(7, "Built lens lookup table %ldx%ld for effect %d", key.width, key.height, key.effect_type);
+    return table;
+}
+
+void LensLookupCache::Clear()
+{
+    lookup_cache.clear();
+}
+
+void LensLookupCache::GatherRows(const LensLookupTable& table, long width,
+                                 unsigned char* dstbuf, long dstpitch, const unsigned char* srcbuf,
+                                 long y_begin, long y_end)
+{
+    const uint32_t* offs = table.data() + y_begin * width;
+    unsigned char* dst = dstbuf + y_begin * dstpitch;
+    for (long y = y_begin; y < y_end; y++)
+    {
+        long x = 0;
+        for (; x + 4 <= width; x += 4)
+        {
+            unsigned char p0 = srcbuf[offs[x + 0]];
+            unsigned char p1 = srcbuf[offs[x + 1]];
+            unsigned char p2 = srcbuf[offs[x + 2]];
+            unsigned char p3 = srcbuf[offs[x + 3]];
+            dst[x + 0] = p0;
+            dst[x + 1] = p1;
+            dst[x + 2] = p2;
+            dst[x + 3] = p3;
+        }
+        for (; x < width; x++)
+        {
+            dst[x] = srcbuf[offs[x]];
+        }
+        offs += width;
+        dst += dstpitch;
+    }
+}
+
+/******************************************************************************/
@@ -0,0 +1,72 @@
+/******************************************************************************/
+// Free implementation of Bullfrog's Dungeon Keeper strategy game.
+/******************************************************************************/
+/** @file LensLookupTable.h
+ *     Cache of pixel remapping tables for lens effects.
+ * @par Purpose:
+ *     Keeps pre-computed source offset tables of warping lens effects,
+ *     so that they are not rebuilt when switching lenses or resolutions.
+ * @par Comment:
+ *     Tables store one source offset per destination pixel, already
+ *     multiplied by source pitch, so drawing is a plain gather.
+ * @author   KeeperFX Team
+ * @date     19 Oct 2026
+ * @par  Copying and copyrights:
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ */
+/******************************************************************************/
+#ifndef KFX_LENSLOOKUPTABLE_H
+#define KFX_LENSLOOKUPTABLE_H
+
+#include "../../bflib_basics.h"
+#include <memory>
+#include <vector>
+
+/******************************************************************************/
+
+/** Amount of tables kept in the cache; least recently used one is dropped first. */
+#define LENS_LOOKUP_CACHE_SIZE 4
+
+/**
+ * Identifies a lookup table - the effect, its parameters and the frame geometry.
+ */
+struct LensLookupKey {
+    int effect_type;   // LensEffectType of the owning effect
+    int algorithm;
+    int magnitude;
+    int period;
+    long width;
+    long height;
+    long srcpitch;
+
+    bool operator==(const LensLookupKey& other) const;
+};
+
+/** Source pixel offsets (src_y * srcpitch + src_x), one per destination pixel, row by row. */
+typedef std::vector<uint32_t> LensLookupTable;
+typedef std::shared_ptr<const LensLookupTable> LensLookupTableRef;
+
+/** Fills width*height offsets for given key. */
+typedef void (*LensLookupBuilder)(const LensLookupKey& key, uint32_t* offsets);
+
+class LensLookupCache {
+public:
+    /** Returns cached table for the key, building it on a miss. Returns empty ref on failure. */
+    static LensLookupTableRef Acquire(const LensLookupKey& key, LensLookupBuilder builder);
+    /** Drops all tables; effects holding a reference keep their copy alive. */
+    static void Clear();
+
+    /**
+     * Copies rows [y_begin,y_end) from src to dst through the table.
+     * Loop is unrolled so that independent loads may be issued together.
+     */
+    static void GatherRows(const LensLookupTable& table, long width,
+                           unsigned char* dstbuf, long dstpitch, const unsigned char* srcbuf,
+                           long y_begin, long y_end);
+};
+
+/******************************************************************************/
+#endif
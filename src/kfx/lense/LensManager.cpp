@@ -26,6 +26,9 @@
 #include "OverlayEffect.h"
 #include "PaletteEffect.h"
 #include "LuaLensEffect.h"
+#include "LensLookupTable.h"
+
+#include <atomic>
 
 #include "../../globals.h"
 #include "../../config_lenses.h"
@@ -33,12 +36,63 @@
 #include "../../lens_api.h"
 #include "../../vidmode.h"
 #include "../../game_legacy.h"
+#include "../../bflib_datetm.h"
+#include "../../bflib_workers.h"
 
 #include "../../keeperfx.hpp"
 #include "../../post_inc.h"
 
 /******************************************************************************/
 
+/** Rows processed by all fused stages before moving on; keeps the rows in cache between stages. */
+#define LENS_ROWS_PER_STRIP 16
+/** Maximal amount of stages fused into one pass. */
+#define LENS_FUSED_STAGES_MAX 4
+
+/**
+ * Fused lens pass, shared by all worker threads.
+ */
+struct LensFusedPass {
+    const LensRenderContext* ctx;
+    LensEffect* stages[LENS_FUSED_STAGES_MAX];
+    int stages_count;
+    std::atomic<int64_t> stage_time_ns[LENS_FUSED_STAGES_MAX];
+};
+
+/**
+ * Worker job - runs all fused stages over a range of row strips.
+ * First stage reads the source buffer, next ones process destination rows in place.
+ */
+static void lens_fused_pass_rows(void* data, long strip_begin, long strip_end)
+{
+    LensFusedPass* pass = static_cast<LensFusedPass*>(data);
+    const LensRenderContext* ctx = pass->ctx;
+    int64_t stage_time[LENS_FUSED_STAGES_MAX] = {0};
+    for (long strip = strip_begin; strip < strip_end; strip++)
+    {
+        long y_begin = strip * LENS_ROWS_PER_STRIP;
+        long y_end = y_begin + LENS_ROWS_PER_STRIP;
+        if (y_end > ctx->height)
+            y_end = ctx->height;
+        for (int i = 0; i < pass->stages_count; i++)
+        {
+            int64_t start_ns = get_time_tick_ns();
+            if (i == 0) {
+                pass->stages[i]->DrawRows(ctx, ctx->srcbuf + ctx->viewport_x, ctx->srcpitch, y_begin, y_end);
+            } else {
+                pass->stages[i]->DrawRows(ctx, ctx->dstbuf, ctx->dstpitch, y_begin, y_end);
+            }
+            stage_time[i] += get_time_tick_ns() - start_ns;
+        }
+    }
+    for (int i = 0; i < pass->stages_count; i++)
+    {
+        pass->stage_time_ns[i].fetch_add(stage_time[i]);
+    }
+}
+
+/******************************************************************************/
+
 LensManager* LensManager::s_instance = nullptr;
 
 LensManager* LensManager::GetInstance()
@@ -122,6 +176,10 @@ void LensManager::Reset()
     // Free buffers
     FreeBuffers();
     
+    // Lookup tables depend on screen geometry, which may change before next Init()
+    LensLookupCache::Clear();
+    m_timings.clear();
+    
     // Reset state
     m_active_lens = 0;
     m_applied_lens = 0;
@@ -237,35 +295,137 @@ void LensManager::Draw(unsigned char* srcbuf, unsigned char* dstbuf,
     if (!m_initialized || (m_applied_lens == 0 && m_active_custom_lens.empty())) {
         unsigned char* viewport_src = srcbuf + viewport_x;
         CopyBuffer(dstbuf, dstpitch, viewport_src, srcpitch, width, height);
+        m_timings.clear();
         return;
     }
     
+    int64_t draw_start_ns = get_time_tick_ns();
+    m_frame_timings.clear();
+    
     // Check if a custom lens is active
     if (!m_active_custom_lens.empty()) {
         LensEffect* custom_effect = GetCustomLens(m_active_custom_lens.c_str());
         if (custom_effect != nullptr && custom_effect->IsEnabled()) {
             if (custom_effect->Draw(&ctx)) {
+                AddEffectTiming(custom_effect->GetName(), get_time_tick_ns() - draw_start_ns);
+                AddEffectTiming("Lens", get_time_tick_ns() - draw_start_ns);
+                UpdateTimings();
                 return;  // Custom lens rendered successfully
             }
         }
         // Custom lens failed, fall through to standard effects or fallback
     }
     
-    // Apply standard effects in order
-    TbBool rendered = false;
-    for (LensEffect* effect : m_effects) {
-        if (effect->IsEnabled()) {
-            if (effect->Draw(&ctx)) {
-                rendered = true;
-            }
-        }
-    }
+    // Apply standard effects; row capable ones are fused into one parallel pass
+    TbBool rendered = DrawFused(&ctx);
     
     // If no effects rendered (all failed or none applicable), copy as fallback
     if (!rendered) {
         unsigned char* viewport_src = srcbuf + viewport_x;
         CopyBuffer(dstbuf, dstpitch, viewport_src, srcpitch, width, height);
     }
+    AddEffectTiming("Lens", get_time_tick_ns() - draw_start_ns);
+    UpdateTimings();
+}
+
+/**
+ * Draws enabled standard effects. Effects supporting row rendering are chained
+ * into a single pass over the frame, executed in row strips on worker threads:
+ * the remapping effect (displacement or flyeye) reads the source, then mist and
+ * overlay are applied in place to the remapped rows. Other effects use Draw().
+ * Unlike separate Draw() calls, where each effect overwrote the output of the
+ * previous one, the effects are layered: mist and overlay cover the warped view.
+ */
+TbBool LensManager::DrawFused(LensRenderContext* ctx)
+{
+    LensFusedPass pass;
+    int64_t prepare_ns[LENS_FUSED_STAGES_MAX];
+    pass.ctx = ctx;
+    pass.stages_count = 0;
+    TbBool rendered = false;
+    for (LensEffect* effect : m_effects) {
+        if (!effect->IsEnabled()) {
+            continue;
+        }
+        int64_t start_ns = get_time_tick_ns();
+        if ((pass.stages_count < LENS_FUSED_STAGES_MAX) && effect->PrepareRows(ctx)) {
+            int n = pass.stages_count;
+            if (effect->RemapsRows()) {
+                // Displacement and flyeye are mutually exclusive in lens config, so there's one remapper at most
+                if ((n > 0) && pass.stages[0]->RemapsRows()) {
+                    SYNCDBG(8, "Effect '%s' skipped, '%s' already remaps the view", effect->GetName(), pass.stages[0]->GetName());
+                    continue;
+                }
+                for (; n > 0; n--) {
+                    pass.stages[n] = pass.stages[n - 1];
+                    prepare_ns[n] = prepare_ns[n - 1];
+                }
+            }
+            pass.stages[n] = effect;
+            prepare_ns[n] = get_time_tick_ns() - start_ns;
+            pass.stages_count++;
+            continue;
+        }
+        if (effect->Draw(ctx)) {
+            rendered = true;
+            AddEffectTiming(effect->GetName(), get_time_tick_ns() - start_ns);
+        }
+    }
+    if (pass.stages_count == 0) {
+        return rendered;
+    }
+    for (int i = 0; i < pass.stages_count; i++) {
+        pass.stage_time_ns[i] = prepare_ns[i];
+    }
+    long strips_count = (ctx->height + LENS_ROWS_PER_STRIP - 1) / LENS_ROWS_PER_STRIP;
+    LbWorkersParallelFor(strips_count, 1, lens_fused_pass_rows, &pass);
+    for (int i = 0; i < pass.stages_count; i++) {
+        int64_t start_ns = get_time_tick_ns();
+        pass.stages[i]->FinishRows();
+        AddEffectTiming(pass.stages[i]->GetName(), pass.stage_time_ns[i].load() + get_time_tick_ns() - start_ns);
+    }
+    ctx->buffer_copied = true;
+    return true;
+}
+
+void LensManager::AddEffectTiming(const char* name, int64_t time_ns)
+{
+    LensEffectTiming timing;
+    timing.name = name;
+    timing.time_ns = time_ns;
+    m_frame_timings.push_back(timing);
+}
+
+/**
+ * Moves timings of the current frame into smoothed timings.
+ * Smoothing keeps the numbers readable; they're reset when the set of effects changes.
+ */
+void LensManager::UpdateTimings()
+{
+    TbBool same_effects = (m_timings.size() == m_frame_timings.size());
+    for (size_t i = 0; same_effects && (i < m_timings.size()); i++) {
+        same_effects = (m_timings[i].name == m_frame_timings[i].name);
+    }
+    if (!same_effects) {
+        m_timings = m_frame_timings;
+        return;
+    }
+    for (size_t i = 0; i < m_timings.size(); i++) {
+        m_timings[i].time_ns = (m_timings[i].time_ns * 7 + m_frame_timings[i].time_ns) / 8;
+    }
+}
+
+int LensManager::GetEffectTimings(struct LensEffectTiming* timings, int max_timings) const
+{
+    int count = 0;
+    for (const LensEffectTiming& timing : m_timings) {
+        if (count >= max_timings) {
+            break;
+        }
+        timings[count] = timing;
+        count++;
+    }
+    return count;
 }
 
 void LensManager::LoadAccessibilityConfig()
@@ -535,6 +695,12 @@ TbBool LensManager_IsReady(void* mgr)
     return static_cast<LensManager*>(mgr)->IsReady();
 }
 
+int LensManager_GetEffectTimings(void* mgr, struct LensEffectTiming* timings, int max_timings)
+{
+    if (mgr == nullptr || timings == nullptr) return 0;
+    return static_cast<LensManager*>(mgr)->GetEffectTimings(timings, max_timings);
+}
+
 void LensManager_Draw(void* mgr, unsigned char* srcbuf, unsigned char* dstbuf,
                       long srcpitch, long dstpitch, long width, long height, long viewport_x)
 {
@@ -21,6 +21,7 @@
 
 #include "../../bflib_basics.h"
 #include "LensEffect.h"
+#include "../../lens_api.h"
 #include <vector>
 #include <map>
 #include <string>
@@ -89,6 +90,9 @@ public:
     // State query
     TbBool IsReady() const { return m_initialized; }
     
+    // Cost of effects drawn in recent frames; last entry is the whole lens pass
+    int GetEffectTimings(struct LensEffectTiming* timings, int max_timings) const;
+    
     // Helper: Copy buffer with pitch
     static void CopyBuffer(unsigned char *dst, long dstpitch,
                           unsigned char *src, long srcpitch,
@@ -109,6 +113,9 @@ private:
     void FreeAllEffects();
     TbBool AllocateBuffers();
     void FreeBuffers();
+    TbBool DrawFused(LensRenderContext* ctx);
+    void AddEffectTiming(const char* name, int64_t time_ns);
+    void UpdateTimings();
     
     // Singleton instance
     static LensManager* s_instance;
@@ -133,6 +140,10 @@ private:
     
     // Configuration
     LensAccessibilityConfig m_config;
+    
+    // Effect timings; current frame is accumulated in m_frame_timings
+    std::vector<LensEffectTiming> m_timings;
+    std::vector<LensEffectTiming> m_frame_timings;
 };
 
 /******************************************************************************/
@@ -48,9 +48,10 @@ public:
                unsigned char pos_x_step, unsigned char pos_y_step,
                unsigned char sec_x_step, unsigned char sec_y_step);
     void SetAnimation(long counter, long speed);
+    TbBool IsReady() const { return (lens_data != NULL) && (fade_data != NULL); }
     void Render(unsigned char *dstbuf, long dstpitch, 
-               unsigned char *srcbuf, long srcpitch,
-               long width, long height);
+               const unsigned char *srcbuf, long srcpitch,
+               long width, long height, long y_begin, long y_end) const;
     void Animate();
     
 private:
@@ -115,16 +116,15 @@ void CMistFade::Animate()
     this->secondary_offset_y += this->secondary_y_step;
 }
 
+/**
+ * Renders rows [y_begin,y_end) of the mist; srcbuf and dstbuf point at row 0.
+ * Source and destination may be the same buffer.
+ */
 void CMistFade::Render(unsigned char *dstbuf, long dstpitch,
-                      unsigned char *srcbuf, long srcpitch,
-                      long width, long height)
+                      const unsigned char *srcbuf, long srcpitch,
+                      long width, long height, long y_begin, long y_end) const
 {
-    if ((lens_data == NULL) || (fade_data == NULL))
-    {
-        ERRORLOG("Can't draw Mist as it's not initialized!");
-        return;
-    }
-    
+
     // Reference dimensions for resolution-independent scaling
     // The mist pattern will appear identical to 640x480 at any resolution
     static const int REF_WIDTH = 640;
@@ -141,10 +141,10 @@ void CMistFade::Render(unsigned char *dstbuf, long dstpitch,
     const int sec_x = this->secondary_offset_x;
     const int sec_y = this->secondary_offset_y;
     
-    unsigned char *src = srcbuf;
-    unsigned char *dst = dstbuf;
+    const unsigned char *src = srcbuf + y_begin * srcpitch;
+    unsigned char *dst = dstbuf + y_begin * dstpitch;
     
-    for (long y = 0; y < height; y++)
+    for (long y = y_begin; y < y_end; y++)
     {
         // Virtual Y coordinate in 640x480 space
         int virtual_y = (y * scale_y) >> 16;
@@ -259,25 +259,45 @@ void MistEffect::Cleanup()
     }
 }
 
-TbBool MistEffect::Draw(LensRenderContext* ctx)
+TbBool MistEffect::PrepareRows(const LensRenderContext* ctx)
 {
     if (m_current_lens < 0 || m_user_data == NULL)
     {
         return false;
     }
+    if (!static_cast<CMistFade*>(m_user_data)->IsReady())
+    {
+        ERRORLOG("Can't draw Mist as it's not initialized!");
+        return false;
+    }
+    return true;
+}
+
+void MistEffect::DrawRows(const LensRenderContext* ctx, const unsigned char* inbuf, long inpitch,
+                          long y_begin, long y_end) const
+{
+    const CMistFade* renderer = static_cast<const CMistFade*>(m_user_data);
+    renderer->Render(ctx->dstbuf, ctx->dstpitch, inbuf, inpitch,
+                    ctx->width, ctx->height, y_begin, y_end);
+}
+
+void MistEffect::FinishRows()
+{
+    static_cast<CMistFade*>(m_user_data)->Animate();
+}
+
+TbBool MistEffect::Draw(LensRenderContext* ctx)
+{
+    if (!PrepareRows(ctx))
+    {
+        return false;
+    }
     
     SYNCDBG(16, "Drawing mist effect");
     
-    // Get the mist renderer
-    CMistFade* renderer = static_cast<CMistFade*>(m_user_data);
-    
     // Mist reads from viewport-aligned source
-    unsigned char* viewport_src = ctx->srcbuf + ctx->viewport_x;
-    
-    // Render mist effect
-    renderer->Render(ctx->dstbuf, ctx->dstpitch, viewport_src, ctx->srcpitch,
-                    ctx->width, ctx->height);
-    renderer->Animate();
+    DrawRows(ctx, ctx->srcbuf + ctx->viewport_x, ctx->srcpitch, 0, ctx->height);
+    FinishRows();
     
     ctx->buffer_copied = true;  // Mist writes to dstbuf
     return true;
@@ -44,8 +44,9 @@ public:
     ~COverlayRenderer();
     
     TbBool LoadOverlay(long lens_idx);
-    void Render(unsigned char *dstbuf, long dstpitch, unsigned char *srcbuf, long srcpitch, 
-                long width, long height);
+    TbBool IsLoaded() const { return m_loaded && (m_overlay_data != NULL); }
+    void Render(unsigned char *dstbuf, long dstpitch, const unsigned char *srcbuf, long srcpitch, 
+                long width, long height, long y_begin, long y_end) const;
     
 private:
     OverlayEffect* m_parent;         // Parent effect for asset loading
@@ -157,10 +158,13 @@ TbBool COverlayRenderer::LoadOverlay(long lens_idx)
     return true;
 }
 
-void COverlayRenderer::Render(unsigned char *dstbuf, long dstpitch, unsigned char *srcbuf, long srcpitch,
-                              long width, long height)
+/**
+ * Composites rows [y_begin,y_end); srcbuf and dstbuf point at row 0 and may be the same buffer.
+ */
+void COverlayRenderer::Render(unsigned char *dstbuf, long dstpitch, const unsigned char *srcbuf, long srcpitch,
+                              long width, long height, long y_begin, long y_end) const
 {
-    if (!m_loaded || m_overlay_data == NULL)
+    if (!IsLoaded())
     {
         return;
     }
@@ -182,7 +186,7 @@ void COverlayRenderer::Render(unsigned char *dstbuf, long dstpitch, unsigned cha
     int inv_alpha = 256 - alpha_clamped;
     
     // Composite overlay onto destination buffer with stretch-to-fit
-    for (int y = 0; y < height; y++)
+    for (long y = y_begin; y < y_end; y++)
     {
         // Calculate overlay Y coordinate using fixed-point
         int overlay_y = (y * scale_y) >> 16;
@@ -286,6 +290,23 @@ void OverlayEffect::Cleanup()
     }
 }
 
+TbBool OverlayEffect::PrepareRows(const LensRenderContext* ctx)
+{
+    if (m_current_lens < 0 || m_user_data == NULL)
+    {
+        return false;
+    }
+    return static_cast<COverlayRenderer*>(m_user_data)->IsLoaded();
+}
+
+void OverlayEffect::DrawRows(const LensRenderContext* ctx, const unsigned char* inbuf, long inpitch,
+                             long y_begin, long y_end) const
+{
+    const COverlayRenderer* renderer = static_cast<const COverlayRenderer*>(m_user_data);
+    renderer->Render(ctx->dstbuf, ctx->dstpitch, inbuf, inpitch,
+                    ctx->width, ctx->height, y_begin, y_end);
+}
+
 TbBool OverlayEffect::Draw(LensRenderContext* ctx)
 {
     if (m_current_lens < 0 || m_user_data == NULL)
@@ -295,12 +316,8 @@ TbBool OverlayEffect::Draw(LensRenderContext* ctx)
     
     SYNCDBG(16, "Drawing overlay effect");
     
-    COverlayRenderer* renderer = static_cast<COverlayRenderer*>(m_user_data);
-    
     // Overlay reads from source (3D view) and composites with overlay sprite to destination
-    unsigned char* viewport_src = ctx->srcbuf + ctx->viewport_x;
-    renderer->Render(ctx->dstbuf, ctx->dstpitch, viewport_src, ctx->srcpitch,
-                    ctx->width, ctx->height);
+    DrawRows(ctx, ctx->srcbuf + ctx->viewport_x, ctx->srcpitch, 0, ctx->height);
     
     ctx->buffer_copied = true;  // We wrote the full frame to dstbuf
     return true;
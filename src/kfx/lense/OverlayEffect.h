@@ -30,6 +30,10 @@ public:
     virtual void Cleanup() override;
     virtual TbBool Draw(LensRenderContext* ctx) override;
     
+    virtual TbBool PrepareRows(const LensRenderContext* ctx) override;
+    virtual void DrawRows(const LensRenderContext* ctx, const unsigned char* inbuf, long inpitch,
+                          long y_begin, long y_end) const override;
+    
 private:
     long m_current_lens;
 };
@@ -65,6 +65,13 @@ void LensManager_CopyBuffer(unsigned char* dstbuf, long dstpitch,
                            unsigned char* srcbuf, long srcpitch,
                            long width, long height);
 
+/** Per-effect cost of drawing the lens, for the frametime display. */
+struct LensEffectTiming {
+    const char *name;
+    int64_t time_ns;  // CPU time summed over all rendering threads, smoothed over frames
+};
+int LensManager_GetEffectTimings(void* mgr, struct LensEffectTiming* timings, int max_timings);
+
 // Custom lens registration (for LUA integration)
 TbBool LensManager_RegisterCustomLens(void* mgr, const char* name, void* effect);
 void* LensManager_GetCustomLens(void* mgr, const char* name);
@@ -50,8 +50,113 @@ static long light_rendered_dynamic_lights;
 static long light_rendered_optimised_dynamic_lights;
 static long light_updated_stat_lights;
 static long light_out_of_date_stat_lights;
+
+/** Largest value of light range, which is limited by lighting tables. */
+#define LIGHT_RANGE_LIMIT 31
+/** First light in each light grid cell. */
+static unsigned short light_grid_first[LIGHT_GRID_CELLS_X*LIGHT_GRID_CELLS_Y];
+static unsigned short light_grid_next[LIGHTS_COUNT];
+static unsigned short light_grid_prev[LIGHTS_COUNT];
+/** Grid cell of each light increased by one, or zero if the light isn't in the grid. */
+static unsigned short light_grid_cell[LIGHTS_COUNT];
 /******************************************************************************/
 
+static void light_grid_remove(long lgt_idx)
+{
+    if ((lgt_idx <= 0) || (lgt_idx >= LIGHTS_COUNT) || (light_grid_cell[lgt_idx] == 0))
+        return;
+    unsigned short prev_idx = light_grid_prev[lgt_idx];
+    unsigned short next_idx = light_grid_next[lgt_idx];
+    if (prev_idx != 0)
+        light_grid_next[prev_idx] = next_idx;
+    else
+        light_grid_first[light_grid_cell[lgt_idx] - 1] = next_idx;
+    if (next_idx != 0)
+        light_grid_prev[next_idx] = prev_idx;
+    light_grid_next[lgt_idx] = 0;
+    light_grid_prev[lgt_idx] = 0;
+    light_grid_cell[lgt_idx] = 0;
+}
+
+/**
+ * Puts the light into grid cell matching its position.
+ * Needs to be called whenever position of an allocated light is set.
+ */
+static void light_grid_place(const struct Light *lgt)
+{
+    long lgt_idx = lgt->index;
+    if ((lgt_idx <= 0) || (lgt_idx >= LIGHTS_COUNT))
+        return;
+    int cell_x = min(lgt->mappos.x.stl.num, MAX_SUBTILES_X) / LIGHT_GRID_CELL_SUBTILES;
+    int cell_y = min(lgt->mappos.y.stl.num, MAX_SUBTILES_Y) / LIGHT_GRID_CELL_SUBTILES;
+    int cell_num = cell_y * LIGHT_GRID_CELLS_X + cell_x;
+    if (light_grid_cell[lgt_idx] == cell_num + 1)
+        return;
+    light_grid_remove(lgt_idx);
+    light_grid_next[lgt_idx] = light_grid_first[cell_num];
+    light_grid_prev[lgt_idx] = 0;
+    if (light_grid_first[cell_num] != 0)
+        light_grid_prev[light_grid_first[cell_num]] = lgt_idx;
+    light_grid_first[cell_num] = lgt_idx;
+    light_grid_cell[lgt_idx] = cell_num + 1;
+}
+
+/**
+ * Fills light grid from scratch; to be used when lights were replaced without creating them, ie. on game load.
+ */
+void light_grid_rebuild(void)
+{
+    memset(light_grid_first, 0, sizeof(light_grid_first));
+    memset(light_grid_next, 0, sizeof(light_grid_next));
+    memset(light_grid_prev, 0, sizeof(light_grid_prev));
+    memset(light_grid_cell, 0, sizeof(light_grid_cell));
+    for (long i = 1; i < LIGHTS_COUNT; i++)
+    {
+        struct Light* lgt = &game.lish.lights[i];
+        if ((lgt->flags & LgtF_Allocated) != 0) {
+            light_grid_place(lgt);
+        }
+    }
+}
+
+void light_grid_iterate_start(struct LightGridIterator *iter, MapSubtlCoord sx, MapSubtlCoord sy, MapSubtlCoord ex, MapSubtlCoord ey)
+{
+    iter->cell_x_beg = max(sx, 0) / LIGHT_GRID_CELL_SUBTILES;
+    iter->cell_x_end = min(ex, MAX_SUBTILES_X) / LIGHT_GRID_CELL_SUBTILES;
+    iter->cell_y_end = min(ey, MAX_SUBTILES_Y) / LIGHT_GRID_CELL_SUBTILES;
+    iter->cell_x = iter->cell_x_beg;
+    iter->cell_y = max(sy, 0) / LIGHT_GRID_CELL_SUBTILES;
+    iter->next_idx = 0;
+    if ((iter->cell_x <= iter->cell_x_end) && (iter->cell_y <= iter->cell_y_end)) {
+        iter->next_idx = light_grid_first[iter->cell_y * LIGHT_GRID_CELLS_X + iter->cell_x];
+    }
+}
+
+/**
+ * Returns next light from the iterated cells, or NULL if there are no more.
+ * Lights are returned by cells, so the caller still needs to check their exact position.
+ */
+struct Light *light_grid_iterate_next(struct LightGridIterator *iter)
+{
+    while (iter->next_idx == 0)
+    {
+        if (iter->cell_y > iter->cell_y_end)
+            return NULL;
+        iter->cell_x++;
+        if (iter->cell_x > iter->cell_x_end)
+        {
+            iter->cell_x = iter->cell_x_beg;
+            iter->cell_y++;
+            if (iter->cell_y > iter->cell_y_end)
+                return NULL;
+        }
+        iter->next_idx = light_grid_first[iter->cell_y * LIGHT_GRID_CELLS_X + iter->cell_x];
+    }
+    struct Light* lgt = &game.lish.lights[iter->next_idx];
+    iter->next_idx = light_grid_next[iter->next_idx];
+    return lgt;
+}
+
 struct Light *light_allocate_light(void)
 {
     for (long i = 1; i < LIGHTS_COUNT; i++)
@@ -83,6 +188,7 @@ int light_count_lights()
 
 void light_free_light(struct Light *lgt)
 {
+    light_grid_remove(lgt->index);
     memset(lgt, 0, sizeof(struct Light));
 }
 
@@ -182,6 +288,7 @@ long light_create_light(struct InitLight *ilght)
 
     set_flag_value(lgt->flags, LgtF_Dynamic, ilght->is_dynamic);
     lgt->attached_slb = ilght->attached_slb;
+    light_grid_place(lgt);
     return lgt->index;
 }
 
@@ -222,6 +329,7 @@ TbBool light_create_light_adv(VALUE *init_data)
     lgt->attached_slb = value_uint32(value_dict_get(init_data, "ParentTile"));
     lgt->reset_interpolation = true;
     lgt->last_turn_moved = 0;
+    light_grid_place(lgt);
 
     /*
      * TODO: not implemented yet
@@ -256,6 +364,7 @@ void light_import_system_state(const struct LightSystemState *lightst)
     light_rendered_optimised_dynamic_lights = lightst->rendered_optimised_dynamic_lights;
     light_updated_stat_lights = lightst->updated_stat_lights;
     light_out_of_date_stat_lights = lightst->out_of_date_stat_lights;
+    light_grid_rebuild();
 }
 
 TbBool lights_stats_debug_dump(void)
@@ -444,6 +553,7 @@ void light_set_light_position(long lgt_id, struct Coord3d *pos)
     lgt->mappos.y.val = pos->y.val;
     lgt->mappos.z.val = pos->z.val;
     lgt->flags |= LgtF_NeedUpdate;
+    light_grid_place(lgt);
   }
 }
 
@@ -500,8 +610,10 @@ void light_remove_light_from_list(struct Light *lgt, struct StructureList *list)
 void light_signal_stat_light_update_in_area(long x1, long y1, long x2, long y2)
 {
   int i = 0;
-  struct Light *lgt = &game.lish.lights[1];
-  do
+  struct LightGridIterator iter;
+  light_grid_iterate_start(&iter, x1 - LIGHT_RANGE_LIMIT, y1 - LIGHT_RANGE_LIMIT, x2 + LIGHT_RANGE_LIMIT, y2 + LIGHT_RANGE_LIMIT);
+  struct Light *lgt;
+  while ( (lgt = light_grid_iterate_next(&iter)) != NULL )
   {
     if ( lgt->flags & LgtF_Allocated )
     {
@@ -519,17 +631,17 @@ void light_signal_stat_light_update_in_area(long x1, long y1, long x2, long y2)
         }
       }
     }
-    lgt++;
   }
-  while ( lgt < (struct Light *)game.lish.shadow_cache );
   if ( i )
     light_stat_light_map_clear_area(x1, y1, x2, y2);
 }
 
 void light_signal_update_in_area(long sx, long sy, long ex, long ey)
 {
-  struct Light *lgt = &game.lish.lights[1];
-  do
+  struct LightGridIterator iter;
+  light_grid_iterate_start(&iter, sx - LIGHT_RANGE_LIMIT, sy - LIGHT_RANGE_LIMIT, ex + LIGHT_RANGE_LIMIT, ey + LIGHT_RANGE_LIMIT);
+  struct Light *lgt;
+  while ( (lgt = light_grid_iterate_next(&iter)) != NULL )
   {
     if ( lgt->flags & LgtF_Allocated )
     {
@@ -542,9 +654,7 @@ void light_signal_update_in_area(long sx, long sy, long ex, long ey)
           lgt->flags |= LgtF_NeedUpdate;
       }
     }
-    lgt++;
   }
-  while ( lgt < (struct Light *)game.lish.shadow_cache );
   light_signal_stat_light_update_in_area(sx, sy, ex, ey);
 }
 
@@ -2147,13 +2257,17 @@ static void light_render_area(MapSubtlCoord startx, MapSubtlCoord starty, MapSub
   half_width_y = (endy - starty) / 2 + 1;
 
 
-  // this block applies to static lights
+  struct LightGridIterator iter;
+
+  // this block applies to static lights; the area test used below reaches two subtiles past the area end
   if ( game.lish.light_enabled )
   {
-    for ( lgt = &game.lish.lights[game.thing_lists[TngList_StaticLights].index];
-          lgt > game.lish.lights;
-          lgt = &game.lish.lights[lgt->next_in_list] )
+    light_grid_iterate_start(&iter, startx - LIGHT_RANGE_LIMIT, starty - LIGHT_RANGE_LIMIT, endx + LIGHT_RANGE_LIMIT + 2, endy + LIGHT_RANGE_LIMIT + 2);
+    while ( (lgt = light_grid_iterate_next(&iter)) != NULL )
     {
+      // lights turned off are kept in the grid, but not on the static lights list
+      if ( (lgt->flags & LgtF_Dynamic) != 0 || (lgt->flags & LgtF_CanTurnOff) == 0 )
+        continue;
       if ( (lgt->flags & (LgtF_OutOfDate | LgtF_NeedUpdate)) != 0 )
       {
         ++light_out_of_date_stat_lights;
@@ -2194,8 +2308,11 @@ static void light_render_area(MapSubtlCoord startx, MapSubtlCoord starty, MapSub
 
   if ( game.lish.light_enabled )
   {
-    for ( lgt = &game.lish.lights[game.thing_lists[TngList_DynamLights].index]; lgt > game.lish.lights; lgt = &game.lish.lights[lgt->next_in_list] )
+    light_grid_iterate_start(&iter, startx - LIGHT_RANGE_LIMIT, starty - LIGHT_RANGE_LIMIT, endx + LIGHT_RANGE_LIMIT + 2, endy + LIGHT_RANGE_LIMIT + 2);
+    while ( (lgt = light_grid_iterate_next(&iter)) != NULL )
     {
+      if ( (lgt->flags & LgtF_Dynamic) == 0 || (lgt->flags & LgtF_CanTurnOff) == 0 )
+        continue;
       range = lgt->range;
       if ( (int)abs(half_width_x + startx - lgt->mappos.x.stl.num) < half_width_x + range
         && (int)abs(half_width_y + starty - lgt->mappos.y.stl.num) < half_width_y + range )
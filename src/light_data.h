@@ -24,6 +24,10 @@
 
 #define LIGHT_MAX_RANGE       256 // Large enough to cover the whole map
 #define LIGHTS_COUNT         2048
+/** Size of light grid cell side, in subtiles. */
+#define LIGHT_GRID_CELL_SUBTILES 8
+#define LIGHT_GRID_CELLS_X   ((MAX_SUBTILES_X + LIGHT_GRID_CELL_SUBTILES) / LIGHT_GRID_CELL_SUBTILES)
+#define LIGHT_GRID_CELLS_Y   ((MAX_SUBTILES_Y + LIGHT_GRID_CELL_SUBTILES) / LIGHT_GRID_CELL_SUBTILES)
 
 #ifdef __cplusplus
 extern "C" {
@@ -106,6 +110,16 @@ struct LightSystemState {
 
 #pragma pack()
 
+/** Walks through lights placed in light grid cells overlapping a rectangle of subtiles. */
+struct LightGridIterator {
+    int cell_x_beg;
+    int cell_x_end;
+    int cell_y_end;
+    int cell_x;
+    int cell_y;
+    unsigned short next_idx;
+};
+
 typedef struct VALUE VALUE;
 
 /******************************************************************************/
@@ -134,6 +148,9 @@ TbBool lights_stats_debug_dump(void);
 void light_signal_stat_light_update_in_area(long x1, long y1, long x2, long y2);
 
 int light_count_lights();
+void light_grid_rebuild(void);
+void light_grid_iterate_start(struct LightGridIterator *iter, MapSubtlCoord sx, MapSubtlCoord sy, MapSubtlCoord ex, MapSubtlCoord ey);
+struct Light *light_grid_iterate_next(struct LightGridIterator *iter);
 /******************************************************************************/
 #ifdef __cplusplus
 }
@@ -12,6 +12,7 @@
 #include "lvl_script_lib.h"
 #include "player_utils.h"
 #include "dungeon_data.h"
+#include "map_data.h"
 #include "config_campaigns.h"
 
 #include "post_inc.h"
@@ -241,6 +242,8 @@ static int player_get_field(lua_State *L) {
         } else {
             lua_pushinteger(L, dungeon->max_creatures_attracted);
         }
+    } else if (strcmp(key, "revealed_subtiles") == 0) {
+        lua_pushinteger(L, count_player_revealed_subtiles(plyr_idx));
     } else if (strcmp(key, "player_name") == 0) {
         lua_pushstring(L, player_invalid(player) ? "" : player->player_name);
     } else if (strcmp(key, "colour") == 0) {
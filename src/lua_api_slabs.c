@@ -96,7 +96,7 @@ static const struct luaL_Reg slab_methods[] = {
 
     if (strcmp(key, "revealed") == 0) {
         struct Map* mapblk = get_map_block_at(slb_x * STL_PER_SLB, slb_y * STL_PER_SLB);
-        mapblk->revealed = lua_toboolean(L, 3);
+        set_map_block_revealed_flags(mapblk, lua_toboolean(L, 3));
     } else if (strcmp(key, "owner") == 0) {
         set_slab_owner(slb_x, slb_y, luaL_checkPlayerSingle(L, 3));
     } else if (strcmp(key, "kind") == 0) {
@@ -124,7 +124,7 @@ static const struct luaL_Reg slab_methods[] = {
 
     if (strcmp(key, "revealed") == 0) {
         const struct Map* mapblk = get_map_block_at(slb_x * STL_PER_SLB, slb_y * STL_PER_SLB);
-       lua_pushboolean(L, mapblk->revealed);
+       lua_pushboolean(L, get_map_block_revealed_flags(mapblk));
     } else if (strcmp(key, "owner") == 0) {
         struct SlabMap *slb = get_slabmap_block(slb_x, slb_y);
         lua_pushPlayer(L, slabmap_owner(slb));
@@ -685,6 +685,7 @@ TbBool load_column_file(LevelNumber lv_num)
         i += sizeof(struct Column);
     }
     free(buf);
+    rebuild_columns_index();
     return true;
 }
 
@@ -719,9 +720,9 @@ TbBool load_map_data_file(LevelNumber lv_num)
             *wptr = 32;
             mapblk->mapwho = 0;
             mapblk->filled_subtiles = 0;
-            mapblk->revealed = 0;
         }
     }
+    clear_map_revealed();
     return true;
 }
 
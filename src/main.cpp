@@ -41,6 +41,7 @@
 #include "net_lobby.h"
 #include "net_resync.h"
 #include "bflib_planar.h"
+#include "bflib_workers.h"
 
 #include "ariadne_update.h"
 #include "api.h"
@@ -84,6 +85,7 @@
 #include "engine_arrays.h"
 #include "engine_textures.h"
 #include "engine_redraw.h"
+#include "engine_particles.h"
 #include "front_easter.h"
 #include "front_fmvids.h"
 #include "thing_stats.h"
@@ -97,6 +99,7 @@
 #include "thing_shots.h"
 #include "thing_factory.h"
 #include "slab_data.h"
+#include "spdigger_stack.h"
 #include "room_data.h"
 #include "room_entrance.h"
 #include "room_util.h"
@@ -925,6 +928,14 @@ void reinit_level_after_load(void)
     player = get_my_player();
     reinit_tagged_blocks_for_player(player->id_number);
     restore_computer_player_after_load();
+    clear_digger_stack_fields();
+    clear_room_standing_positions();
+    clear_trap_trigger_zones();
+    rebuild_thing_class_pools();
+    light_grid_rebuild();
+    rebuild_columns_index();
+    rebuild_mapwho_creature_counts();
+    rebuild_room_running_sums();
     sound_reinit_after_load();
     update_panel_colors();
     reset_postal_instance_cache();
@@ -961,8 +972,10 @@ void clear_things_and_persons_data(void)
     struct Thing *thing;
     long i;
     memset(game.thing_lists, 0, sizeof(game.thing_lists));
+    clear_thing_class_pools();
     game.ambient_sound_thing_idx = 0;
     game.nodungeon_creatr_list_start = 0;
+    clear_effect_particles();
     for (i=0; i < THINGS_COUNT; i++)
     {
         thing = &game.things_data[i];
@@ -1992,6 +2005,33 @@ static short process_command_line(unsigned short argc, char *argv[])
        WARNLOG("Flag '%s' disabled for release builds.", parstr);
 #endif // FUNCTESTING
       }
+      else if(strcasecmp(parstr, "ftest_maxturns") == 0)
+      {
+#ifdef FUNCTESTING
+        start_params.functest_max_turns = atol(pr2str);
+#else
+       WARNLOG("Flag '%s' disabled for release builds.", parstr);
+#endif // FUNCTESTING
+        narg++;
+      }
+      else if(strcasecmp(parstr, "ftest_maxtime") == 0)
+      {
+#ifdef FUNCTESTING
+        start_params.functest_max_time = atol(pr2str) * 1000;
+#else
+       WARNLOG("Flag '%s' disabled for release builds.", parstr);
+#endif // FUNCTESTING
+        narg++;
+      }
+      else if(strcasecmp(parstr, "ftest_report") == 0)
+      {
+#ifdef FUNCTESTING
+        snprintf(start_params.functest_report_fname, sizeof(start_params.functest_report_fname), "%s", pr2str);
+#else
+       WARNLOG("Flag '%s' disabled for release builds.", parstr);
+#endif // FUNCTESTING
+        narg++;
+      }
       else
       {
         // append bad parstr to bad_params string
@@ -2119,6 +2159,7 @@ int LbBullfrogMain(unsigned short argc, char *argv[])
         api_init_server();
         game_loop();
     }
+    LbWorkersShutdown();
     reset_game();
     RendererResetScreen(true);
     RendererShutdown();
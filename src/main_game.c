@@ -40,6 +40,7 @@
 #include "kjm_input.h"
 #include "config_sounds.h"
 #include "lvl_filesdk1.h"
+#include "map_data.h"
 #include "lua_base.h"
 #include "lua_triggers.h"
 #include "net_exchange_common.h"
@@ -57,6 +58,7 @@
 #include "custom_sprites.h"
 #include "gui_boxmenu.h"
 #include "sounds.h"
+#include "spdigger_stack.h"
 #include "api.h"
 #include "net_resync.h"
 
@@ -199,6 +201,11 @@ static TbBool init_level(void)
 
     erstats_clear();
     init_dungeons();
+    clear_digger_stack_fields();
+    clear_room_standing_positions();
+    clear_trap_trigger_zones();
+    rebuild_mapwho_creature_counts();
+    rebuild_room_running_sums();
     setup_panel_colors();
     init_map_size(get_selected_level_number());
     clear_messages();
@@ -455,6 +462,7 @@ void clear_complete_game(void)
 {
     memset(&game, 0, sizeof(struct Game));
     memset(&intralvl, 0, sizeof(struct IntralevelData));
+    setup_map_storage();
     game.turns_packetoff = -1;
     game.local_plyr_idx = default_loc_player;
     game.packet_checksum_verify = start_params.packet_checksum_verify;
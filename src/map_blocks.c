@@ -36,6 +36,7 @@
 #include "player_utils.h"
 #include "spdigger_stack.h"
 #include "frontmenu_ingame_map.h"
+#include "player_compdigfld.h"
 #include "game_legacy.h"
 #include "engine_render.h"
 #include "thing_navigate.h"
@@ -297,15 +298,7 @@ TbBool set_slab_explored(PlayerNumber plyr_idx, MapSlabCoord slb_x, MapSlabCoord
     {
         return false;
     }
-    reveal_map_subtile(slab_subtile(slb_x,0), slab_subtile(slb_y,0), plyr_idx);
-    reveal_map_subtile(slab_subtile(slb_x,1), slab_subtile(slb_y,0), plyr_idx);
-    reveal_map_subtile(slab_subtile(slb_x,2), slab_subtile(slb_y,0), plyr_idx);
-    reveal_map_subtile(slab_subtile(slb_x,0), slab_subtile(slb_y,1), plyr_idx);
-    reveal_map_subtile(slab_subtile(slb_x,1), slab_subtile(slb_y,1), plyr_idx);
-    reveal_map_subtile(slab_subtile(slb_x,2), slab_subtile(slb_y,1), plyr_idx);
-    reveal_map_subtile(slab_subtile(slb_x,0), slab_subtile(slb_y,2), plyr_idx);
-    reveal_map_subtile(slab_subtile(slb_x,1), slab_subtile(slb_y,2), plyr_idx);
-    reveal_map_subtile(slab_subtile(slb_x,2), slab_subtile(slb_y,2), plyr_idx);
+    reveal_map_rect(plyr_idx, slab_subtile(slb_x,0), slab_subtile(slb_x,STL_PER_SLB), slab_subtile(slb_y,0), slab_subtile(slb_y,STL_PER_SLB));
     panel_map_update(slab_subtile(slb_x,0), slab_subtile(slb_y,0), STL_PER_SLB, STL_PER_SLB);
     return true;
 }
@@ -318,17 +311,15 @@ void set_slab_explored_flags(PlayerNumber plyr_idx, MapSlabCoord slb_x, MapSlabC
     PlayerBitFlags flag = to_flag(plyr_idx);
     struct Map *mapblk = get_map_block_at(stl_x, stl_y);
 
-    if (mapblk->revealed != flag)
+    if (get_map_block_revealed_flags(mapblk) != flag)
     {
-        get_map_block_at(stl_x,     stl_y    )->revealed = flag;
-        get_map_block_at(stl_x + 1, stl_y    )->revealed = flag;
-        get_map_block_at(stl_x + 2, stl_y    )->revealed = flag;
-        get_map_block_at(stl_x,     stl_y + 1)->revealed = flag;
-        get_map_block_at(stl_x + 1, stl_y + 1)->revealed = flag;
-        get_map_block_at(stl_x + 2, stl_y + 1)->revealed = flag;
-        get_map_block_at(stl_x,     stl_y + 2)->revealed = flag;
-        get_map_block_at(stl_x + 1, stl_y + 2)->revealed = flag;
-        get_map_block_at(stl_x + 2, stl_y + 2)->revealed = flag;
+        for (PlayerNumber i = 0; i < PLAYERS_COUNT; i++)
+        {
+            if (i == plyr_idx)
+                reveal_map_rect(i, stl_x, stl_x + STL_PER_SLB, stl_y, stl_y + STL_PER_SLB);
+            else
+                conceal_map_rect(i, stl_x, stl_x + STL_PER_SLB, stl_y, stl_y + STL_PER_SLB);
+        }
 
         panel_map_update(stl_x, stl_y, STL_PER_SLB, STL_PER_SLB);
     }
@@ -654,14 +645,6 @@ static TbBool get_against(PlayerNumber agnst_plyr_idx, SlabKind agnst_slbkind, M
     || ((slabmap_owner(slb) != agnst_plyr_idx) && ((slabmap_owner(slb) != game.neutral_player_num) || (slb->kind == SlbT_CLAIMED) ));
 }
 
-void delete_column(ColumnIndex col_idx)
-{
-    struct Column *col;
-    col = &game.columns_data[col_idx];
-    memcpy(col, &game.columns_data[0], sizeof(struct Column));
-    col->use = 0;
-}
-
 void remove_block_from_map_element(MapSubtlCoord stl_x, MapSubtlCoord stl_y)
 {
     struct Map *mapblk;
@@ -680,6 +663,8 @@ void remove_block_from_map_element(MapSubtlCoord stl_x, MapSubtlCoord stl_y)
 void place_column_on_map_element(struct Column *ncol, MapSubtlCoord stl_x, MapSubtlCoord stl_y)
 {
     //void place_column_on_map_element(struct Column *col, unsigned short a2, unsigned short a3)
+    invalidate_line_of_sight_cache();
+    invalidate_room_standing_positions_in_area(stl_x, stl_y, stl_x, stl_y);
     remove_block_from_map_element(stl_x, stl_y);
     long col_idx;
     col_idx = find_column(ncol);
@@ -733,6 +718,7 @@ void copy_block_with_cube_groups(short itm_idx, MapSubtlCoord stl_x, MapSubtlCoo
         struct Map *mapblk;
         mapblk = get_map_block_at(stl_x, stl_y);
         set_mapblk_column_index(mapblk, -itm_idx);
+        invalidate_room_standing_positions_in_area(stl_x, stl_y, stl_x, stl_y);
     }
 }
 
@@ -1581,6 +1567,7 @@ void dump_slab_on_map(SlabKind slbkind, long slabset_id, MapSubtlCoord stl_x, Ma
 
     slb = get_slabmap_block(slb_x, slb_y);
     slb->kind = slbkind;
+    room_efficiency_slabs_changed_around(slb_x, slb_y, 0);
     panel_map_update(stl_xa, stl_ya, STL_PER_SLB, STL_PER_SLB);
     if (slab_kind_is_animated(slbkind) && !slab_kind_is_door(slbkind))
     {
@@ -1626,6 +1613,9 @@ void place_animating_slab_type_on_map(SlabKind slbkind, char ani_frame, MapSubtl
         if (slbmap->kind != old_kind)
         {
             lua_on_slab_kind_change(slb_x, slb_y, old_kind);
+            panel_map_update_slab(slb_x, slb_y);
+            computer_dig_field_slab_changed(slb_x, slb_y);
+            digger_stack_slab_changed(slb_x, slb_y);
         }
 }
 
@@ -1829,9 +1819,14 @@ void place_slab_type_on_map_f(SlabKind nslab, MapSubtlCoord stl_x, MapSubtlCoord
         default:
             break;
     }
+    // Slabs around were restyled as well
+    room_efficiency_slabs_changed_around(slb_x, slb_y, 1);
     if (old_kind != nslab)
     {
         lua_on_slab_kind_change(slb_x, slb_y, old_kind);
+        panel_map_update_slab(slb_x, slb_y);
+        computer_dig_field_slab_changed(slb_x, slb_y);
+        digger_stack_slab_changed(slb_x, slb_y);
     }
 }
 
@@ -24,6 +24,7 @@
 #include "front_simple.h"
 #include "globals.h"
 #include "game_legacy.h"
+#include "room_data.h"
 #include "post_inc.h"
 
 #ifdef __cplusplus
@@ -239,6 +240,8 @@ void ceiling_partially_recompute_heights(MapSubtlCoord sx, MapSubtlCoord sy, Map
         }
         current_stl_y ++;
     }
+    invalidate_room_standing_positions_in_area(computation_start_stl_x, computation_start_stl_y,
+        computation_end_stl_x - 1, computation_end_stl_y - 1);
 }
 
 static long get_ceiling_filled_subtiles_from_cubes(const struct Column *col)
@@ -346,6 +349,7 @@ void ceiling_init()
             set_mapblk_filled_subtiles(mapblk, filled_h);
         }
     }
+    clear_room_standing_positions();
 }
 
 short ceiling_set_info(long height_max, long height_min, long step)
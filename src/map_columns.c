@@ -29,6 +29,25 @@
 extern "C" {
 #endif
 /******************************************************************************/
+/** Amount of chains in columns content index; must be power of 2. */
+#define COLUMNS_HASH_SIZE 8192
+
+/**
+ * Index of columns by their content, allowing to find equivalent columns without scanning the array.
+ * Every column except the invalid one is in a chain selected by content hash; chains are sorted
+ * by column index, so the first equivalent column found is the lowest one.
+ * Not saved, as it's rebuilt from the columns after loading or resync.
+ */
+struct ColumnsIndex {
+    ColumnIndex hash_first[COLUMNS_HASH_SIZE];
+    ColumnIndex hash_next[COLUMNS_COUNT];
+    ColumnIndex hash_prev[COLUMNS_COUNT];
+    /** All columns below this index are in use. */
+    ColumnIndex free_first;
+};
+
+static struct ColumnsIndex columns_index;
+/******************************************************************************/
 struct Column *get_column(long idx)
 {
   if ((idx < 1) || (idx >= COLUMNS_COUNT))
@@ -272,15 +291,107 @@ static TbBool column_is_equivalent(struct Column * const src, struct Column *dst
     return 0 == memcmp(src->cubes, dst->cubes, sizeof(src->cubes));
 }
 
+static unsigned long column_content_hash(const struct Column *col)
+{
+    // FNV-1a over fields compared by column_is_equivalent()
+    unsigned long hash = 2166136261UL;
+    hash = ((hash ^ col->floor_texture) * 16777619UL) & 0xFFFFFFFFUL;
+    hash = ((hash ^ col->solidmask) * 16777619UL) & 0xFFFFFFFFUL;
+    hash = ((hash ^ col->orient) * 16777619UL) & 0xFFFFFFFFUL;
+    for (int i = 0; i < COLUMN_STACK_HEIGHT; i++) {
+        hash = ((hash ^ col->cubes[i]) * 16777619UL) & 0xFFFFFFFFUL;
+    }
+    return (hash ^ (hash >> 15)) & (COLUMNS_HASH_SIZE - 1);
+}
+
+static TbBool column_is_free(const struct Column *col)
+{
+    return (col->use == 0) && ((col->bitfields & CLF_ACTIVE) == 0);
+}
+
+/**
+ * Adds column to the content index chain, keeping the chain sorted.
+ * Needs to be called after column content has changed.
+ */
+static void columns_index_insert(ColumnIndex col_idx)
+{
+    struct ColumnsIndex *cindex = &columns_index;
+    unsigned long hash = column_content_hash(get_column(col_idx));
+    ColumnIndex prev_idx = 0;
+    ColumnIndex next_idx = cindex->hash_first[hash];
+    while ((next_idx != 0) && (next_idx < col_idx))
+    {
+        prev_idx = next_idx;
+        next_idx = cindex->hash_next[next_idx];
+    }
+    cindex->hash_prev[col_idx] = prev_idx;
+    cindex->hash_next[col_idx] = next_idx;
+    if (prev_idx != 0) {
+        cindex->hash_next[prev_idx] = col_idx;
+    } else {
+        cindex->hash_first[hash] = col_idx;
+    }
+    if (next_idx != 0) {
+        cindex->hash_prev[next_idx] = col_idx;
+    }
+}
+
+/**
+ * Removes column from the content index chain.
+ * Needs to be called before column content is changed.
+ */
+static void columns_index_remove(ColumnIndex col_idx)
+{
+    struct ColumnsIndex *cindex = &columns_index;
+    ColumnIndex prev_idx = cindex->hash_prev[col_idx];
+    ColumnIndex next_idx = cindex->hash_next[col_idx];
+    if (prev_idx != 0) {
+        cindex->hash_next[prev_idx] = next_idx;
+    } else {
+        cindex->hash_first[column_content_hash(get_column(col_idx))] = next_idx;
+    }
+    if (next_idx != 0) {
+        cindex->hash_prev[next_idx] = prev_idx;
+    }
+    cindex->hash_prev[col_idx] = 0;
+    cindex->hash_next[col_idx] = 0;
+}
+
+/**
+ * Recreates columns content index from the columns array.
+ * Needs to be called after columns were modified directly, ie. by loading.
+ */
+void rebuild_columns_index(void)
+{
+    struct ColumnsIndex *cindex = &columns_index;
+    memset(cindex, 0, sizeof(struct ColumnsIndex));
+    // Adding in reverse order to chain heads makes the chains sorted
+    for (ColumnIndex i = COLUMNS_COUNT-1; i > 0; i--)
+    {
+        unsigned long hash = column_content_hash(get_column(i));
+        ColumnIndex next_idx = cindex->hash_first[hash];
+        cindex->hash_next[i] = next_idx;
+        if (next_idx != 0) {
+            cindex->hash_prev[next_idx] = i;
+        }
+        cindex->hash_first[hash] = i;
+    }
+    cindex->free_first = 1;
+    while ((cindex->free_first < COLUMNS_COUNT) && !column_is_free(get_column(cindex->free_first))) {
+        cindex->free_first++;
+    }
+}
+
 long find_column(struct Column *srccol)
 {
-    int i;
-    for (i=1; i < COLUMNS_COUNT; i++) {
-        struct Column *col;
-        col = get_column(i);
-        if (column_is_equivalent(srccol, col)) {
-          return i;
+    const struct ColumnsIndex *cindex = &columns_index;
+    ColumnIndex i = cindex->hash_first[column_content_hash(srccol)];
+    while (i != 0)
+    {
+        if (column_is_equivalent(srccol, get_column(i))) {
+            return i;
         }
+        i = cindex->hash_next[i];
     }
     return 0;
 }
@@ -293,22 +404,27 @@ long create_column(struct Column *col)
     unsigned char top_of_floor;
 
     // Find an empty column
-    result = 1;
-    dst = &game.columns_data[1];
-    while (dst->use || dst->bitfields & CLF_ACTIVE )
+    result = columns_index.free_first;
+    if (result < 1)
+        result = 1;
+    while ((result < COLUMNS_COUNT) && !column_is_free(get_column(result)))
     {
         ++result;
-        ++dst;
-        if ( result >= COLUMNS_COUNT )
-        {
-            ERRORLOG("Could not create column: None free");
-            return 0;
-        }
     }
+    if (result >= COLUMNS_COUNT)
+    {
+        columns_index.free_first = COLUMNS_COUNT;
+        ERRORLOG("Could not create column: None free");
+        return 0;
+    }
+    columns_index.free_first = result + 1;
+    dst = &game.columns_data[result];
+    columns_index_remove(result);
     // Copy data
     memcpy(dst, col, sizeof(struct Column));
     // Create cubemask
     make_solidmask(dst);
+    columns_index_insert(result);
 
     // Find lowest cube
     for (cube_index = 0; cube_index < COLUMN_STACK_HEIGHT;cube_index++)
@@ -356,6 +472,19 @@ long create_column(struct Column *col)
     return result;
 }
 
+void delete_column(ColumnIndex col_idx)
+{
+    struct Column *col;
+    col = &game.columns_data[col_idx];
+    columns_index_remove(col_idx);
+    memcpy(col, &game.columns_data[0], sizeof(struct Column));
+    col->use = 0;
+    columns_index_insert(col_idx);
+    if (col_idx < columns_index.free_first) {
+        columns_index.free_first = col_idx;
+    }
+}
+
 void clear_columns(void)
 {
   struct Column *colmn;
@@ -372,6 +501,7 @@ void clear_columns(void)
   {
     game.col_static_entries[i] = 0;
   }
+  rebuild_columns_index();
 }
 
 void init_columns(void)
@@ -430,6 +560,8 @@ void init_columns(void)
             }
         }
     }
+    // Solid masks are part of column content, so the index has to be updated
+    rebuild_columns_index();
 }
 
 void init_whole_blocks(void)
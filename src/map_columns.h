@@ -68,6 +68,8 @@ void clear_columns(void);
 void init_columns(void);
 long find_column(struct Column *col);
 long create_column(struct Column *col);
+void delete_column(ColumnIndex col_idx);
+void rebuild_columns_index(void);
 unsigned short find_column_height(struct Column *col);
 void init_whole_blocks(void);
 void init_top_texture_to_cube_table(void);
@@ -40,6 +40,19 @@ struct Map bad_map_block;
  */
 MapSubtlCoord map_subtiles_z = 8;
 
+/** Map storage buffers, sized for the current level; Game structure only points to them. */
+static struct Map *map_storage_blocks;
+static NavColour *map_storage_navigation;
+static struct SlabMap *map_storage_slabs;
+static SubtlCodedCoords map_storage_subtiles_count;
+static SlabCodedCoords map_storage_slabs_count;
+/** Revealed map bitplanes, one per player, each indexed by subtile number. */
+static uint32_t *map_storage_revealed;
+/** Amount of words in a single revealed bitplane. */
+static unsigned long map_storage_revealed_words;
+
+#define REVEALED_WORD_BITS 32
+
 /******************************************************************************/
 /**
  * Returns if the subtile coords are in range of subtiles which have slab entry.
@@ -178,14 +191,150 @@ TbBool subtile_revealed_directly(MapSubtlCoord stl_x, MapSubtlCoord stl_y, Playe
     return map_block_revealed_directly(mapblk, plyr_idx);
 }
 
+/**
+ * Returns subtile number of given map block, or -1 if it's not inside map storage.
+ */
+static long get_map_block_storage_index(const struct Map *mapblk)
+{
+    if ((mapblk == NULL) || (map_storage_blocks == NULL))
+        return -1;
+    if ((mapblk < map_storage_blocks) || (mapblk >= map_storage_blocks + map_storage_subtiles_count))
+        return -1;
+    return mapblk - map_storage_blocks;
+}
+
+static uint32_t *get_player_revealed_plane(PlayerNumber plyr_idx)
+{
+    if ((plyr_idx < 0) || (plyr_idx >= PLAYERS_COUNT) || (map_storage_revealed == NULL))
+        return NULL;
+    return &map_storage_revealed[plyr_idx * map_storage_revealed_words];
+}
+
+static TbBool revealed_plane_bit_is_set(const uint32_t *plane, long stl_num)
+{
+    return ((plane[stl_num / REVEALED_WORD_BITS] >> (stl_num % REVEALED_WORD_BITS)) & 1) != 0;
+}
+
+/**
+ * Sets or clears a range of bits within revealed bitplane, whole words at a time where possible.
+ * @param first First subtile number of the range.
+ * @param end Subtile number after the last one in range.
+ */
+static void set_revealed_plane_range(uint32_t *plane, long first, long end, TbBool revealed)
+{
+    while (first < end)
+    {
+        long word_idx = first / REVEALED_WORD_BITS;
+        int bit_beg = first % REVEALED_WORD_BITS;
+        int bit_end = REVEALED_WORD_BITS;
+        if (end - word_idx * REVEALED_WORD_BITS < REVEALED_WORD_BITS)
+            bit_end = end - word_idx * REVEALED_WORD_BITS;
+        uint32_t mask = 0xFFFFFFFFu;
+        if (bit_end < REVEALED_WORD_BITS)
+            mask = (1u << bit_end) - 1;
+        mask &= ~((1u << bit_beg) - 1);
+        if (revealed)
+            plane[word_idx] |= mask;
+        else
+            plane[word_idx] &= ~mask;
+        first = (word_idx + 1) * REVEALED_WORD_BITS;
+    }
+}
+
+/**
+ * Sets or clears revealed bits of given player for a subtiles rectangle.
+ * Coordinates are clipped to map storage; end coords are exclusive.
+ */
+static void set_revealed_rect(PlayerNumber plyr_idx, MapSubtlCoord start_x, MapSubtlCoord end_x, MapSubtlCoord start_y, MapSubtlCoord end_y, TbBool revealed)
+{
+    uint32_t* plane = get_player_revealed_plane(plyr_idx);
+    if (plane == NULL)
+        return;
+    start_x = max(start_x, 0);
+    start_y = max(start_y, 0);
+    end_x = min(end_x, game.map_subtiles_x + 1);
+    end_y = min(end_y, game.map_subtiles_y + 1);
+    if ((start_x >= end_x) || (start_y >= end_y))
+        return;
+    for (MapSubtlCoord y = start_y; y < end_y; y++)
+    {
+        long row_num = get_subtile_number(0, y);
+        set_revealed_plane_range(plane, row_num + start_x, row_num + end_x, revealed);
+    }
+}
+
 void reveal_map_block(struct Map *mapblk, PlayerNumber plyr_idx)
 {
-    set_flag(mapblk->revealed, to_flag(plyr_idx));
+    long stl_num = get_map_block_storage_index(mapblk);
+    uint32_t* plane = get_player_revealed_plane(plyr_idx);
+    if ((stl_num < 0) || (plane == NULL))
+        return;
+    plane[stl_num / REVEALED_WORD_BITS] |= (1u << (stl_num % REVEALED_WORD_BITS));
 }
 
 void conceal_map_block(struct Map *mapblk, PlayerNumber plyr_idx)
 {
-    clear_flag(mapblk->revealed, to_flag(plyr_idx));
+    long stl_num = get_map_block_storage_index(mapblk);
+    uint32_t* plane = get_player_revealed_plane(plyr_idx);
+    if ((stl_num < 0) || (plane == NULL))
+        return;
+    plane[stl_num / REVEALED_WORD_BITS] &= ~(1u << (stl_num % REVEALED_WORD_BITS));
+}
+
+/**
+ * Returns flags of all players who have given map block revealed directly.
+ */
+PlayerBitFlags get_map_block_revealed_flags(const struct Map *mapblk)
+{
+    long stl_num = get_map_block_storage_index(mapblk);
+    if ((stl_num < 0) || (map_storage_revealed == NULL))
+        return 0;
+    PlayerBitFlags flags = 0;
+    for (PlayerNumber i = 0; i < PLAYERS_COUNT; i++)
+    {
+        if (revealed_plane_bit_is_set(get_player_revealed_plane(i), stl_num))
+            set_flag(flags, to_flag(i));
+    }
+    return flags;
+}
+
+/**
+ * Sets the map block revealed for players whose flags are given, and concealed for all others.
+ */
+void set_map_block_revealed_flags(struct Map *mapblk, PlayerBitFlags flags)
+{
+    for (PlayerNumber i = 0; i < PLAYERS_COUNT; i++)
+    {
+        if (flag_is_set(flags, to_flag(i)))
+            reveal_map_block(mapblk, i);
+        else
+            conceal_map_block(mapblk, i);
+    }
+}
+
+/**
+ * Returns amount of map subtiles which given player has revealed directly.
+ */
+unsigned long count_player_revealed_subtiles(PlayerNumber plyr_idx)
+{
+    const uint32_t* plane = get_player_revealed_plane(plyr_idx);
+    if (plane == NULL)
+        return 0;
+    unsigned long count = 0;
+    for (unsigned long i = 0; i < map_storage_revealed_words; i++)
+    {
+        count += __builtin_popcount(plane[i]);
+    }
+    return count;
+}
+
+/**
+ * Clears revealed bitplanes of all players.
+ */
+void clear_map_revealed(void)
+{
+    if (map_storage_revealed != NULL)
+        memset(map_storage_revealed, 0, PLAYERS_COUNT * map_storage_revealed_words * sizeof(uint32_t));
 }
 
 TbBool slabs_reveal_slab_and_corners(MapSlabCoord slab_x, MapSlabCoord slab_y, MaxCoordFilterParam param)
@@ -295,7 +444,8 @@ TbBool slabs_change_texture(MapSlabCoord slb_x, MapSlabCoord slb_y, MaxCoordFilt
 
 TbBool map_block_revealed(const struct Map *mapblk, PlayerNumber plyr_idx)
 {
-    if (map_block_invalid(mapblk))
+    long stl_num = get_map_block_storage_index(mapblk);
+    if ((stl_num < 0) || (map_storage_revealed == NULL))
         return false;
     if (game.conf.rules[plyr_idx].gameplay.allies_share_vision)
     {
@@ -303,14 +453,15 @@ TbBool map_block_revealed(const struct Map *mapblk, PlayerNumber plyr_idx)
         {
             if (players_are_mutual_allies(plyr_idx, i))
             {
-                if (flag_is_set(mapblk->revealed, to_flag(i)))
+                if (revealed_plane_bit_is_set(get_player_revealed_plane(i), stl_num))
                     return true;
             }
         }
     }
     else
     {
-        if (flag_is_set(mapblk->revealed, to_flag(plyr_idx)))
+        const uint32_t* plane = get_player_revealed_plane(plyr_idx);
+        if ((plane != NULL) && revealed_plane_bit_is_set(plane, stl_num))
             return true;
     }
     return false;
@@ -319,14 +470,13 @@ TbBool map_block_revealed(const struct Map *mapblk, PlayerNumber plyr_idx)
 
 TbBool map_block_revealed_directly(const struct Map* mapblk, PlayerNumber plyr_idx)
 {
-    if (map_block_invalid(mapblk))
+    long stl_num = get_map_block_storage_index(mapblk);
+    const uint32_t* plane = get_player_revealed_plane(plyr_idx);
+    if ((stl_num < 0) || (plane == NULL))
         return false;
-    if (flag_is_set(mapblk->revealed, to_flag(plyr_idx)))
-        return true;
-    return false;
+    return revealed_plane_bit_is_set(plane, stl_num);
 }
 
-
 TbBool valid_dig_position(PlayerNumber plyr_idx, long stl_x, long stl_y)
 {
     const struct Map* mapblk = get_map_block_at(stl_x, stl_y);
@@ -554,6 +704,7 @@ void clear_mapmap(void)
             *flg = 0;
         }
     }
+    clear_map_revealed();
     clear_subtiles_lightness(&game.lish);
 }
 
@@ -624,13 +775,16 @@ void clear_dig_for_map_rect(long plyr_idx, MapSubtlCoord start_x, MapSubtlCoord
  */
 void reveal_map_rect(PlayerNumber plyr_idx,MapSubtlCoord start_x,MapSubtlCoord end_x,MapSubtlCoord start_y,MapSubtlCoord end_y)
 {
-    MapSubtlCoord x;
-    MapSubtlCoord y;
-    for (y = start_y; y < end_y; y++)
-        for (x = start_x; x < end_x; x++)
-        {
-            reveal_map_subtile(x, y, plyr_idx);
-        }
+    set_revealed_rect(plyr_idx, start_x, end_x, start_y, end_y, true);
+}
+
+/**
+ * Conceals map subtiles rectangle for given player.
+ * Low level function - use conceal_map_area() instead.
+ */
+void conceal_map_rect(PlayerNumber plyr_idx,MapSubtlCoord start_x,MapSubtlCoord end_x,MapSubtlCoord start_y,MapSubtlCoord end_y)
+{
+    set_revealed_rect(plyr_idx, start_x, end_x, start_y, end_y, false);
 }
 
 
@@ -672,24 +826,27 @@ void conceal_map_area(PlayerNumber plyr_idx,MapSubtlCoord start_x,MapSubtlCoord
     end_y = stl_slab_ending_subtile(end_y)+1;
     clear_dig_for_map_rect(plyr_idx,subtile_slab(start_x),subtile_slab(end_x),
                            subtile_slab(start_y),subtile_slab(end_y));
+    if (all)
+    {
+        conceal_map_rect(plyr_idx,start_x,end_x,start_y,end_y);
+        panel_map_update(start_x,start_y,end_x,end_y);
+        return;
+    }
     for (MapSubtlCoord y = start_y; y < end_y; y++)
     {
         for (MapSubtlCoord x = start_x; x < end_x; x++)
         {
             struct Map* mapblk = get_map_block_at(x, y);
-            if (!all)
+            struct SlabMap *slb = get_slabmap_for_subtile(x,y);
+            switch (slb->kind) // TODO: flags?
             {
-                struct SlabMap *slb = get_slabmap_for_subtile(x,y);
-                switch (slb->kind) // TODO: flags?
-                {
-                    case SlbT_ROCK:
-                    case SlbT_GEMS:
-                    case SlbT_GOLD:
-                    case SlbT_DENSEGOLD:
-                        continue;
-                    default:
-                        break;
-                }
+                case SlbT_ROCK:
+                case SlbT_GEMS:
+                case SlbT_GOLD:
+                case SlbT_DENSEGOLD:
+                    continue;
+                default:
+                    break;
             }
             conceal_map_block(mapblk, plyr_idx);
         }
@@ -870,6 +1027,147 @@ void set_map_size(MapSlabCoord x,MapSlabCoord y)
     game.around_map[7] = game.map_subtiles_x + 1;
     game.around_map[8] = game.map_subtiles_x + 2;
 
+    init_spiral_steps();
+    setup_map_storage();
+}
+
+/**
+ * Returns amount of map blocks needed for current map size.
+ * Includes the additional row and column which get_subtile_number() may return.
+ */
+SubtlCodedCoords get_map_storage_subtiles_count(void)
+{
+    return (game.map_subtiles_x + 2) * (game.map_subtiles_y + 2);
+}
+
+/**
+ * Returns amount of slab map entries needed for current map size.
+ * Includes the additional row which get_slab_number() may return.
+ */
+SlabCodedCoords get_map_storage_slabs_count(void)
+{
+    return game.map_tiles_x * (game.map_tiles_y + 1) + 1;
+}
+
+/**
+ * Returns amount of words in a revealed bitplane for given amount of subtiles.
+ */
+static unsigned long get_map_storage_revealed_words(SubtlCodedCoords subtiles_count)
+{
+    return (subtiles_count + REVEALED_WORD_BITS - 1) / REVEALED_WORD_BITS;
+}
+
+/**
+ * Returns size of map data which is saved and sent on resync, for current map size.
+ */
+size_t get_map_storage_data_size(void)
+{
+    return get_map_storage_subtiles_count() * (sizeof(struct Map) + sizeof(NavColour))
+        + get_map_storage_slabs_count() * sizeof(struct SlabMap)
+        + PLAYERS_COUNT * get_map_storage_revealed_words(get_map_storage_subtiles_count()) * sizeof(uint32_t);
+}
+
+/**
+ * Makes Game structure point to the map storage.
+ * Needs to be called after the structure is cleared or overwritten by loaded data.
+ */
+void attach_map_storage(void)
+{
+    game.map = map_storage_blocks;
+    game.navigation_map = map_storage_navigation;
+    game.slabmap = map_storage_slabs;
+}
+
+void free_map_storage(void)
+{
+    free(map_storage_blocks);
+    free(map_storage_navigation);
+    free(map_storage_slabs);
+    free(map_storage_revealed);
+    map_storage_blocks = NULL;
+    map_storage_navigation = NULL;
+    map_storage_slabs = NULL;
+    map_storage_revealed = NULL;
+    map_storage_revealed_words = 0;
+    map_storage_subtiles_count = 0;
+    map_storage_slabs_count = 0;
+    attach_map_storage();
+}
+
+/**
+ * Allocates map storage for current map size, as stored in Game structure.
+ * The buffers are only reallocated if their size changes; new buffers are cleared.
+ */
+TbBool setup_map_storage(void)
+{
+    SubtlCodedCoords subtiles_count = get_map_storage_subtiles_count();
+    SlabCodedCoords slabs_count = get_map_storage_slabs_count();
+    if ((subtiles_count != map_storage_subtiles_count) || (slabs_count != map_storage_slabs_count))
+    {
+        free_map_storage();
+        map_storage_blocks = (struct Map *)calloc(subtiles_count, sizeof(struct Map));
+        map_storage_navigation = (NavColour *)calloc(subtiles_count, sizeof(NavColour));
+        map_storage_slabs = (struct SlabMap *)calloc(slabs_count, sizeof(struct SlabMap));
+        map_storage_revealed_words = get_map_storage_revealed_words(subtiles_count);
+        map_storage_revealed = (uint32_t *)calloc(PLAYERS_COUNT * map_storage_revealed_words, sizeof(uint32_t));
+        if ((map_storage_blocks == NULL) || (map_storage_navigation == NULL) || (map_storage_slabs == NULL)
+          || (map_storage_revealed == NULL))
+        {
+            ERRORLOG("Cannot allocate map storage for %dx%d slabs",(int)game.map_tiles_x,(int)game.map_tiles_y);
+            free_map_storage();
+            return false;
+        }
+        map_storage_subtiles_count = subtiles_count;
+        map_storage_slabs_count = slabs_count;
+    }
+    attach_map_storage();
+    return true;
+}
+
+/**
+ * Copies map data of current map size into given buffer, for saving or resync.
+ * @param buf Destination buffer, get_map_storage_data_size() bytes long.
+ */
+void pack_map_storage(unsigned char *buf)
+{
+    size_t len = map_storage_subtiles_count * sizeof(struct Map);
+    memcpy(buf, map_storage_blocks, len);
+    buf += len;
+    len = map_storage_subtiles_count * sizeof(NavColour);
+    memcpy(buf, map_storage_navigation, len);
+    buf += len;
+    len = map_storage_slabs_count * sizeof(struct SlabMap);
+    memcpy(buf, map_storage_slabs, len);
+    buf += len;
+    len = PLAYERS_COUNT * map_storage_revealed_words * sizeof(uint32_t);
+    memcpy(buf, map_storage_revealed, len);
+}
+
+/**
+ * Fills map storage from a buffer made by pack_map_storage().
+ * Map size in Game structure must already be the one of the packed data.
+ */
+TbBool unpack_map_storage(const unsigned char *buf, size_t buf_len)
+{
+    if (!setup_map_storage())
+        return false;
+    if (buf_len != get_map_storage_data_size())
+    {
+        ERRORLOG("Map data size %d doesn't match map size %dx%d",(int)buf_len,(int)game.map_tiles_x,(int)game.map_tiles_y);
+        return false;
+    }
+    size_t len = map_storage_subtiles_count * sizeof(struct Map);
+    memcpy(map_storage_blocks, buf, len);
+    buf += len;
+    len = map_storage_subtiles_count * sizeof(NavColour);
+    memcpy(map_storage_navigation, buf, len);
+    buf += len;
+    len = map_storage_slabs_count * sizeof(struct SlabMap);
+    memcpy(map_storage_slabs, buf, len);
+    buf += len;
+    len = PLAYERS_COUNT * map_storage_revealed_words * sizeof(uint32_t);
+    memcpy(map_storage_revealed, buf, len);
+    return true;
 }
 
 void init_map_size(LevelNumber lvnum)
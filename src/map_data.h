@@ -43,7 +43,6 @@ struct Map {
       unsigned char wibble_value;
       ColumnIndex col_idx;
       ThingIndex mapwho;
-      PlayerBitFlags revealed;
 };
 
 #define INVALID_MAP_BLOCK (&bad_map_block)
@@ -86,6 +85,10 @@ TbBool subtile_revealed_directly(MapSubtlCoord stl_x, MapSubtlCoord stl_y, Playe
 #define thing_revealed(thing, plyr_idx) subtile_revealed(thing->mappos.x.stl.num, thing->mappos.y.stl.num, plyr_idx)
 void reveal_map_block(struct Map *mapblk, PlayerNumber plyr_idx);
 void conceal_map_block(struct Map *mapblk, PlayerNumber plyr_idx);
+PlayerBitFlags get_map_block_revealed_flags(const struct Map *mapblk);
+void set_map_block_revealed_flags(struct Map *mapblk, PlayerBitFlags flags);
+unsigned long count_player_revealed_subtiles(PlayerNumber plyr_idx);
+void clear_map_revealed(void);
 TbBool slabs_reveal_slab_and_corners(MapSlabCoord slab_x, MapSlabCoord slab_y, MaxCoordFilterParam param);
 TbBool slabs_change_owner(MapSlabCoord slab_x, MapSlabCoord slab_y, MaxCoordFilterParam param);
 TbBool slabs_change_type(MapSlabCoord slab_x, MapSlabCoord slab_y, MaxCoordFilterParam param);
@@ -138,6 +141,7 @@ void clear_slab_dig(MapSlabCoord slb_x, MapSlabCoord slb_y, PlayerNumber plyr_id
 void player_reveal_map_area(PlayerNumber plyr_idx, MapSubtlCoord x, MapSubtlCoord y, MapSubtlDelta w, MapSubtlDelta h);
 void player_conceal_map_area(PlayerNumber plyr_idx, MapSubtlCoord x, MapSubtlCoord y, MapSubtlDelta w, MapSubtlDelta h, TbBool all);
 void reveal_map_rect(PlayerNumber plyr_idx,MapSubtlCoord start_x,MapSubtlCoord end_x,MapSubtlCoord start_y,MapSubtlCoord end_y);
+void conceal_map_rect(PlayerNumber plyr_idx,MapSubtlCoord start_x,MapSubtlCoord end_x,MapSubtlCoord start_y,MapSubtlCoord end_y);
 void reveal_map_area(PlayerNumber plyr_idx,MapSubtlCoord start_x,MapSubtlCoord end_x,MapSubtlCoord start_y,MapSubtlCoord end_y);
 void conceal_map_area(PlayerNumber plyr_idx,MapSubtlCoord start_x,MapSubtlCoord end_x,MapSubtlCoord start_y,MapSubtlCoord end_y, TbBool all);
 void clear_mapwho(void);
@@ -145,6 +149,14 @@ void clear_mapmap(void);
 
 void set_map_size(MapSlabCoord slb_x,MapSlabCoord slb_y);
 void init_map_size(LevelNumber lvnum);
+SubtlCodedCoords get_map_storage_subtiles_count(void);
+SlabCodedCoords get_map_storage_slabs_count(void);
+size_t get_map_storage_data_size(void);
+TbBool setup_map_storage(void);
+void attach_map_storage(void);
+void free_map_storage(void);
+void pack_map_storage(unsigned char *buf);
+TbBool unpack_map_storage(const unsigned char *buf, size_t buf_len);
 /******************************************************************************/
 #ifdef __cplusplus
 }
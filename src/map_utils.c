@@ -95,20 +95,30 @@ struct Around const start_at_around[] = {
 };
 
 struct MapOffset spiral_step[SPIRAL_STEPS_COUNT];
+/** Max distance in any axis reached by a spiral of given length. */
+unsigned char spiral_step_extent[SPIRAL_STEPS_COUNT+1];
+/** Whether spirals fully inside the map may skip coordinates checks. */
+TbBool spiral_fast_path_enabled = true;
 
 /******************************************************************************/
 #ifdef __cplusplus
 }
 #endif
 /******************************************************************************/
+/**
+ * Fills spiral steps array. Coded offsets depend on map size, so this is re-done when the size changes.
+ */
 void init_spiral_steps(void)
 {
+    const short stl_per_row = game.map_subtiles_x + 1;
     long y = 0;
     long x = 0;
     struct MapOffset* sstep = &spiral_step[0];
     sstep->h = y;
     sstep->v = x;
-    sstep->both = (short)y + ((short)x * game.map_subtiles_y);
+    sstep->both = (short)y + ((short)x * stl_per_row);
+    spiral_step_extent[0] = 0;
+    spiral_step_extent[1] = 0;
     y = -1;
     x = -1;
     for (long i = 1; i < SPIRAL_STEPS_COUNT; i++)
@@ -116,7 +126,8 @@ void init_spiral_steps(void)
       sstep = &spiral_step[i];
       sstep->h = y;
       sstep->v = x;
-      sstep->both = (short)y + ((short)x * game.map_subtiles_y);
+      sstep->both = (short)y + ((short)x * stl_per_row);
+      spiral_step_extent[i+1] = max(spiral_step_extent[i], max(abs(x), abs(y)));
       if ((y < 0) && (x-y == 1))
       {
           y--;
@@ -152,6 +163,24 @@ void init_spiral_steps(void)
     }
 }
 
+/**
+ * Returns map block at center of a spiral, if the whole spiral fits within the map.
+ * Blocks of further spiral steps are then at the center block plus MapOffset::both,
+ * without a need to check coordinates of each step.
+ * @return The center map block, or NULL if coordinates of each step have to be checked.
+ */
+struct Map *get_spiral_center_map_block(MapSubtlCoord stl_x, MapSubtlCoord stl_y, long spiral_len)
+{
+    if (!spiral_fast_path_enabled || (spiral_len > SPIRAL_STEPS_COUNT))
+        return NULL;
+    MapSubtlDelta extent = spiral_step_extent[max(spiral_len, 0)];
+    if ((stl_x - extent < 0) || (stl_x + extent > game.map_subtiles_x))
+        return NULL;
+    if ((stl_y - extent < 0) || (stl_y + extent > game.map_subtiles_y))
+        return NULL;
+    return get_map_block_at(stl_x, stl_y);
+}
+
 /**
  * Returns minimal floor and ceiling heights for subtiles in given range.
  * @param stl_x_beg First subtile to be checked, X coord.
@@ -303,13 +332,13 @@ TbBool get_position_spiral_near_map_block_with_filter(struct Coord3d *retpos, Ma
 {
     SYNCDBG(19,"Starting");
     long maximizer = 0;
+    struct Map* center_blk = get_spiral_center_map_block(coord_subtile(x), coord_subtile(y), spiral_len);
     for (int around_val = 0; around_val < spiral_len; around_val++)
     {
         struct MapOffset* sstep = &spiral_step[around_val];
         MapSubtlCoord sx = coord_subtile(x) + (MapSubtlCoord)sstep->h;
         MapSubtlCoord sy = coord_subtile(y) + (MapSubtlCoord)sstep->v;
-        struct Map* mapblk = get_map_block_at(sx, sy);
-        if (!map_block_invalid(mapblk))
+        if ((center_blk != NULL) || !subtile_coords_invalid(sx, sy))
         {
             long n = maximizer;
             struct Coord3d newpos;
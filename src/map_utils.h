@@ -38,7 +38,8 @@ struct Coord3d;
 struct MapOffset {
   char v;
   char h;
-  unsigned short both;
+  /** Offset of subtile number, valid for current map size. */
+  short both;
 };
 
 #pragma pack()
@@ -69,6 +70,8 @@ struct CompoundCoordFilterParam {
 
 /******************************************************************************/
 extern struct MapOffset spiral_step[SPIRAL_STEPS_COUNT];
+extern unsigned char spiral_step_extent[SPIRAL_STEPS_COUNT+1];
+extern TbBool spiral_fast_path_enabled;
 /******************************************************************************/
 #define AROUND_TILES_COUNT      9
 extern struct Around const around[];
@@ -91,6 +94,7 @@ extern struct Around const my_around_nine[];
 
 /******************************************************************************/
 void init_spiral_steps(void);
+struct Map *get_spiral_center_map_block(MapSubtlCoord stl_x, MapSubtlCoord stl_y, long spiral_len);
 
 void get_min_floor_and_ceiling_heights_for_rect(MapSubtlCoord stl_x_beg, MapSubtlCoord stl_y_beg,
     MapSubtlCoord stl_x_end, MapSubtlCoord stl_y_end,
@@ -139,21 +139,19 @@ static TbBigChecksum get_room_checksum(const struct Room* room) {
 
 static TbBigChecksum compute_things_list_checksum(struct StructureList *list) {
     TbBigChecksum sum = 0;
-    unsigned long k = 0;
-    int i = list->index;
-    while (i != 0) {
-        struct Thing* thing = thing_get(i);
+    // The sum does not depend on order, so go through the dense pool instead of the linked list
+    const struct ThingClassPool* pool = get_thing_pool_for_list(list);
+    if (pool == NULL) {
+        ERRORLOG("No pool for things list");
+        return sum;
+    }
+    for (ThingIndex k = 0; k < pool->count; k++) {
+        struct Thing* thing = thing_get(pool->items[k]);
         if (thing_is_invalid(thing)) {
-            ERRORLOG("Jump to invalid thing detected in list");
+            ERRORLOG("Invalid thing detected in pool");
             break;
         }
-        i = thing->next_of_class;
         sum += get_thing_checksum(thing);
-        k++;
-        if (k > THINGS_COUNT) {
-            ERRORLOG("Infinite loop detected in thing list");
-            break;
-        }
     }
     return sum;
 }
@@ -29,6 +29,7 @@
 #include "game_legacy.h"
 #include "lens_api.h"
 #include "lua_base.h"
+#include "map_data.h"
 #include "net_input_lag.h"
 #include "net_checksums.h"
 #include "keeperfx.hpp"
@@ -343,7 +344,10 @@ TbBool send_resync_game(void)
             return false;
         }
     }
-    size_t lua_data_offset = sizeof(game) + sizeof(uint32_t);
+    // Map storage is outside of the Game structure, and only its used part is sent
+    size_t map_data_len = get_map_storage_data_size();
+    size_t map_data_offset = sizeof(game) + sizeof(uint32_t);
+    size_t lua_data_offset = map_data_offset + map_data_len + sizeof(uint32_t);
     if (lua_data_len > UINT32_MAX - lua_data_offset) {
         ERRORLOG("Full resync data too large");
         cleanup_serialized_data();
@@ -358,9 +362,12 @@ TbBool send_resync_game(void)
         return false;
     }
 
+    uint32_t map_data_len32 = (uint32_t)map_data_len;
     uint32_t lua_data_len32 = (uint32_t)lua_data_len;
     memcpy(full_resync_data, &game, sizeof(game));
-    memcpy(full_resync_data + sizeof(game), &lua_data_len32, sizeof(lua_data_len32));
+    memcpy(full_resync_data + sizeof(game), &map_data_len32, sizeof(map_data_len32));
+    pack_map_storage((unsigned char *)full_resync_data + map_data_offset);
+    memcpy(full_resync_data + lua_data_offset - sizeof(lua_data_len32), &lua_data_len32, sizeof(lua_data_len32));
     memcpy(full_resync_data + lua_data_offset, lua_data, lua_data_len);
     TbBool result = send_resync_data(full_resync_data, full_resync_len);
     free(full_resync_data);
@@ -381,20 +388,28 @@ TbBool receive_resync_game(void)
     NETLOG("Initiating re-synchronization of network game");
     char * full_resync_data = NULL;
     size_t full_resync_len = 0;
+    uint32_t map_data_len = 0;
     uint32_t lua_data_len = 0;
-    size_t lua_data_offset = sizeof(game) + sizeof(lua_data_len);
+    size_t map_data_offset = sizeof(game) + sizeof(map_data_len);
 
     if (!receive_resync_data(&full_resync_data, &full_resync_len)) {
         return false;
     }
 
-    if (full_resync_len < lua_data_offset) {
+    if (full_resync_len < map_data_offset) {
         ERRORLOG("Full resync data too small: %u bytes", (uint32_t)full_resync_len);
         free(full_resync_data);
         return false;
     }
+    memcpy(&map_data_len, full_resync_data + sizeof(game), sizeof(map_data_len));
+    size_t lua_data_offset = map_data_offset + map_data_len + sizeof(lua_data_len);
+    if ((map_data_len > full_resync_len) || (full_resync_len < lua_data_offset)) {
+        ERRORLOG("Full resync data too small for map data: %u bytes", (uint32_t)full_resync_len);
+        free(full_resync_data);
+        return false;
+    }
 
-    memcpy(&lua_data_len, full_resync_data + sizeof(game), sizeof(lua_data_len));
+    memcpy(&lua_data_len, full_resync_data + lua_data_offset - sizeof(lua_data_len), sizeof(lua_data_len));
     if (lua_data_len != full_resync_len - lua_data_offset) {
         ERRORLOG("Received lua data with wrong size: %u != %u", lua_data_len, (uint32_t)(full_resync_len - lua_data_offset));
         free(full_resync_data);
@@ -413,6 +428,11 @@ TbBool receive_resync_game(void)
     }
 
     memcpy(&game, full_resync_data, sizeof(game));
+    // Restore map storage pointers, resizing the storage to map of the host
+    if (!unpack_map_storage((const unsigned char *)full_resync_data + map_data_offset, map_data_len)) {
+        free(full_resync_data);
+        return false;
+    }
     free(full_resync_data);
 
     animate_resync_progress_bar(2, 6);
@@ -0,0 +1,488 @@
+/******************************************************************************/
+// Free implementation of Bullfrog's Dungeon Keeper strategy game.
+/******************************************************************************/
+/** @file player_compdigfld.c
+ *     Computer player dig cost field.
+ * @par Purpose:
+ *     Keeps, for every computer player, cost of digging from its territory
+ *     to each slab of the map. Used to evaluate dig targets without simulating
+ *     the digging slab by slab.
+ * @par Comment:
+ *     The field is rebuilt with Dijkstra search from all owned slabs. When
+ *     slabs change in a way which only makes digging cheaper, the field is
+ *     updated incrementally from the changed slabs.
+ * @author   KeeperFX Team
+ * @date     19 Oct 2026 - 19 Oct 2026
+ * @par  Copying and copyrights:
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ */
+/******************************************************************************/
+#include "pre_inc.h"
+#include "player_compdigfld.h"
+
+#include <string.h>
+
+#include "globals.h"
+#include "bflib_basics.h"
+
+#include "ariadne.h"
+#include "config_terrain.h"
+#include "map_data.h"
+#include "map_utils.h"
+#include "slab_data.h"
+#include "player_computer.h"
+#include "player_data.h"
+#include "game_legacy.h"
+#include "post_inc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************/
+/** Cost of entering a slab while digging towards a target. */
+enum DigFieldStepCosts {
+    DigFld_Source        =   0, /**< Walkable slab owned by the player; digging starts there. */
+    DigFld_Walk          =   1, /**< Walkable slab which doesn't need digging. */
+    DigFld_WalkHostile   =   3, /**< Walkable slab owned by an enemy. */
+    DigFld_DigEarth      =   3,
+    DigFld_DigOwnWall    =   3,
+    DigFld_DigValuable   =   4,
+    DigFld_BridgeWater   =   4,
+    DigFld_BridgeLava    =   5,
+    DigFld_Blocked       = 255, /**< Slab which can't be dug nor walked through. */
+};
+
+enum DigFieldBridgeFlags {
+    DigFldBrdg_None  = 0x00,
+    DigFldBrdg_Water = 0x01,
+    DigFldBrdg_Lava  = 0x02,
+};
+
+#define DIG_FIELD_SLABS_MAX (MAX_TILES_X*MAX_TILES_Y)
+/** Dijkstra heap size; every slab is pushed once as source and at most once per neighbour. */
+#define DIG_FIELD_HEAP_LEN (5*DIG_FIELD_SLABS_MAX)
+
+struct ComputerDigField {
+    TbBool valid;
+    TbBool rebuild_needed;
+    unsigned char bridge_flags;
+    PlayerBitFlags enemy_flags;
+    MapSlabCoord tiles_x;
+    MapSlabCoord tiles_y;
+    unsigned short changed_count;
+    SlabCodedCoords changed_slabs[DIG_FIELD_CHANGED_SLABS_COUNT];
+    uint32_t cost[DIG_FIELD_SLABS_MAX];
+    unsigned char step_cost[DIG_FIELD_SLABS_MAX];
+};
+/******************************************************************************/
+static struct ComputerDigField computer_dig_fields[PLAYERS_COUNT];
+/** Heap items have cost in high 32 bits and slab number in low ones. */
+static uint64_t dig_field_heap[DIG_FIELD_HEAP_LEN];
+static long dig_field_heap_len;
+/******************************************************************************/
+static TbBool dig_field_heap_push(uint32_t cost, SlabCodedCoords slb_num)
+{
+    if (dig_field_heap_len >= DIG_FIELD_HEAP_LEN) {
+        ERRORLOG("Dig field heap overflow");
+        return false;
+    }
+    uint64_t item = ((uint64_t)cost << 32) | slb_num;
+    long i = dig_field_heap_len++;
+    while (i > 0)
+    {
+        long parent = (i - 1) / 2;
+        if (dig_field_heap[parent] <= item)
+            break;
+        dig_field_heap[i] = dig_field_heap[parent];
+        i = parent;
+    }
+    dig_field_heap[i] = item;
+    return true;
+}
+
+static uint64_t dig_field_heap_pop(void)
+{
+    uint64_t top = dig_field_heap[0];
+    uint64_t item = dig_field_heap[--dig_field_heap_len];
+    long i = 0;
+    while (1)
+    {
+        long child = 2 * i + 1;
+        if (child >= dig_field_heap_len)
+            break;
+        if ((child + 1 < dig_field_heap_len) && (dig_field_heap[child + 1] < dig_field_heap[child]))
+            child++;
+        if (item <= dig_field_heap[child])
+            break;
+        dig_field_heap[i] = dig_field_heap[child];
+        i = child;
+    }
+    if (dig_field_heap_len > 0)
+        dig_field_heap[i] = item;
+    return top;
+}
+
+/**
+ * Gives cost of entering given slab when digging towards a target.
+ * Mirrors the rules used by tool_dig_to_pos2() when it decides whether to walk, dig or bridge.
+ */
+static unsigned char computer_dig_field_step_cost(PlayerNumber plyr_idx, unsigned char bridge_flags,
+    MapSlabCoord slb_x, MapSlabCoord slb_y, TbBool allow_valuable)
+{
+    struct SlabMap* slb = get_slabmap_block(slb_x, slb_y);
+    PlayerNumber slb_owner = slabmap_owner(slb);
+    if (slab_kind_is_door(slb->kind) && (slb_owner != plyr_idx))
+        return DigFld_Blocked;
+    if (slb->kind == SlbT_WATER)
+        return flag_is_set(bridge_flags, DigFldBrdg_Water) ? DigFld_BridgeWater : DigFld_Blocked;
+    if (slb->kind == SlbT_LAVA)
+        return flag_is_set(bridge_flags, DigFldBrdg_Lava) ? DigFld_BridgeLava : DigFld_Blocked;
+    if (!slab_good_for_computer_dig_path(slb))
+    {
+        if (slb_owner == plyr_idx)
+            return DigFld_Source;
+        if (players_are_enemies(plyr_idx, slb_owner))
+            return DigFld_WalkHostile;
+        return DigFld_Walk;
+    }
+    const struct SlabConfigStats* slabst = get_slab_stats(slb);
+    struct Map* mapblk = get_map_block_at(slab_subtile_center(slb_x), slab_subtile_center(slb_y));
+    if ((slabst->is_diggable == 0) || (slb->kind == SlbT_GEMS)
+      || (flag_is_set(mapblk->flags, SlbAtFlg_Filled) && (slb_owner != plyr_idx)))
+    {
+        if (flag_is_set(slabst->block_flags, SlbAtFlg_Valuable) && allow_valuable)
+            return DigFld_DigValuable;
+        return DigFld_Blocked;
+    }
+    if (flag_is_set(slabst->block_flags, SlbAtFlg_Valuable))
+        return DigFld_DigValuable;
+    if (flag_is_set(mapblk->flags, SlbAtFlg_Filled))
+        return DigFld_DigOwnWall;
+    return DigFld_DigEarth;
+}
+
+static unsigned char get_computer_dig_field_bridge_flags(const struct Computer2 *comp)
+{
+    unsigned char bridge_flags = DigFldBrdg_None;
+    if (computer_check_room_of_role_available(comp, RoRoF_PassWater) == IAvail_Now)
+        set_flag(bridge_flags, DigFldBrdg_Water);
+    if (computer_check_room_of_role_available(comp, RoRoF_PassLava) == IAvail_Now)
+        set_flag(bridge_flags, DigFldBrdg_Lava);
+    return bridge_flags;
+}
+
+static PlayerBitFlags get_computer_dig_field_enemy_flags(PlayerNumber plyr_idx)
+{
+    PlayerBitFlags enemy_flags = 0;
+    for (PlayerNumber i = 0; i < PLAYERS_COUNT; i++)
+    {
+        if (players_are_enemies(plyr_idx, i))
+            set_flag(enemy_flags, to_flag(i));
+    }
+    return enemy_flags;
+}
+
+/**
+ * Lowers costs of slabs reachable from the ones put on heap, until the heap is empty.
+ */
+static void computer_dig_field_propagate(struct ComputerDigField *dfield)
+{
+    while (dig_field_heap_len > 0)
+    {
+        uint64_t item = dig_field_heap_pop();
+        uint32_t ccost = (uint32_t)(item >> 32);
+        SlabCodedCoords slb_num = (SlabCodedCoords)(item & 0xFFFFFFFF);
+        // Skip items which were put on heap before a cheaper way was found
+        if (ccost != dfield->cost[slb_num])
+            continue;
+        MapSlabCoord slb_x = slb_num % dfield->tiles_x;
+        MapSlabCoord slb_y = slb_num / dfield->tiles_x;
+        for (int n = 0; n < SMALL_AROUND_LENGTH; n++)
+        {
+            MapSlabCoord nslb_x = slb_x + small_around[n].delta_x;
+            MapSlabCoord nslb_y = slb_y + small_around[n].delta_y;
+            if ((nslb_x < 0) || (nslb_x >= dfield->tiles_x) || (nslb_y < 0) || (nslb_y >= dfield->tiles_y))
+                continue;
+            SlabCodedCoords nslb_num = nslb_y * dfield->tiles_x + nslb_x;
+            unsigned char step = dfield->step_cost[nslb_num];
+            if (step == DigFld_Blocked)
+                continue;
+            uint32_t ncost = ccost + step;
+            if (ncost < dfield->cost[nslb_num])
+            {
+                dfield->cost[nslb_num] = ncost;
+                if (!dig_field_heap_push(ncost, nslb_num))
+                    return;
+            }
+        }
+    }
+}
+
+static void computer_dig_field_rebuild(struct ComputerDigField *dfield, PlayerNumber plyr_idx)
+{
+    SYNCDBG(8,"Rebuilding dig field of player %d",(int)plyr_idx);
+    dig_field_heap_len = 0;
+    for (MapSlabCoord slb_y = 0; slb_y < dfield->tiles_y; slb_y++)
+    {
+        for (MapSlabCoord slb_x = 0; slb_x < dfield->tiles_x; slb_x++)
+        {
+            SlabCodedCoords slb_num = slb_y * dfield->tiles_x + slb_x;
+            unsigned char step = computer_dig_field_step_cost(plyr_idx, dfield->bridge_flags, slb_x, slb_y, false);
+            dfield->step_cost[slb_num] = step;
+            if (step == DigFld_Source) {
+                dfield->cost[slb_num] = 0;
+                dig_field_heap_push(0, slb_num);
+            } else {
+                dfield->cost[slb_num] = DIG_FIELD_COST_UNREACHABLE;
+            }
+        }
+    }
+    computer_dig_field_propagate(dfield);
+}
+
+/**
+ * Updates the field after slab changes.
+ * @return True if the field was updated, false if the changes need a full rebuild.
+ */
+static TbBool computer_dig_field_apply_changes(struct ComputerDigField *dfield, PlayerNumber plyr_idx)
+{
+    // Changes which make digging cheaper can only lower costs, so Dijkstra can continue from the changed slabs.
+    // Anything which makes a slab more expensive could raise costs of any slab behind it.
+    for (long i = 0; i < dfield->changed_count; i++)
+    {
+        SlabCodedCoords slb_num = dfield->changed_slabs[i];
+        MapSlabCoord slb_x = slb_num % dfield->tiles_x;
+        MapSlabCoord slb_y = slb_num / dfield->tiles_x;
+        if (computer_dig_field_step_cost(plyr_idx, dfield->bridge_flags, slb_x, slb_y, false) > dfield->step_cost[slb_num])
+            return false;
+    }
+    dig_field_heap_len = 0;
+    for (long i = 0; i < dfield->changed_count; i++)
+    {
+        SlabCodedCoords slb_num = dfield->changed_slabs[i];
+        MapSlabCoord slb_x = slb_num % dfield->tiles_x;
+        MapSlabCoord slb_y = slb_num / dfield->tiles_x;
+        unsigned char step = computer_dig_field_step_cost(plyr_idx, dfield->bridge_flags, slb_x, slb_y, false);
+        dfield->step_cost[slb_num] = step;
+        uint32_t new_cost = DIG_FIELD_COST_UNREACHABLE;
+        if (step == DigFld_Source)
+        {
+            new_cost = 0;
+        } else
+        if (step != DigFld_Blocked)
+        {
+            for (int n = 0; n < SMALL_AROUND_LENGTH; n++)
+            {
+                MapSlabCoord nslb_x = slb_x + small_around[n].delta_x;
+                MapSlabCoord nslb_y = slb_y + small_around[n].delta_y;
+                if ((nslb_x < 0) || (nslb_x >= dfield->tiles_x) || (nslb_y < 0) || (nslb_y >= dfield->tiles_y))
+                    continue;
+                uint32_t ncost = dfield->cost[nslb_y * dfield->tiles_x + nslb_x];
+                if ((ncost != DIG_FIELD_COST_UNREACHABLE) && (ncost + step < new_cost))
+                    new_cost = ncost + step;
+            }
+        }
+        if (new_cost < dfield->cost[slb_num])
+        {
+            dfield->cost[slb_num] = new_cost;
+            if (!dig_field_heap_push(new_cost, slb_num))
+                return false;
+        }
+    }
+    computer_dig_field_propagate(dfield);
+    return true;
+}
+
+/**
+ * Returns dig field of given computer player, making sure it reflects the current map.
+ */
+static struct ComputerDigField *get_updated_computer_dig_field(const struct Computer2 *comp)
+{
+    PlayerNumber plyr_idx = comp->dungeon->owner;
+    if ((plyr_idx < 0) || (plyr_idx >= PLAYERS_COUNT))
+        return NULL;
+    if ((game.map_tiles_x <= 0) || (game.map_tiles_y <= 0) || (game.map_tiles_x * game.map_tiles_y > DIG_FIELD_SLABS_MAX))
+        return NULL;
+    struct ComputerDigField* dfield = &computer_dig_fields[plyr_idx];
+    unsigned char bridge_flags = get_computer_dig_field_bridge_flags(comp);
+    PlayerBitFlags enemy_flags = get_computer_dig_field_enemy_flags(plyr_idx);
+    if ((dfield->tiles_x != game.map_tiles_x) || (dfield->tiles_y != game.map_tiles_y)
+     || (dfield->bridge_flags != bridge_flags) || (dfield->enemy_flags != enemy_flags))
+    {
+        dfield->tiles_x = game.map_tiles_x;
+        dfield->tiles_y = game.map_tiles_y;
+        dfield->bridge_flags = bridge_flags;
+        dfield->enemy_flags = enemy_flags;
+        dfield->rebuild_needed = true;
+    }
+    if (!dfield->valid || dfield->rebuild_needed)
+    {
+        computer_dig_field_rebuild(dfield, plyr_idx);
+    } else
+    if (dfield->changed_count > 0)
+    {
+        if (!computer_dig_field_apply_changes(dfield, plyr_idx))
+            computer_dig_field_rebuild(dfield, plyr_idx);
+    }
+    dfield->valid = true;
+    dfield->rebuild_needed = false;
+    dfield->changed_count = 0;
+    return dfield;
+}
+
+/**
+ * Finds cheapest way of digging into given slab, which is the final slab of a route.
+ * @param slb_num_via Output slab number through which the slab is best reached, or the slab itself if it's cheaper.
+ */
+static uint32_t computer_dig_field_target_cost(const struct ComputerDigField *dfield, PlayerNumber plyr_idx,
+    MapSlabCoord slb_x, MapSlabCoord slb_y, TbBool allow_valuable, SlabCodedCoords *slb_num_via)
+{
+    SlabCodedCoords slb_num = slb_y * dfield->tiles_x + slb_x;
+    uint32_t best_cost = dfield->cost[slb_num];
+    *slb_num_via = slb_num;
+    // The final slab is dug last, so it may be a valuable slab which would block the way through
+    unsigned char step = computer_dig_field_step_cost(plyr_idx, dfield->bridge_flags, slb_x, slb_y, allow_valuable);
+    if (step == DigFld_Blocked)
+        return best_cost;
+    for (int n = 0; n < SMALL_AROUND_LENGTH; n++)
+    {
+        MapSlabCoord nslb_x = slb_x + small_around[n].delta_x;
+        MapSlabCoord nslb_y = slb_y + small_around[n].delta_y;
+        if ((nslb_x < 0) || (nslb_x >= dfield->tiles_x) || (nslb_y < 0) || (nslb_y >= dfield->tiles_y))
+            continue;
+        SlabCodedCoords nslb_num = nslb_y * dfield->tiles_x + nslb_x;
+        uint32_t ncost = dfield->cost[nslb_num];
+        if ((ncost != DIG_FIELD_COST_UNREACHABLE) && (ncost + step < best_cost))
+        {
+            best_cost = ncost + step;
+            *slb_num_via = nslb_num;
+        }
+    }
+    return best_cost;
+}
+
+/******************************************************************************/
+/**
+ * Invalidates dig fields of all players. To be called when a new map is loaded.
+ */
+void clear_computer_dig_fields(void)
+{
+    for (PlayerNumber plyr_idx = 0; plyr_idx < PLAYERS_COUNT; plyr_idx++)
+    {
+        struct ComputerDigField* dfield = &computer_dig_fields[plyr_idx];
+        dfield->valid = false;
+        dfield->changed_count = 0;
+    }
+}
+
+/**
+ * Informs dig fields that kind or owner of given slab has changed.
+ */
+void computer_dig_field_slab_changed(MapSlabCoord slb_x, MapSlabCoord slb_y)
+{
+    for (PlayerNumber plyr_idx = 0; plyr_idx < PLAYERS_COUNT; plyr_idx++)
+    {
+        struct ComputerDigField* dfield = &computer_dig_fields[plyr_idx];
+        if (!dfield->valid || dfield->rebuild_needed)
+            continue;
+        if ((slb_x < 0) || (slb_x >= dfield->tiles_x) || (slb_y < 0) || (slb_y >= dfield->tiles_y))
+            continue;
+        if (dfield->changed_count >= DIG_FIELD_CHANGED_SLABS_COUNT) {
+            dfield->rebuild_needed = true;
+            continue;
+        }
+        dfield->changed_slabs[dfield->changed_count] = slb_y * dfield->tiles_x + slb_x;
+        dfield->changed_count++;
+    }
+}
+
+/**
+ * Gives cost of digging from computer player territory to given slab.
+ * @param comp Computer player.
+ * @param slb_x Target slab X coordinate.
+ * @param slb_y Target slab Y coordinate.
+ * @param allow_valuable Whether the target may be a valuable slab which is not normally dug through.
+ * @return The cost, or DIG_FIELD_COST_UNREACHABLE if the slab can't be reached by digging.
+ */
+uint32_t computer_dig_field_cost_to_slab(struct Computer2 *comp, MapSlabCoord slb_x, MapSlabCoord slb_y, TbBool allow_valuable)
+{
+    struct ComputerDigField* dfield = get_updated_computer_dig_field(comp);
+    if (dfield == NULL)
+        return DIG_FIELD_COST_UNREACHABLE;
+    if ((slb_x < 0) || (slb_x >= dfield->tiles_x) || (slb_y < 0) || (slb_y >= dfield->tiles_y))
+        return DIG_FIELD_COST_UNREACHABLE;
+    SlabCodedCoords slb_num_via;
+    return computer_dig_field_target_cost(dfield, comp->dungeon->owner, slb_x, slb_y, allow_valuable, &slb_num_via);
+}
+
+/**
+ * Traces the cheapest dig route from computer player territory to given position, by descending the dig field.
+ * @param comp Computer player.
+ * @param startpos Digging start point; updated to the territory slab where the route begins if it is connected to it.
+ * @param endpos Digging final point.
+ * @param dig_distance Value which is increased by the amount of slabs on the route.
+ * @param allow_valuable Whether the target may be a valuable slab which is not normally dug through.
+ * @return True if the target can be reached, false otherwise.
+ */
+TbBool computer_dig_field_trace_route(struct Computer2 *comp, struct Coord3d *startpos, const struct Coord3d *endpos,
+    uint32_t *dig_distance, TbBool allow_valuable)
+{
+    struct ComputerDigField* dfield = get_updated_computer_dig_field(comp);
+    if (dfield == NULL)
+        return false;
+    MapSlabCoord slb_x = coord_slab(endpos->x.val);
+    MapSlabCoord slb_y = coord_slab(endpos->y.val);
+    if ((slb_x < 0) || (slb_x >= dfield->tiles_x) || (slb_y < 0) || (slb_y >= dfield->tiles_y))
+        return false;
+    SlabCodedCoords slb_num;
+    if (computer_dig_field_target_cost(dfield, comp->dungeon->owner, slb_x, slb_y, allow_valuable, &slb_num) == DIG_FIELD_COST_UNREACHABLE)
+        return false;
+    if (slb_num != (SlabCodedCoords)(slb_y * dfield->tiles_x + slb_x))
+        (*dig_distance)++;
+    // Every slab with non-zero cost has a cheaper neighbour which leads towards the territory
+    long k = 0;
+    while (dfield->cost[slb_num] > 0)
+    {
+        slb_x = slb_num % dfield->tiles_x;
+        slb_y = slb_num / dfield->tiles_x;
+        SlabCodedCoords best_slb_num = slb_num;
+        for (int n = 0; n < SMALL_AROUND_LENGTH; n++)
+        {
+            MapSlabCoord nslb_x = slb_x + small_around[n].delta_x;
+            MapSlabCoord nslb_y = slb_y + small_around[n].delta_y;
+            if ((nslb_x < 0) || (nslb_x >= dfield->tiles_x) || (nslb_y < 0) || (nslb_y >= dfield->tiles_y))
+                continue;
+            SlabCodedCoords nslb_num = nslb_y * dfield->tiles_x + nslb_x;
+            if (dfield->cost[nslb_num] < dfield->cost[best_slb_num])
+                best_slb_num = nslb_num;
+        }
+        if (best_slb_num == slb_num)
+        {
+            ERRORLOG("Dig field of player %d has no descent at slab (%d,%d)",(int)comp->dungeon->owner,(int)slb_x,(int)slb_y);
+            return false;
+        }
+        slb_num = best_slb_num;
+        (*dig_distance)++;
+        k++;
+        if (k > dfield->tiles_x * dfield->tiles_y)
+        {
+            ERRORLOG("Infinite loop detected when descending dig field");
+            return false;
+        }
+    }
+    struct Coord3d pos;
+    pos.x.val = subtile_coord_center(slab_subtile_center(slb_num % dfield->tiles_x));
+    pos.y.val = subtile_coord_center(slab_subtile_center(slb_num / dfield->tiles_x));
+    pos.z.val = startpos->z.val;
+    if (navigation_points_connected(startpos, &pos)) {
+        *startpos = pos;
+    }
+    return true;
+}
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,47 @@
+/******************************************************************************/
+// Free implementation of Bullfrog's Dungeon Keeper strategy game.
+/******************************************************************************/
+/** @file player_compdigfld.h
+ *     Header file for player_compdigfld.c.
+ * @par Purpose:
+ *     Computer player dig cost field definitions.
+ * @par Comment:
+ *     Just a header file - #defines, typedefs, function prototypes etc.
+ * @author   KeeperFX Team
+ * @date     19 Oct 2026 - 19 Oct 2026
+ * @par  Copying and copyrights:
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ */
+/******************************************************************************/
+#ifndef DK_PLYR_COMPDIGFLD_H
+#define DK_PLYR_COMPDIGFLD_H
+
+#include "bflib_basics.h"
+#include "globals.h"
+
+/** Dig cost of slabs which can't be reached by digging. */
+#define DIG_FIELD_COST_UNREACHABLE UINT32_MAX
+/** Amount of changed slabs remembered for incremental update; more changes lead to full rebuild. */
+#define DIG_FIELD_CHANGED_SLABS_COUNT 64
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************/
+struct Computer2;
+struct Coord3d;
+
+/******************************************************************************/
+void clear_computer_dig_fields(void);
+void computer_dig_field_slab_changed(MapSlabCoord slb_x, MapSlabCoord slb_y);
+uint32_t computer_dig_field_cost_to_slab(struct Computer2 *comp, MapSlabCoord slb_x, MapSlabCoord slb_y, TbBool allow_valuable);
+TbBool computer_dig_field_trace_route(struct Computer2 *comp, struct Coord3d *startpos, const struct Coord3d *endpos,
+    uint32_t *dig_distance, TbBool allow_valuable);
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+#endif
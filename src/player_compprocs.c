@@ -30,6 +30,7 @@
 #include "config.h"
 #include "config_terrain.h"
 #include "player_instances.h"
+#include "player_compdigfld.h"
 #include "room_lair.h"
 #include "room_list.h"
 #include "creature_states.h"
@@ -514,7 +515,10 @@ long computer_finds_nearest_entrance2(struct Computer2 *comp, struct Coord3d *st
         // Per-room code
         MapSubtlCoord from_stl_x = entroom->central_stl_x;
         MapSubtlCoord from_stl_y = entroom->central_stl_y;
-        if ((entroom->owner == from_plyr_idx) && ((entroom->player_interested[dungeon->owner] & 3) == 0))
+        // Skip entrances which the dig evaluation would reject anyway
+        TbBool reachable = !comp->sim_before_dig
+            || (computer_dig_field_cost_to_slab(comp, subtile_slab(from_stl_x), subtile_slab(from_stl_y), false) != DIG_FIELD_COST_UNREACHABLE);
+        if (reachable && (entroom->owner == from_plyr_idx) && ((entroom->player_interested[dungeon->owner] & 3) == 0))
         {
             int32_t dist;
             struct Room* nearoom = get_player_room_any_kind_nearest_to(dungeon->owner, from_stl_x, from_stl_y, &dist);
@@ -535,7 +539,7 @@ long computer_finds_nearest_entrance2(struct Computer2 *comp, struct Coord3d *st
         }
         int32_t dist;
         struct ComputerTask* ctask = get_room_build_task_nearest_to(comp, from_stl_x, from_stl_y, &dist);
-        if (!computer_task_invalid(ctask) && (dist < near_dist)) {
+        if (reachable && !computer_task_invalid(ctask) && (dist < near_dist)) {
             near_dist = dist;
             near_entroom = entroom;
             near_startpos = &ctask->new_room_pos;
@@ -709,44 +713,17 @@ TbBool right_time_to_choose_target_entrance(struct ComputerProcess *cproc, long
 }
 
 /**
- * Simulates digging from and to given coords with given flags.
- * @param comp Computer player which does the simulation.
- * @param startpos Digging start point, may be updated in a berrer one is seen.
+ * Evaluates digging from and to given coords with given flags.
+ * The route is read from the computer player dig cost field, instead of simulating the digging slab by slab.
+ * @param comp Computer player which does the evaluation.
+ * @param startpos Digging start point, may be updated in a better one is seen.
  * @param endpos Digging final point, constant.
  * @param dig_distance Value which is increased by the amount of slabs travelled.
  * @param digflags Digging flags to be used.
  */
 TbBool simulate_dig_to(struct Computer2 *comp, struct Coord3d *startpos, const struct Coord3d *endpos, uint32_t *dig_distance, DigFlags digflags)
 {
-    struct Dungeon* dungeon = comp->dungeon;
-    struct ComputerDig cdig;
-    ToolDigResult dig_result;
-    // Setup the digging on dummy ComputerDig, to compute distance and move start position near to wall
-    setup_dig_to(&cdig, *startpos, *endpos);
-    while(1)
-    {
-        dig_result = tool_dig_to_pos2(comp, &cdig, true, digflags);
-        switch(dig_result)
-        {
-            case TDR_DigSlab:
-                // If the slab we've got from digging is safe to walk and connected to original room, use it as starting position
-                // But don't change distance - it should be computed from our rooms (and resetting it could lead to infinite loop)
-                // Note: when verifying the path traced by computer player, we might want to disable this to see the full path
-                if (slab_is_safe_land(dungeon->owner, coord_slab(cdig.pos_next.x.val), coord_slab(cdig.pos_next.y.val))) {
-                    if (navigation_points_connected(startpos, &cdig.pos_next)) {
-                        *startpos = cdig.pos_next;
-                    }
-                }
-                (*dig_distance)++;
-                continue;
-            case TDR_ReachedDestination:
-            case TDR_BuildBridgeOnSlab:
-                return true;
-            case TDR_ToolDigError:
-            default:
-                return false;
-        }
-    }
+    return computer_dig_field_trace_route(comp, startpos, endpos, dig_distance, flag_is_set(digflags, ToolDig_AllowValuable));
 }
 
 long computer_setup_dig_to_entrance(struct Computer2 *comp, struct ComputerProcess *cproc)
@@ -40,6 +40,7 @@
 #include "magic_powers.h"
 #include "map_utils.h"
 #include "player_complookup.h"
+#include "player_compdigfld.h"
 #include "player_utils.h"
 #include "power_hand.h"
 #include "room_data.h"
@@ -364,6 +365,12 @@ long computer_finds_nearest_room_to_gold(struct Computer2 *comp, struct Coord3d
             continue;
         SYNCDBG(8,"Searching for place to reach (%d,%d)",(int)gldlook->stl_x,(int)gldlook->stl_y);
         lookups_checked++;
+        // Skip veins which the dig evaluation would reject anyway
+        if (comp->sim_before_dig && (computer_dig_field_cost_to_slab(comp, subtile_slab(gldlook->stl_x), subtile_slab(gldlook->stl_y), true) == DIG_FIELD_COST_UNREACHABLE))
+        {
+            SYNCDBG(8,"Vein at (%d,%d) can't be reached by digging",(int)gldlook->stl_x,(int)gldlook->stl_y);
+            continue;
+        }
         struct Room *room = INVALID_ROOM;
         long new_dist = computer_finds_nearest_room_to_gold_lookup(dungeon, gldlook, &room);
         if (dig_distance > new_dist)
@@ -629,12 +636,12 @@ long count_entrances(const struct Computer2 *comp, PlayerNumber plyr_idx)
 
 long count_creatures_in_dungeon(const struct Dungeon *dungeon)
 {
-    return count_player_list_creatures_of_model(dungeon->creatr_list_start, CREATURE_ANY);
+    return count_dungeon_list_creatures_of_model(dungeon->creatr_list_of_model, dungeon->owner, CREATURE_ANY);
 }
 
 long count_diggers_in_dungeon(const struct Dungeon *dungeon)
 {
-    return count_player_list_creatures_of_model(dungeon->digger_list_start, CREATURE_ANY);
+    return count_dungeon_list_creatures_of_model(dungeon->digger_list_of_model, dungeon->owner, CREATURE_ANY);
 }
 
 /**
@@ -1581,6 +1588,7 @@ void setup_computer_players2(void)
   int i;
   game.turn_last_checked_for_gold = get_gameturn();
   check_map_for_gold();
+  clear_computer_dig_fields();
   for (i=0; i < COMPUTER_TASKS_COUNT; i++)
   {
     memset(&game.computer_task[i], 0, sizeof(struct ComputerTask));
@@ -1625,6 +1633,7 @@ void setup_computer_players2(void)
 void restore_computer_player_after_load(void)
 {
     SYNCDBG(7,"Starting");
+    clear_computer_dig_fields();
     for (long plyr_idx = 0; plyr_idx < PLAYERS_COUNT; plyr_idx++)
     {
         struct PlayerInfo* player = get_player(plyr_idx);
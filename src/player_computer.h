@@ -554,6 +554,7 @@ TbBool add_trap_location_if_requested(struct Computer2 *comp, struct ComputerTas
 int search_spiral_f(struct Coord3d *pos, PlayerNumber owner, int area_total, long (*cb)(MapSubtlCoord, MapSubtlCoord, long), const char *func_name);
 /******************************************************************************/
 ItemAvailability computer_check_room_available(const struct Computer2 * comp, RoomKind rkind);
+ItemAvailability computer_check_room_of_role_available(const struct Computer2 * comp, RoomRole rrole);
 TbBool computer_find_non_solid_block(const struct Computer2 *comp, struct Coord3d *pos);
 TbBool computer_find_safe_non_solid_block(const struct Computer2* comp, struct Coord3d* pos);
 
@@ -32,6 +32,7 @@
 #include "thing_objects.h"
 #include "power_hand.h"
 #include "gui_msgs.h"
+#include "creature_senses.h"
 #include "post_inc.h"
 
 /******************************************************************************/
@@ -276,6 +277,7 @@ void toggle_ally_with_player(PlayerNumber plyr_idx, PlayerNumber ally_idx)
     if (player_invalid(player))
         return;
     toggle_flag(player->allied_players, to_flag(ally_idx)); // toggle player ally_idx in player plyridx's allies list
+    invalidate_line_of_sight_cache();
 }
 
 TbBool set_ally_with_player(PlayerNumber plyr_idx, PlayerNumber ally_idx, TbBool make_ally)
@@ -289,7 +291,7 @@ TbBool set_ally_with_player(PlayerNumber plyr_idx, PlayerNumber ally_idx, TbBool
         set_flag(player->allied_players, to_flag(ally_idx)); // add player ally_idx to player plyridx's allies list
     else // enemy
         clear_flag(player->allied_players, to_flag(ally_idx)); // remove player ally_idx from player plyridx's allies list
-
+    invalidate_line_of_sight_cache();
     return true;
 }
 
@@ -620,14 +620,7 @@ void fill_in_explored_area(PlayerNumber plyr_idx, MapSubtlCoord stl_x, MapSubtlC
         }
     }
 
-    for(MapSubtlCoord lpstl_y = 0;lpstl_y < game.map_subtiles_y;lpstl_y++)
-    {
-        for(MapSubtlCoord lpstl_x = 0;lpstl_x < game.map_subtiles_x;lpstl_x++)
-        {
-            struct Map *mapblk = get_map_block_at(lpstl_x,lpstl_y);
-            conceal_map_block(mapblk, plyr_idx);
-        }
-    }
+    conceal_map_rect(plyr_idx, 0, game.map_subtiles_x, 0, game.map_subtiles_y);
 
     queue_read_index = 0;
     queue_write_index = 0;
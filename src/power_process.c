@@ -516,10 +516,10 @@ void update_vertical_explored_flags_for_power_sight(struct PlayerInfo *player, s
                     {
                         delta = boundstl_x - stl_x + 1;
                         long slb_y = subtile_slab(stl_y);
+                        reveal_map_rect(player->id_number, stl_x, stl_x + delta, stl_y, stl_y + 1);
                         for (i=0; i < delta; i++)
                         {
                             struct Map* mapblk = get_map_block_at(stl_x + i, stl_y);
-                            reveal_map_block(mapblk, player->id_number);
                             long slb_x = subtile_slab(stl_x + i);
                             struct SlabMap* slb = get_slabmap_block(slb_x, slb_y);
                             struct SlabConfigStats* slabst = get_slab_stats(slb);
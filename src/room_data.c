@@ -69,6 +69,7 @@ void count_slabs_div2_nomin_effcncy(struct Room *room);
 void count_slabs_mul2_wth_effcncy(struct Room *room);
 void count_slabs_pow2_wth_effcncy(struct Room *room);
 void count_workers_in_room(struct Room *room);
+long calculate_cummulative_room_slabs_effeciency(const struct Room *room);
 long find_random_valid_position_for_item_in_different_room_avoiding_object(struct Thing* thing, struct Room* skip_room, struct Coord3d* pos);
 /******************************************************************************/
 
@@ -405,7 +406,38 @@ TbBool move_thing_to_different_room(struct Thing* thing, struct Coord3d* pos)
     return false;
 }
 
-void count_workers_in_room(struct Room *room)
+/**
+ * Running sums used for room efficiency and capacity.
+ * Efficiency score of a room slab depends only on slabs around it, so the score
+ * of each slab is kept along with its sum for the room, and updated when a slab
+ * joins or leaves a room, or when terrain around a room slab changes.
+ */
+/** Efficiency score of each room slab, as included in the sum for its room. */
+static short room_slab_efficiency_score[MAX_TILES_X*MAX_TILES_Y];
+/** Sum of efficiency scores of all slabs of each room. */
+static long room_efficiency_score_sum[ROOMS_COUNT];
+/** Amount of creatures on the workers list of each room. */
+static unsigned short room_workers_count[ROOMS_COUNT];
+
+static short compute_room_slab_efficiency_score(const struct Room *room, SlabCodedCoords slb_num)
+{
+    return calculate_effeciency_score_for_room_slab(slb_num, room->owner, get_room_kind_stats(room->kind)->synergy_slab);
+}
+
+static void include_slab_in_room_efficiency_score(const struct Room *room, SlabCodedCoords slb_num)
+{
+    short score = compute_room_slab_efficiency_score(room, slb_num);
+    room_slab_efficiency_score[slb_num] = score;
+    room_efficiency_score_sum[room->index] += score;
+}
+
+static void exclude_slab_from_room_efficiency_score(const struct Room *room, SlabCodedCoords slb_num)
+{
+    room_efficiency_score_sum[room->index] -= room_slab_efficiency_score[slb_num];
+    room_slab_efficiency_score[slb_num] = 0;
+}
+
+static int count_creatures_on_room_workers_list(const struct Room *room)
 {
     int count = 0;
     long i = room->creatures_list;
@@ -431,6 +463,112 @@ void count_workers_in_room(struct Room *room)
           break;
         }
     }
+    return count;
+}
+
+/**
+ * Recomputes efficiency score sum of given room from all its slabs.
+ */
+void recompute_room_efficiency_score(const struct Room *room)
+{
+    room_efficiency_score_sum[room->index] = 0;
+    unsigned long k = 0;
+    long i = room->slabs_list;
+    while (i != 0)
+    {
+        // Per room tile code
+        include_slab_in_room_efficiency_score(room, i);
+        // Per room tile code ends
+        i = get_next_slab_number_in_room(i);
+        k++;
+        if (k > room->slabs_count)
+        {
+          ERRORLOG("Room slabs list length exceeded when sweeping");
+          break;
+        }
+    }
+}
+
+/**
+ * Updates efficiency scores of room slabs near a slab which changed its kind or owner.
+ * @param slb_x,slb_y The slab which was changed.
+ * @param reach Distance of slabs which were changed, counting from given one.
+ */
+void room_efficiency_slabs_changed_around(MapSlabCoord slb_x, MapSlabCoord slb_y, MapSlabDelta reach)
+{
+    // Scores depend on slabs directly around, so affected room slabs are one further
+    reach++;
+    for (MapSlabCoord y = slb_y - reach; y <= slb_y + reach; y++)
+    {
+        for (MapSlabCoord x = slb_x - reach; x <= slb_x + reach; x++)
+        {
+            struct SlabMap* slb = get_slabmap_block(x, y);
+            if (slabmap_block_invalid(slb) || (slb->room_index == 0)) {
+                continue;
+            }
+            struct Room* room = room_get(slb->room_index);
+            if (!room_exists(room)) {
+                continue;
+            }
+            SlabCodedCoords slb_num = get_slab_number(x, y);
+            exclude_slab_from_room_efficiency_score(room, slb_num);
+            include_slab_in_room_efficiency_score(room, slb_num);
+        }
+    }
+}
+
+void room_workers_list_changed(const struct Room *room, short delta)
+{
+    room_workers_count[room->index] += delta;
+}
+
+/**
+ * Rebuilds running sums of all rooms; used when the rooms were loaded or replaced.
+ */
+void rebuild_room_running_sums(void)
+{
+    memset(room_slab_efficiency_score, 0, sizeof(room_slab_efficiency_score));
+    memset(room_efficiency_score_sum, 0, sizeof(room_efficiency_score_sum));
+    memset(room_workers_count, 0, sizeof(room_workers_count));
+    for (int i = 1; i < ROOMS_COUNT; i++)
+    {
+        struct Room* room = &game.rooms[i];
+        if ((room->alloc_flags & RoF_Allocated) == 0) {
+            continue;
+        }
+        recompute_room_efficiency_score(room);
+        room_workers_count[i] = count_creatures_on_room_workers_list(room);
+    }
+}
+
+/**
+ * Returns sum of efficiency scores of all slabs in room.
+ * Debug builds verify the running sum against full computation, but only
+ * log a mismatch so that synced state stays the same as in release builds.
+ */
+long get_room_efficiency_score(const struct Room *room)
+{
+    long score = room_efficiency_score_sum[room->index];
+#if (BFDEBUG_LEVEL > 0)
+    long full_score = calculate_cummulative_room_slabs_effeciency(room);
+    if (score != full_score)
+    {
+        ERRORLOG("Efficiency score of %s index %d is %ld, but should be %ld",room_code_name(room->kind),(int)room->index,score,full_score);
+    }
+#endif
+    return score;
+}
+
+void count_workers_in_room(struct Room *room)
+{
+    int count = room_workers_count[room->index];
+#if (BFDEBUG_LEVEL > 0)
+    int full_count = count_creatures_on_room_workers_list(room);
+    if (count != full_count)
+    {
+        ERRORLOG("Workers count of %s index %d is %d, but should be %d",room_code_name(room->kind),(int)room->index,count,full_count);
+    }
+#endif
     room->used_capacity += count;
 }
 
@@ -842,6 +980,7 @@ void add_slab_to_room_tiles_list(struct Room *room, MapSlabCoord slb_x, MapSlabC
         room->slabs_count++;
         nxslb->next_in_room = 0;
     }
+    include_slab_in_room_efficiency_score(room, slb_num);
     room->slabs_list_tail = slb_num;
 }
 
@@ -866,6 +1005,8 @@ TbBool add_slab_list_to_room_tiles_list(struct Room *room, SlabCodedCoords slb_n
         struct SlabMap* nxslb = get_slabmap_direct(tail_slb_num);
         nxslb->room_index = room->index;
         room->slabs_count++;
+        // Scores of the joined slabs are already known
+        room_efficiency_score_sum[room->index] += room_slab_efficiency_score[tail_slb_num];
         if (nxslb->next_in_room == 0) {
             break;
         }
@@ -897,6 +1038,7 @@ void remove_slab_from_room_tiles_list(struct Room *room, MapSlabCoord slb_x, Map
     if (room->slabs_list == slb_num)
     {
         delete_room_flag(room);
+        exclude_slab_from_room_efficiency_score(room, slb_num);
         room->slabs_list = rmslb->next_in_room;
         room->slabs_count--;
         rmslb->next_in_room = 0;
@@ -921,6 +1063,7 @@ void remove_slab_from_room_tiles_list(struct Room *room, MapSlabCoord slb_x, Map
         {
             // When the item was found, replace its reference with next item
             slb->next_in_room = rmslb->next_in_room;
+            exclude_slab_from_room_efficiency_score(room, slb_num);
             room->slabs_count--;
             rmslb->next_in_room = 0;
             rmslb->room_index = 0;
@@ -1035,6 +1178,8 @@ struct Room *allocate_free_room_structure(void)
             room->alloc_flags |= RoF_Allocated;
             room->index = i;
             room->creation_turn = get_gameturn();
+            room_efficiency_score_sum[i] = 0;
+            room_workers_count[i] = 0;
             return room;
         }
     }
@@ -1079,6 +1224,7 @@ long recalculate_effeciency_for_rooms_of_kind(RoomKind rkind)
             }
             i = room->next_of_owner;
             // Per-room code starts
+            recompute_room_efficiency_score(room);
             set_room_efficiency(room);
             // Per-room code ends
             k++;
@@ -1115,6 +1261,7 @@ long reinitialise_rooms_of_kind(RoomKind rkind)
             }
             i = room->next_of_owner;
             // Per-room code starts
+            recompute_room_efficiency_score(room);
             do_room_integration(room);
             // Per-room code ends
             k++;
@@ -1238,7 +1385,7 @@ long calculate_room_efficiency(const struct Room *room)
         expected_base = 4 * (nslabs - 1);
     }
     long widespread = calculate_room_widespread_factor(room);
-    long score = calculate_cummulative_room_slabs_effeciency(room);
+    long score = get_room_efficiency_score(room);
     if (score <= expected_base) {
         effic = 0;
     } else
@@ -1511,6 +1658,135 @@ TbBool room_has_enough_free_capacity_for_creature_job(const struct Room *room, c
     return false;
 }
 
+/**
+ * Cache of subtiles a creature of given size may stand at, kept per slab.
+ * Room position finders are called for every room of a role on each search,
+ * so the height and wall checks of all room subtiles are computed once per
+ * creature size and dropped only when terrain around a slab changes.
+ */
+/** Max amount of creature sizes for which standing subtiles are cached at once. */
+#define ROOM_STANDING_CLASSES_COUNT 8
+/** Creatures wider than this would reach further than neighbour slabs, so they are not cached. */
+#define ROOM_STANDING_RADIUS_MAX (2*COORD_PER_STL)
+/** Set in a slab mask if its subtile bits were computed. */
+#define ROOM_STANDING_MASK_KNOWN 0x8000
+
+struct RoomStandingClass {
+    TbBool used;
+    long block_radius;
+    long size_z;
+    /** Bit per subtile of the slab, plus ROOM_STANDING_MASK_KNOWN; indexed by slab number. */
+    unsigned short masks[MAX_TILES_X*MAX_TILES_Y];
+};
+
+static struct RoomStandingClass room_standing_classes[ROOM_STANDING_CLASSES_COUNT];
+static int room_standing_class_to_reuse;
+
+static struct RoomStandingClass *get_room_standing_class(const struct Thing *thing, long block_radius)
+{
+    if (block_radius > ROOM_STANDING_RADIUS_MAX)
+        return NULL;
+    for (int i = 0; i < ROOM_STANDING_CLASSES_COUNT; i++)
+    {
+        struct RoomStandingClass* stdcls = &room_standing_classes[i];
+        if (stdcls->used && (stdcls->block_radius == block_radius) && (stdcls->size_z == thing->clipbox_size_z))
+            return stdcls;
+    }
+    struct RoomStandingClass* stdcls = &room_standing_classes[room_standing_class_to_reuse];
+    room_standing_class_to_reuse = (room_standing_class_to_reuse + 1) % ROOM_STANDING_CLASSES_COUNT;
+    stdcls->used = true;
+    stdcls->block_radius = block_radius;
+    stdcls->size_z = thing->clipbox_size_z;
+    memset(stdcls->masks, 0, sizeof(stdcls->masks));
+    return stdcls;
+}
+
+/**
+ * Computes which subtiles of a slab are free for the thing to stand at.
+ * Toxic terrain depends on the creature state, so it is not included.
+ */
+static unsigned short compute_room_standing_mask(const struct Thing *thing, long block_radius, SlabCodedCoords slb_num)
+{
+    MapSlabCoord slb_x = slb_num_decode_x(slb_num);
+    MapSlabCoord slb_y = slb_num_decode_y(slb_num);
+    unsigned short stdmask = ROOM_STANDING_MASK_KNOWN;
+    for (int ssub = 0; ssub < AROUND_TILES_COUNT; ssub++)
+    {
+        MapSubtlCoord stl_x = slab_subtile(slb_x, ssub % STL_PER_SLB);
+        MapSubtlCoord stl_y = slab_subtile(slb_y, ssub / STL_PER_SLB);
+        struct Map* mapblk = get_map_block_at(stl_x, stl_y);
+        if (((mapblk->flags & SlbAtFlg_Blocking) != 0) || (get_floor_filled_subtiles_at(stl_x,stl_y) >= 4))
+            continue;
+        if (subtile_has_sacrificial_on_top(stl_x, stl_y))
+            continue;
+        struct Coord3d pos;
+        pos.x.val = subtile_coord_center(stl_x);
+        pos.y.val = subtile_coord_center(stl_y);
+        pos.z.val = 0;
+        pos.z.val = get_thing_height_at_with_radius(thing, &pos, block_radius);
+        if (!thing_in_wall_at_with_radius(thing, &pos, block_radius)) {
+            stdmask |= (1 << ssub);
+        }
+    }
+    return stdmask;
+}
+
+static unsigned short get_room_standing_mask(struct RoomStandingClass *stdcls, const struct Thing *thing, long block_radius, SlabCodedCoords slb_num)
+{
+    if (stdcls == NULL)
+        return compute_room_standing_mask(thing, block_radius, slb_num);
+    if ((stdcls->masks[slb_num] & ROOM_STANDING_MASK_KNOWN) == 0)
+        stdcls->masks[slb_num] = compute_room_standing_mask(thing, block_radius, slb_num);
+    return stdcls->masks[slb_num];
+}
+
+static void set_position_for_thing_standing_at(const struct Thing *thing, long block_radius, MapSubtlCoord stl_x, MapSubtlCoord stl_y, struct Coord3d *pos)
+{
+    pos->x.val = subtile_coord_center(stl_x);
+    pos->y.val = subtile_coord_center(stl_y);
+    pos->z.val = 0;
+    pos->z.val = get_thing_height_at_with_radius(thing, pos, block_radius);
+}
+
+/**
+ * Drops cached standing subtiles of all slabs which a creature standing near given area could touch.
+ * Should be called whenever columns, collision flags or ceiling heights change.
+ * @param sx Area start subtile, X coordinate.
+ * @param sy Area start subtile, Y coordinate.
+ * @param ex Area end subtile (inclusive), X coordinate.
+ * @param ey Area end subtile (inclusive), Y coordinate.
+ */
+void invalidate_room_standing_positions_in_area(MapSubtlCoord sx, MapSubtlCoord sy, MapSubtlCoord ex, MapSubtlCoord ey)
+{
+    const MapSubtlCoord reach = coord_subtile(ROOM_STANDING_RADIUS_MAX + COORD_PER_STL/2);
+    MapSlabCoord slb_sx = subtile_slab(max(sx - reach, 0));
+    MapSlabCoord slb_sy = subtile_slab(max(sy - reach, 0));
+    MapSlabCoord slb_ex = min(subtile_slab(ex + reach), game.map_tiles_x - 1);
+    MapSlabCoord slb_ey = min(subtile_slab(ey + reach), game.map_tiles_y - 1);
+    for (int i = 0; i < ROOM_STANDING_CLASSES_COUNT; i++)
+    {
+        struct RoomStandingClass* stdcls = &room_standing_classes[i];
+        if (!stdcls->used)
+            continue;
+        for (MapSlabCoord slb_y = slb_sy; slb_y <= slb_ey; slb_y++)
+        {
+            for (MapSlabCoord slb_x = slb_sx; slb_x <= slb_ex; slb_x++)
+            {
+                stdcls->masks[get_slab_number(slb_x, slb_y)] = 0;
+            }
+        }
+    }
+}
+
+void clear_room_standing_positions(void)
+{
+    for (int i = 0; i < ROOM_STANDING_CLASSES_COUNT; i++)
+    {
+        room_standing_classes[i].used = false;
+    }
+    room_standing_class_to_reuse = 0;
+}
+
 TbBool find_random_valid_position_for_thing_in_room(struct Thing *thing, struct Room *room, struct Coord3d *pos)
 {
     if (!room_exists(room)) {
@@ -1522,6 +1798,7 @@ TbBool find_random_valid_position_for_thing_in_room(struct Thing *thing, struct
         return false;
     }
     int navi_radius = abs(thing_nav_block_sizexy(thing) << 8) >> 1;
+    struct RoomStandingClass* stdcls = get_room_standing_class(thing, navi_radius);
     unsigned long k;
     long n = THING_RANDOM(thing, room->slabs_count);
     SlabCodedCoords slbnum = room->slabs_list;
@@ -1539,23 +1816,16 @@ TbBool find_random_valid_position_for_thing_in_room(struct Thing *thing, struct
     {
         MapSlabCoord slb_x = slb_num_decode_x(slbnum);
         MapSlabCoord slb_y = slb_num_decode_y(slbnum);
+        unsigned short stdmask = get_room_standing_mask(stdcls, thing, navi_radius, slbnum);
         int ssub = THING_RANDOM(thing, AROUND_TILES_COUNT);
         for (int snum = 0; snum < AROUND_TILES_COUNT; snum++)
         {
             MapSubtlCoord stl_x = slab_subtile(slb_x, ssub % 3);
             MapSubtlCoord stl_y = slab_subtile(slb_y, ssub / 3);
-            struct Map* mapblk = get_map_block_at(stl_x, stl_y);
-            if (((mapblk->flags & SlbAtFlg_Blocking) == 0) && (get_floor_filled_subtiles_at(stl_x,stl_y) < 4))
+            if (((stdmask & (1 << ssub)) != 0) && !terrain_toxic_for_creature_at_position(thing, stl_x, stl_y))
             {
-                if (!terrain_toxic_for_creature_at_position(thing, stl_x, stl_y) && !subtile_has_sacrificial_on_top(stl_x, stl_y))
-                {
-                    pos->x.val = subtile_coord_center(stl_x);
-                    pos->y.val = subtile_coord_center(stl_y);
-                    pos->z.val = get_thing_height_at_with_radius(thing, pos, navi_radius);
-                    if (!thing_in_wall_at_with_radius(thing, pos, navi_radius)) {
-                        return true;
-                    }
-                }
+                set_position_for_thing_standing_at(thing, navi_radius, stl_x, stl_y, pos);
+                return true;
             }
             ssub = (ssub + 1) % AROUND_TILES_COUNT;
         }
@@ -1902,6 +2172,7 @@ TbBool find_first_valid_position_for_thing_anywhere_in_room(const struct Thing *
         return false;
     }
     long block_radius = subtile_coord(thing_nav_block_sizexy(thing), 0) / 2;
+    struct RoomStandingClass* stdcls = get_room_standing_class(thing, block_radius);
 
     unsigned long k = 0;
     unsigned long i = room->slabs_list;
@@ -1910,25 +2181,19 @@ TbBool find_first_valid_position_for_thing_anywhere_in_room(const struct Thing *
         MapSubtlCoord slb_x = slb_num_decode_x(i);
         MapSubtlCoord slb_y = slb_num_decode_y(i);
         // Per-slab code
+        unsigned short stdmask = get_room_standing_mask(stdcls, thing, block_radius, i);
         for (long dy = 0; dy < 3; dy++)
         {
             for (long dx = 0; dx < 3; dx++)
             {
+                if ((stdmask & (1 << (3 * dy + dx))) == 0)
+                    continue;
                 MapSubtlCoord stl_x = 3 * slb_x + dx;
                 MapSubtlCoord stl_y = 3 * slb_y + dy;
-                struct Map* mapblk = get_map_block_at(stl_x, stl_y);
-                // Check if the position isn't filled with solid block
-                if (((mapblk->flags & SlbAtFlg_Blocking) == 0) && (get_floor_filled_subtiles_at(stl_x,stl_y) < 4))
+                if (!terrain_toxic_for_creature_at_position(thing, stl_x, stl_y))
                 {
-                    if (!terrain_toxic_for_creature_at_position(thing, stl_x, stl_y) && !subtile_has_sacrificial_on_top(stl_x, stl_y))
-                    {
-                        pos->x.val = subtile_coord_center(stl_x);
-                        pos->y.val = subtile_coord_center(stl_y);
-                        pos->z.val = get_thing_height_at_with_radius(thing, pos, block_radius);
-                        if ( !thing_in_wall_at_with_radius(thing, pos, block_radius) ) {
-                          return true;
-                        }
-                    }
+                    set_position_for_thing_standing_at(thing, block_radius, stl_x, stl_y, pos);
+                    return true;
                 }
             }
         }
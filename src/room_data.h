@@ -155,6 +155,11 @@ TbBool room_exists(const struct Room *room);
 
 unsigned long compute_room_max_health(unsigned short slabs_count,unsigned short efficiency);
 void set_room_efficiency(struct Room *room);
+long get_room_efficiency_score(const struct Room *room);
+void recompute_room_efficiency_score(const struct Room *room);
+void room_efficiency_slabs_changed_around(MapSlabCoord slb_x, MapSlabCoord slb_y, MapSlabDelta reach);
+void room_workers_list_changed(const struct Room *room, short delta);
+void rebuild_room_running_sums(void);
 void do_room_recalculation(struct Room* room);
 long get_room_slabs_count(PlayerNumber plyr_idx, RoomKind rkind);
 long get_room_of_role_slabs_count(PlayerNumber plyr_idx, RoomRole rrole);
@@ -171,6 +176,8 @@ struct Thing *find_gold_hoarde_at(MapSubtlCoord stl_x, MapSubtlCoord stl_y);
 // Finding position within room
 TbBool find_random_valid_position_for_thing_in_room(struct Thing *thing, struct Room *room, struct Coord3d *pos);
 TbBool find_first_valid_position_for_thing_anywhere_in_room(const struct Thing *thing, struct Room *room, struct Coord3d *pos);
+void invalidate_room_standing_positions_in_area(MapSubtlCoord sx, MapSubtlCoord sy, MapSubtlCoord ex, MapSubtlCoord ey);
+void clear_room_standing_positions(void);
 TbBool find_random_position_at_area_of_room(struct Coord3d *pos, const struct Room *room, unsigned char room_area, struct Thing *thing);
 
 // Finding a room for a thing
@@ -196,6 +196,7 @@ TbBool add_creature_to_work_room(struct Thing *creatng, struct Room *room, Creat
     }
     room->creatures_list = creatng->index;
     cctrl->creature_control_flags |= CCFlg_IsInRoomList;
+    room_workers_list_changed(room, 1);
     return true;
 }
 
@@ -240,6 +241,7 @@ TbBool remove_creature_from_specific_room(struct Thing *creatng, struct Room *ro
     cctrl->creature_control_flags &= ~CCFlg_IsInRoomList;
     cctrl->next_in_room = 0;
     cctrl->prev_in_room = 0;
+    room_workers_list_changed(room, -1);
     return true;
 }
 
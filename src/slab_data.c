@@ -27,6 +27,10 @@
 #include "map_ceiling.h"
 #include "map_utils.h"
 #include "frontmenu_ingame_map.h"
+#include "player_compdigfld.h"
+#include "room_data.h"
+#include "spdigger_stack.h"
+#include "thing_traps.h"
 #include "game_legacy.h"
 #include "creature_states.h"
 #include "map_data.h"
@@ -180,6 +184,10 @@ void set_slab_owner(MapSlabCoord slb_x, MapSlabCoord slb_y, PlayerNumber owner)
     if(old_owner != owner)
     {
         lua_on_slab_owner_change(slb_x, slb_y, old_owner);
+        panel_map_update_slab(slb_x, slb_y);
+        computer_dig_field_slab_changed(slb_x, slb_y);
+        digger_stack_slab_changed(slb_x, slb_y);
+        room_efficiency_slabs_changed_around(slb_x, slb_y, 0);
     }
 }
 
@@ -606,8 +614,13 @@ void update_map_collide(SlabKind slbkind, MapSubtlCoord stl_x, MapSubtlCoord stl
     } else {
       nflags = slabst->noblck_flags;
     }
+    unsigned long oflags = mapblk->flags;
     mapblk->flags &= (SlbAtFlg_TaggedValuable|SlbAtFlg_Unexplored);
     mapblk->flags |= nflags;
+    if (((oflags ^ mapblk->flags) & SlbAtFlg_Blocking) != 0) {
+        trap_trigger_zones_blocking_changed(stl_x, stl_y);
+    }
+    invalidate_room_standing_positions_in_area(stl_x, stl_y, stl_x, stl_y);
 }
 
 void collect_rooms_around_slab(MapSlabCoord slb_x, MapSlabCoord slb_y, struct Room** room_list, int room_list_len)
@@ -19,6 +19,8 @@
 #include "pre_inc.h"
 #include "spdigger_stack.h"
 
+#include <stdlib.h>
+
 #include "globals.h"
 #include "bflib_basics.h"
 #include "bflib_math.h"
@@ -63,6 +65,38 @@ static long const dig_pos[] = {0, -1, 1};
 static long r_stackpos;
 static struct DiggerStack reinforce_stack[DIGGER_TASK_MAX_COUNT];
 
+#define DIGGER_FIELD_SLABS_MAX (MAX_TILES_X*MAX_TILES_Y)
+#define DIGGER_FIELD_CHANGED_SLABS_COUNT 64
+#define DIGGER_FIELD_DIST_BORDER    0xFFFE
+#define DIGGER_FIELD_DIST_UNREACHED 0xFFFF
+#define DIGGER_ITEMS_WORDS_COUNT ((THINGS_COUNT+31)/32)
+
+/**
+ * Slabs which may need pretty, convert or reinforce tasks from diggers of one player,
+ * and walking distances to them from the player heart.
+ * Kept up to date with slab changes, so the stack can be filled without searching the whole map.
+ */
+struct DiggerTaskField {
+    TbBool valid;
+    TbBool rebuild_needed;
+    MapSlabCoord tiles_x;
+    MapSlabCoord tiles_y;
+    SlabCodedCoords heart_slb_num;
+    unsigned short changed_count;
+    SlabCodedCoords changed_slabs[DIGGER_FIELD_CHANGED_SLABS_COUNT];
+    /** Walking distance from heart slab, or one of DIGGER_FIELD_DIST_* values. */
+    unsigned short distance[DIGGER_FIELD_SLABS_MAX];
+    /** Bit for every slab which may need a task. */
+    uint32_t candidates[(DIGGER_FIELD_SLABS_MAX+31)/32];
+};
+
+static struct DiggerTaskField digger_task_fields[PLAYERS_COUNT];
+static SlabCodedCoords digger_field_queue[DIGGER_FIELD_SLABS_MAX];
+static uint32_t digger_field_keys[DIGGER_FIELD_SLABS_MAX];
+/** Bit for every thing index of loose gold, spell book or crate object. */
+static uint32_t digger_items[DIGGER_ITEMS_WORDS_COUNT];
+static TbBool digger_items_valid;
+
 /******************************************************************************/
 /**
  * Returns if given digger needs to have its task revised due to recent digger tasks list update.
@@ -1423,179 +1457,269 @@ long add_to_pretty_to_imp_stack_if_need_to(MapSlabCoord slb_x, MapSlabCoord slb_
 }
 
 /**
- * Array used to determine whether a diagonal slab is blocked by two two slabs around.
+ * Returns if the slab blocks walking, so pretty and convert tasks are not searched behind it.
  */
-struct ExtraSquares spdigger_extra_squares[] = {
-    { 0,  0x00},
-    { 0,  0x00},
-    { 0,  0x00},
-    { 1, ~0x03}, // 0x01|0x02 are blocking slab
-    { 0,  0x00},
-    { 0,  0x00},
-    { 2, ~0x06}, // 0x02|0x04 are blocking slab
-    { 1, ~0x01}, // 0x01|0x02|0x04 are blocking 2 slabs
-    { 0,  0x00},
-    { 4, ~0x09}, // 0x01|0x08 are blocking slab
-    { 0,  0x00},
-    { 1, ~0x02}, // 0x01|0x02|0x08 are blocking 2 slabs
-    { 3, ~0x0C}, // 0x04|0x08 are blocking slab
-    { 3, ~0x04}, // 0x01|0x04|0x08 are blocking 2 slabs
-    { 2, ~0x02}, // 0x02|0x04|0x08 are blocking 2 slabs
-    { 1,  0x00}, // all diagonals blocked, special case
-};
+static TbBool slab_is_digger_field_border(MapSlabCoord slb_x, MapSlabCoord slb_y)
+{
+    struct SlabMap *slb = get_slabmap_block(slb_x, slb_y);
+    struct SlabConfigStats *slabst = get_slab_stats(slb);
+    return ((slabst->block_flags & (SlbAtFlg_Filled|SlbAtFlg_Digable|SlbAtFlg_Valuable)) != 0);
+}
 
-struct Around spdigger_extra_positions[] = {
-    { 0, 0},
-    { 1,-1},
-    { 1, 1},
-    {-1, 1},
-    {-1,-1},
-};
-#define SPDIGGER_EXTRA_POSITIONS_COUNT 5
+/**
+ * Returns if the slab may need a pretty, convert or reinforce task from given player diggers.
+ * Conditions which may change without the slab or its neighbours being changed,
+ * like being revealed or alliances, are checked when the stack is filled.
+ */
+static TbBool slab_is_digger_field_candidate(PlayerNumber plyr_idx, MapSlabCoord slb_x, MapSlabCoord slb_y)
+{
+    struct SlabMap *slb = get_slabmap_block(slb_x, slb_y);
+    if ((slb->kind == SlbT_PATH) || slab_kind_is_friable_dirt(slb->kind))
+    {
+    } else
+    if ((slb->kind == SlbT_CLAIMED) || slab_kind_is_room(slb->kind) || slab_kind_is_door(slb->kind))
+    {
+        if (slabmap_owner(slb) == plyr_idx)
+            return false;
+    } else
+    {
+        return false;
+    }
+    return slab_by_players_land(plyr_idx, slb_x, slb_y);
+}
 
-enum SlabConnectedAreaOptions {
-    SlbCAOpt_None      = 0x00,
-    SlbCAOpt_Border    = 0x01,
-    SlbCAOpt_Processed = 0x02,
-};
+static void digger_field_set_candidate(struct DiggerTaskField *dfield, PlayerNumber plyr_idx, MapSlabCoord slb_x, MapSlabCoord slb_y)
+{
+    if ((slb_x < 0) || (slb_x >= dfield->tiles_x) || (slb_y < 0) || (slb_y >= dfield->tiles_y))
+        return;
+    SlabCodedCoords slb_num = slb_y * dfield->tiles_x + slb_x;
+    if (slab_is_digger_field_candidate(plyr_idx, slb_x, slb_y))
+        dfield->candidates[slb_num / 32] |= (1u << (slb_num % 32));
+    else
+        dfield->candidates[slb_num / 32] &= ~(1u << (slb_num % 32));
+}
 
 /**
- * Prepares slab options map used for finding pretty and convert tasks for diggers.
- * @param dungeon Target dungeon for which tasks are to be searched.
- * @param slbopt The slab options map to be initialized.
+ * Continues breadth-first search of distances from the queued slabs.
+ * @return True if the search finished, false if the queue overflowed.
  */
-void add_pretty_and_convert_to_imp_stack_prepare(struct Dungeon *dungeon, unsigned char *slbopt)
+static TbBool digger_field_propagate(struct DiggerTaskField *dfield, long qhead, long qcount)
 {
-    MapSlabCoord slb_x;
-    MapSlabCoord slb_y;
-    // Clear our slab options array and mark tall slabs with SlbCAOpt_Border
-    for (slb_y=0; slb_y < game.map_tiles_y; slb_y++)
+    while (qcount > 0)
     {
-        for (slb_x=0; slb_x < game.map_tiles_x; slb_x++)
+        SlabCodedCoords slb_num = digger_field_queue[qhead];
+        qhead = (qhead + 1) % DIGGER_FIELD_SLABS_MAX;
+        qcount--;
+        unsigned short ndist = dfield->distance[slb_num] + 1;
+        MapSlabCoord slb_x = slb_num % dfield->tiles_x;
+        MapSlabCoord slb_y = slb_num / dfield->tiles_x;
+        for (int n = 0; n < SMALL_AROUND_LENGTH; n++)
         {
-            SlabCodedCoords slb_num = get_slab_number(slb_x, slb_y);
-            struct SlabMap *slb = get_slabmap_direct(slb_num);
-            struct SlabConfigStats *slabst = get_slab_stats(slb);
-            slbopt[slb_num] = 0;
-            if ((slabst->block_flags & (SlbAtFlg_Filled|SlbAtFlg_Digable|SlbAtFlg_Valuable)) != 0) {
-                slbopt[slb_num] |= SlbCAOpt_Border;
-            }
+            MapSlabCoord nslb_x = slb_x + small_around[n].delta_x;
+            MapSlabCoord nslb_y = slb_y + small_around[n].delta_y;
+            if ((nslb_x < 0) || (nslb_x >= dfield->tiles_x) || (nslb_y < 0) || (nslb_y >= dfield->tiles_y))
+                continue;
+            SlabCodedCoords nslb_num = nslb_y * dfield->tiles_x + nslb_x;
+            if ((dfield->distance[nslb_num] == DIGGER_FIELD_DIST_BORDER) || (dfield->distance[nslb_num] <= ndist))
+                continue;
+            if (qcount >= DIGGER_FIELD_SLABS_MAX)
+                return false;
+            dfield->distance[nslb_num] = ndist;
+            digger_field_queue[(qhead + qcount) % DIGGER_FIELD_SLABS_MAX] = nslb_num;
+            qcount++;
+        }
+    }
+    return true;
+}
+
+static void digger_field_rebuild(struct DiggerTaskField *dfield, PlayerNumber plyr_idx)
+{
+    SYNCDBG(8,"Rebuilding digger tasks field of player %d",(int)plyr_idx);
+    for (MapSlabCoord slb_y = 0; slb_y < dfield->tiles_y; slb_y++)
+    {
+        for (MapSlabCoord slb_x = 0; slb_x < dfield->tiles_x; slb_x++)
+        {
+            SlabCodedCoords slb_num = slb_y * dfield->tiles_x + slb_x;
+            if (slab_is_digger_field_border(slb_x, slb_y))
+                dfield->distance[slb_num] = DIGGER_FIELD_DIST_BORDER;
+            else
+                dfield->distance[slb_num] = DIGGER_FIELD_DIST_UNREACHED;
+            digger_field_set_candidate(dfield, plyr_idx, slb_x, slb_y);
         }
     }
+    dfield->distance[dfield->heart_slb_num] = 0;
+    digger_field_queue[0] = dfield->heart_slb_num;
+    digger_field_propagate(dfield, 0, 1);
 }
 
 /**
- * Adds pretty and convert tasks of areas connected to given position into imp stack.
- * @param dungeon Target dungeon for which tasks should be added.
- * @param slbopt Slab options map.
- * @param slblist Buffer for storing temporary slabs list.
- * @param start_pos The position connected to tasks to find.
- * @param remain_num Limit of tasks which can still be added.
- * @return The amount of slabs checked.
+ * Updates the field after slab changes.
+ * @return True if the field was updated, false if the changes need a full rebuild.
  */
-long add_pretty_and_convert_to_imp_stack_starting_from_pos(struct Dungeon *dungeon, unsigned char *slbopt, struct SlabCoord *slblist, const struct Coord3d * start_pos, int *remain_num)
+static TbBool digger_field_apply_changes(struct DiggerTaskField *dfield, PlayerNumber plyr_idx)
 {
-    unsigned int slblicount;
-    unsigned int slblipos;
-    MapSlabCoord slb_x;
-    MapSlabCoord slb_y;
-    slblipos = 0; // Current position in our list of slabs which should be checked around
-    slblicount = 0; // Amount of items in our list of slabs which should be checked around
-    MapSlabCoord base_slb_x = subtile_slab(start_pos->x.stl.num);
-    MapSlabCoord base_slb_y = subtile_slab(start_pos->y.stl.num);
-    struct SlabMap *slb;
-    SlabCodedCoords slb_num = get_slab_number(base_slb_x, base_slb_y);
-    slbopt[slb_num] |= SlbCAOpt_Processed;
+    long qcount = 0;
+    for (long i = 0; i < dfield->changed_count; i++)
+    {
+        SlabCodedCoords slb_num = dfield->changed_slabs[i];
+        MapSlabCoord slb_x = slb_num % dfield->tiles_x;
+        MapSlabCoord slb_y = slb_num / dfield->tiles_x;
+        digger_field_set_candidate(dfield, plyr_idx, slb_x, slb_y);
+        for (int n = 0; n < SMALL_AROUND_LENGTH; n++)
+        {
+            digger_field_set_candidate(dfield, plyr_idx, slb_x + small_around[n].delta_x, slb_y + small_around[n].delta_y);
+        }
+        unsigned short old_dist = dfield->distance[slb_num];
+        if (slab_is_digger_field_border(slb_x, slb_y))
+        {
+            // A new wall may cut off the area behind it; only a full search can raise the distances
+            if ((old_dist != DIGGER_FIELD_DIST_BORDER) && (old_dist != DIGGER_FIELD_DIST_UNREACHED))
+                return false;
+            dfield->distance[slb_num] = DIGGER_FIELD_DIST_BORDER;
+            continue;
+        }
+        if (old_dist != DIGGER_FIELD_DIST_BORDER)
+            continue;
+        // Dug out slab can only make distances shorter
+        unsigned short new_dist = DIGGER_FIELD_DIST_UNREACHED;
+        for (int n = 0; n < SMALL_AROUND_LENGTH; n++)
+        {
+            MapSlabCoord nslb_x = slb_x + small_around[n].delta_x;
+            MapSlabCoord nslb_y = slb_y + small_around[n].delta_y;
+            if ((nslb_x < 0) || (nslb_x >= dfield->tiles_x) || (nslb_y < 0) || (nslb_y >= dfield->tiles_y))
+                continue;
+            unsigned short ndist = dfield->distance[nslb_y * dfield->tiles_x + nslb_x];
+            if ((ndist < DIGGER_FIELD_DIST_BORDER) && (ndist + 1 < new_dist))
+                new_dist = ndist + 1;
+        }
+        dfield->distance[slb_num] = new_dist;
+        if (new_dist != DIGGER_FIELD_DIST_UNREACHED)
+            digger_field_queue[qcount++] = slb_num;
+    }
+    return digger_field_propagate(dfield, 0, qcount);
+}
 
-    TbBool extra_handle = false;
+/**
+ * Returns digger tasks field of given player, making sure it reflects the current map.
+ */
+static struct DiggerTaskField *get_updated_digger_field(PlayerNumber plyr_idx, const struct Thing *heartng)
+{
+    if ((plyr_idx < 0) || (plyr_idx >= PLAYERS_COUNT))
+        return NULL;
+    if ((game.map_tiles_x <= 0) || (game.map_tiles_y <= 0) || (game.map_tiles_x * game.map_tiles_y > DIGGER_FIELD_SLABS_MAX))
+        return NULL;
+    struct DiggerTaskField *dfield = &digger_task_fields[plyr_idx];
+    SlabCodedCoords heart_slb_num = subtile_slab(heartng->mappos.y.stl.num) * game.map_tiles_x + subtile_slab(heartng->mappos.x.stl.num);
+    if ((dfield->tiles_x != game.map_tiles_x) || (dfield->tiles_y != game.map_tiles_y) || (dfield->heart_slb_num != heart_slb_num))
+    {
+        dfield->tiles_x = game.map_tiles_x;
+        dfield->tiles_y = game.map_tiles_y;
+        dfield->heart_slb_num = heart_slb_num;
+        dfield->rebuild_needed = true;
+    }
+    if (!dfield->valid || dfield->rebuild_needed)
+    {
+        digger_field_rebuild(dfield, plyr_idx);
+    } else
+    if (dfield->changed_count > 0)
+    {
+        if (!digger_field_apply_changes(dfield, plyr_idx))
+            digger_field_rebuild(dfield, plyr_idx);
+    }
+    dfield->valid = true;
+    dfield->rebuild_needed = false;
+    dfield->changed_count = 0;
+    return dfield;
+}
 
-    // Verify slabs around; we will add more around slabs to checklist as we progress
-    do
+static int digger_field_key_compare(const void *ptr_a, const void *ptr_b)
+{
+    uint32_t key_a = *(const uint32_t *)ptr_a;
+    uint32_t key_b = *(const uint32_t *)ptr_b;
+    return (key_a > key_b) - (key_a < key_b);
+}
+
+/**
+ * Fills digger_field_keys with candidate slabs, sorted by walking distance from the heart.
+ * Walls are sorted right after the slab from which they are reached; slabs not connected
+ * to the heart go last.
+ * @return Amount of the candidate slabs.
+ */
+static long get_digger_field_candidates_in_order(const struct DiggerTaskField *dfield)
+{
+    long count = 0;
+    long slabs_count = dfield->tiles_x * dfield->tiles_y;
+    for (long w = 0; w < (slabs_count + 31) / 32; w++)
     {
-        long i;
-        long n;
-        n = PLAYER_RANDOM(dungeon->owner, 4);
-        for (i=0; i < SMALL_AROUND_LENGTH; i++)
+        uint32_t bits = dfield->candidates[w];
+        for (int b = 0; bits != 0; b++, bits >>= 1)
         {
-            slb_x = base_slb_x + (long)small_around[n].delta_x;
-            slb_y = base_slb_y + (long)small_around[n].delta_y;
-            slb_num = get_slab_number(slb_x, slb_y);
-            // Per around code
-            if ((slbopt[slb_num] & SlbCAOpt_Border) != 0)
-            {
-            }
-            if ((slbopt[slb_num] & SlbCAOpt_Processed) == 0)
+            if ((bits & 0x01) == 0)
+                continue;
+            SlabCodedCoords slb_num = w * 32 + b;
+            unsigned short dist = dfield->distance[slb_num];
+            if (dist == DIGGER_FIELD_DIST_BORDER)
             {
-                slbopt[slb_num] |= SlbCAOpt_Processed;
-                // For border wall, check if it can be reinforced
-                if ((slbopt[slb_num] & SlbCAOpt_Border) != 0)
+                MapSlabCoord slb_x = slb_num % dfield->tiles_x;
+                MapSlabCoord slb_y = slb_num / dfield->tiles_x;
+                dist = DIGGER_FIELD_DIST_UNREACHED;
+                for (int n = 0; n < SMALL_AROUND_LENGTH; n++)
                 {
-                    add_to_reinforce_stack_if_need_to(slb_x, slb_y, dungeon);
-                } else
-                // If not a border, add it to around verification list and check for pretty
-                {
-                    slblist[slblicount].x = slb_x;
-                    slblist[slblicount].y = slb_y;
-                    slblicount++;
-                    if ((*remain_num) <= 0)
-                    {
-                        // Even if the remain_num reaches zero and we can't add new tasks, we may still
-                        // want to continue the loop if reinforce stack is not filled.
-                        if (r_stackpos >= DIGGER_TASK_MAX_COUNT - dungeon->digger_stack_length) {
-                            return slblipos;
-                        }
-                    } else
-                    {
-                        // The remain_num parameter must go to subfunction - here we don't know if we should decrement it or not
-                        if ( !add_to_pretty_to_imp_stack_if_need_to(slb_x, slb_y, dungeon, remain_num) ) {
-                            SYNCDBG(6,"Cannot add any more pretty tasks");
-                            return slblipos;
-                        }
-                    }
+                    MapSlabCoord nslb_x = slb_x + small_around[n].delta_x;
+                    MapSlabCoord nslb_y = slb_y + small_around[n].delta_y;
+                    if ((nslb_x < 0) || (nslb_x >= dfield->tiles_x) || (nslb_y < 0) || (nslb_y >= dfield->tiles_y))
+                        continue;
+                    unsigned short ndist = dfield->distance[nslb_y * dfield->tiles_x + nslb_x];
+                    if ((ndist < DIGGER_FIELD_DIST_BORDER) && (ndist + 1 < dist))
+                        dist = ndist + 1;
                 }
             }
-            // Per around code ends
-            n = (n + 1) % SMALL_AROUND_LENGTH;
+            // Slab numbers fit in 16 bits, as the map has at most MAX_TILES_X*MAX_TILES_Y slabs
+            digger_field_keys[count++] = ((uint32_t)dist << 16) | slb_num;
         }
+    }
+    qsort(digger_field_keys, count, sizeof(digger_field_keys[0]), digger_field_key_compare);
+    return count;
+}
 
-        if (slblipos >= slblicount && !extra_handle) {
-            // The area not connected to the heart
-            // We added additional processing before the original exit to ensure that it does not affect the default behavior
-            extra_handle = true;
-            for (slb_y=0; slb_y < game.map_tiles_y; slb_y++)
-            {
-                for (slb_x=0; slb_x < game.map_tiles_x; slb_x++)
-                {
-                    slb_num = get_slab_number(slb_x, slb_y);
-                    slb = get_slabmap_direct(slb_num);
-                    if ( (slbopt[slb_num] & SlbCAOpt_Processed) == 0
-                      && (slbopt[slb_num] & SlbCAOpt_Border) == 0
-                      && slabmap_owner(slb) == dungeon->owner
-                      )
-                    {
-                        slbopt[slb_num] |= SlbCAOpt_Processed;
-                        slblist[slblicount].x = slb_x;
-                        slblist[slblicount].y = slb_y;
-                        slblicount++;
-                    }
-                }
-            }
-        }
+/**
+ * Invalidates digger tasks fields and loose items set. To be called when a new map is loaded.
+ */
+void clear_digger_stack_fields(void)
+{
+    for (PlayerNumber plyr_idx = 0; plyr_idx < PLAYERS_COUNT; plyr_idx++)
+    {
+        struct DiggerTaskField *dfield = &digger_task_fields[plyr_idx];
+        dfield->valid = false;
+        dfield->changed_count = 0;
+    }
+    digger_items_valid = false;
+}
 
-        if (slblipos >= slblicount) {
-            break;
+/**
+ * Informs digger tasks fields that kind or owner of given slab has changed.
+ */
+void digger_stack_slab_changed(MapSlabCoord slb_x, MapSlabCoord slb_y)
+{
+    for (PlayerNumber plyr_idx = 0; plyr_idx < PLAYERS_COUNT; plyr_idx++)
+    {
+        struct DiggerTaskField *dfield = &digger_task_fields[plyr_idx];
+        if (!dfield->valid || dfield->rebuild_needed)
+            continue;
+        if ((slb_x < 0) || (slb_x >= dfield->tiles_x) || (slb_y < 0) || (slb_y >= dfield->tiles_y))
+            continue;
+        if (dfield->changed_count >= DIGGER_FIELD_CHANGED_SLABS_COUNT) {
+            dfield->rebuild_needed = true;
+            continue;
         }
-        base_slb_x = slblist[slblipos].x;
-        base_slb_y = slblist[slblipos].y;
-        slblipos++;
+        dfield->changed_slabs[dfield->changed_count] = slb_y * dfield->tiles_x + slb_x;
+        dfield->changed_count++;
     }
-    while (slblipos <= slblicount);
-    return slblipos;
 }
 
-
 /**
  * Adds tasks of claiming unowned and converting enemy land to the digger tasks stack; also fills reinforce tasks.
+ * Slabs are checked in order of walking distance from dungeon heart.
  * @param dungeon Target dungeon for which tasks should be added.
  * @param max_tasks Max amount of tasks to be added.
  * @return The amount of tasks added.
@@ -1615,14 +1739,40 @@ int add_pretty_and_convert_to_imp_stack(struct Dungeon *dungeon, int max_tasks)
         WARNLOG("The player %d has no heart, no dungeon position available",(int)dungeon->owner);
         return 0;
     }
+    struct DiggerTaskField *dfield;
+    dfield = get_updated_digger_field(dungeon->owner, heartng);
+    if (dfield == NULL) {
+        return 0;
+    }
     int remain_num;
     remain_num = max_tasks;
-    unsigned char *slbopt;
-    struct SlabCoord *slblist;
-    slbopt = big_scratch;
-    slblist = (struct SlabCoord *)(big_scratch + game.map_tiles_x*game.map_tiles_y);
-    add_pretty_and_convert_to_imp_stack_prepare(dungeon, slbopt);
-    add_pretty_and_convert_to_imp_stack_starting_from_pos(dungeon, slbopt, slblist, &heartng->mappos, &remain_num);
+    long keys_count = get_digger_field_candidates_in_order(dfield);
+    for (long i = 0; i < keys_count; i++)
+    {
+        SlabCodedCoords slb_num = digger_field_keys[i] & 0xFFFF;
+        MapSlabCoord slb_x = slb_num % dfield->tiles_x;
+        MapSlabCoord slb_y = slb_num / dfield->tiles_x;
+        // For border wall, check if it can be reinforced
+        if (dfield->distance[slb_num] == DIGGER_FIELD_DIST_BORDER)
+        {
+            add_to_reinforce_stack_if_need_to(slb_x, slb_y, dungeon);
+        } else
+        if (remain_num <= 0)
+        {
+            // Even if the remain_num reaches zero and we can't add new tasks, we may still
+            // want to continue the loop if reinforce stack is not filled.
+            if (r_stackpos >= DIGGER_TASK_MAX_COUNT - dungeon->digger_stack_length) {
+                break;
+            }
+        } else
+        {
+            // The remain_num parameter must go to subfunction - here we don't know if we should decrement it or not
+            if (!add_to_pretty_to_imp_stack_if_need_to(slb_x, slb_y, dungeon, &remain_num)) {
+                SYNCDBG(6,"Cannot add any more pretty tasks");
+                break;
+            }
+        }
+    }
     SYNCDBG(8,"Done, added %d tasks",(int)(max_tasks-remain_num));
     return (max_tasks-remain_num);
 }
@@ -1711,21 +1861,99 @@ TbBool thing_can_be_picked_to_place_in_player_room_of_role(const struct Thing* t
     return false;
 }
 
-struct Thing *get_next_unclaimed_gold_thing_pickable_by_digger(PlayerNumber owner, int start_idx)
+static TbBool thing_is_digger_item(const struct Thing *thing)
 {
-    struct Thing *thing;
-    int i;
-    int k;
-    k = 0;
-    i = start_idx;
+    return object_is_gold_pile(thing) || thing_is_spellbook(thing) || thing_is_special_box(thing) || thing_is_workshop_crate(thing);
+}
+
+static void rebuild_digger_items(void)
+{
+    memset(digger_items, 0, sizeof(digger_items));
+    const struct StructureList *slist;
+    slist = get_list_for_thing_class(TCls_Object);
+    unsigned long k = 0;
+    long i = slist->index;
     while (i > 0)
     {
+        struct Thing *thing;
         thing = thing_get(i);
-        if (thing_is_invalid(thing))
+        if (thing_is_invalid(thing)) {
+            ERRORLOG("Jump to invalid thing detected");
             break;
+        }
         i = thing->next_of_class;
+        if (thing_is_digger_item(thing)) {
+            digger_items[thing->index / 32] |= (1u << (thing->index % 32));
+        }
+        k++;
+        if (k > slist->count)
+        {
+            ERRORLOG("Infinite loop detected when sweeping things list");
+            break;
+        }
+    }
+    digger_items_valid = true;
+}
+
+/**
+ * Returns loose gold, spell book or crate object with the lowest index above given one.
+ * Items are returned in order of indices, so the order doesn't depend on history of the things list.
+ */
+static struct Thing *get_next_digger_item(ThingIndex prev_idx)
+{
+    if (!digger_items_valid) {
+        rebuild_digger_items();
+    }
+    long i = prev_idx + 1;
+    while (i < THINGS_COUNT)
+    {
+        uint32_t bits = digger_items[i / 32] >> (i % 32);
+        if (bits == 0) {
+            i = (i / 32 + 1) * 32;
+            continue;
+        }
+        while ((bits & 0x01) == 0) {
+            bits >>= 1;
+            i++;
+        }
+        return thing_get(i);
+    }
+    return INVALID_THING;
+}
+
+/**
+ * Informs the diggers stack that a thing was added to its class list.
+ */
+void digger_stack_thing_listed(const struct Thing *thing)
+{
+    if (!digger_items_valid || (thing->index <= 0) || (thing->index >= THINGS_COUNT))
+        return;
+    if (thing_is_digger_item(thing)) {
+        digger_items[thing->index / 32] |= (1u << (thing->index % 32));
+    }
+}
+
+/**
+ * Informs the diggers stack that a thing was removed from its class list.
+ */
+void digger_stack_thing_unlisted(const struct Thing *thing)
+{
+    if (!digger_items_valid || (thing->index <= 0) || (thing->index >= THINGS_COUNT))
+        return;
+    digger_items[thing->index / 32] &= ~(1u << (thing->index % 32));
+}
+
+struct Thing *get_next_unclaimed_gold_thing_pickable_by_digger(PlayerNumber owner, ThingIndex prev_idx)
+{
+    struct Thing *thing;
+    int k;
+    k = 0;
+    thing = get_next_digger_item(prev_idx);
+    while (!thing_is_invalid(thing))
+    {
+        ThingIndex i = thing->index;
         // Per-thing code
-        if (thing_is_object(thing) && object_is_gold_pile(thing))
+        if (object_is_gold_pile(thing))
         {
             // TODO DIGGERS Use thing_can_be_picked_to_place_in_player_room_of_role() instead of single conditions
             //if (thing_can_be_picked_to_place_in_player_room_of_role(thing, owner, RoRoF_GoldStorage, TngFRPickF_Default))
@@ -1752,6 +1980,7 @@ struct Thing *get_next_unclaimed_gold_thing_pickable_by_digger(PlayerNumber owne
             ERRORLOG("Infinite loop detected when sweeping things list");
             break;
         }
+        thing = get_next_digger_item(i);
     }
     return INVALID_THING;
 }
@@ -1763,12 +1992,10 @@ int add_unclaimed_gold_to_imp_stack(struct Dungeon *dungeon, int max_tasks)
     if (room_is_invalid(room)) {
         return 0;
     }
-    const struct StructureList *slist;
-    slist = get_list_for_thing_class(TCls_Object);
     int remain_num;
     remain_num = max_tasks;
     struct Thing *gldtng;
-    gldtng = get_next_unclaimed_gold_thing_pickable_by_digger(dungeon->owner, slist->index);
+    gldtng = get_next_unclaimed_gold_thing_pickable_by_digger(dungeon->owner, 0);
     while ((remain_num > 0) && (dungeon->digger_stack_length < DIGGER_TASK_MAX_COUNT))
     {
         if (thing_is_invalid(gldtng)) {
@@ -1780,7 +2007,7 @@ int add_unclaimed_gold_to_imp_stack(struct Dungeon *dungeon, int max_tasks)
             add_to_dungeon_imp_stack_using_pos(stl_num, DigTsk_PicksUpGoldPile, dungeon);
             remain_num--;
         }
-        gldtng = get_next_unclaimed_gold_thing_pickable_by_digger(dungeon->owner, gldtng->next_of_class);
+        gldtng = get_next_unclaimed_gold_thing_pickable_by_digger(dungeon->owner, gldtng->index);
     }
     SYNCDBG(8,"Done, added %d tasks",(int)(max_tasks-remain_num));
     return (max_tasks-remain_num);
@@ -2017,22 +2244,13 @@ int add_unclaimed_spells_to_imp_stack(struct Dungeon *dungeon, int max_tasks)
     room = find_room_of_role_with_spare_room_item_capacity(dungeon->owner, RoRoF_PowersStorage);
     int remain_num;
     remain_num = max_tasks;
-    long i;
     unsigned long k;
-    const struct StructureList *slist;
-    slist = get_list_for_thing_class(TCls_Object);
+    struct Thing *thing;
     k = 0;
-    i = slist->index;
-    while (i > 0)
+    thing = get_next_digger_item(0);
+    while (!thing_is_invalid(thing))
     {
-        struct Thing *thing;
-        thing = thing_get(i);
         TRACE_THING(thing);
-        if (thing_is_invalid(thing)) {
-            ERRORLOG("Jump to invalid thing detected");
-            break;
-        }
-        i = thing->next_of_class;
         // Per-thing code
         if ((dungeon->digger_stack_length >= DIGGER_TASK_MAX_COUNT) || (remain_num <= 0)) {
             break;
@@ -2056,11 +2274,12 @@ int add_unclaimed_spells_to_imp_stack(struct Dungeon *dungeon, int max_tasks)
         }
         // Per-thing code ends
         k++;
-        if (k > slist->count)
+        if (k > THINGS_COUNT)
         {
             ERRORLOG("Infinite loop detected when sweeping things list");
             break;
         }
+        thing = get_next_digger_item(thing->index);
     }
     SYNCDBG(8,"Done, added %d tasks",(int)(max_tasks-remain_num));
     return (max_tasks-remain_num);
@@ -2069,17 +2288,12 @@ int add_unclaimed_spells_to_imp_stack(struct Dungeon *dungeon, int max_tasks)
 TbBool add_object_for_trap_to_imp_stack(struct Dungeon *dungeon, struct Thing *armtng)
 {
     unsigned long k;
-    int i;
+    struct Thing *thing;
     k = 0;
-    i = game.thing_lists[TngList_Objects].index;
-    while (i > 0)
+    thing = get_next_digger_item(0);
+    while (!thing_is_invalid(thing))
     {
-        struct Thing *thing;
-        thing = thing_get(i);
         TRACE_THING(thing);
-        if (thing_is_invalid(thing))
-            break;
-        i = thing->next_of_class;
         // Per-thing code
         if (thing->model == trap_crate_object_model(armtng->model))
         {
@@ -2103,6 +2317,7 @@ TbBool add_object_for_trap_to_imp_stack(struct Dungeon *dungeon, struct Thing *a
             ERRORLOG("Infinite loop detected when sweeping things list");
             break;
         }
+        thing = get_next_digger_item(thing->index);
     }
     return false;
 }
@@ -2159,21 +2374,12 @@ int add_unclaimed_traps_to_imp_stack(struct Dungeon *dungeon, int max_tasks)
     room = find_room_of_role_with_spare_room_item_capacity(dungeon->owner, RoRoF_CratesStorage);
     int remain_num;
     remain_num = max_tasks;
-    long i;
     unsigned long k;
-    const struct StructureList *slist;
-    slist = get_list_for_thing_class(TCls_Object);
     k = 0;
-    i = slist->index;
-    while (i != 0)
+    thing = get_next_digger_item(0);
+    while (!thing_is_invalid(thing))
     {
-        thing = thing_get(i);
         TRACE_THING(thing);
-        if (thing_is_invalid(thing)) {
-            ERRORLOG("Jump to invalid thing detected");
-            break;
-        }
-        i = thing->next_of_class;
         // Per-thing code
         if ((dungeon->digger_stack_length >= DIGGER_TASK_MAX_COUNT) || (remain_num <= 0)) {
             break;
@@ -2197,11 +2403,12 @@ int add_unclaimed_traps_to_imp_stack(struct Dungeon *dungeon, int max_tasks)
         }
         // Per-thing code ends
         k++;
-        if (k > slist->count)
+        if (k > THINGS_COUNT)
         {
             ERRORLOG("Infinite loop detected when sweeping things list");
             break;
         }
+        thing = get_next_digger_item(thing->index);
     }
     SYNCDBG(8,"Done, added %d tasks",(int)(max_tasks-remain_num));
     return (max_tasks-remain_num);
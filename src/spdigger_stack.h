@@ -90,6 +90,11 @@ void remove_task_from_all_other_players_digger_stacks(PlayerNumber skip_plyr_idx
 
 long find_in_dungeon_imp_stack_starting_at(SpDiggerTaskType task_type, long start_pos, const struct Dungeon *dungeon);
 
+void clear_digger_stack_fields(void);
+void digger_stack_slab_changed(MapSlabCoord slb_x, MapSlabCoord slb_y);
+void digger_stack_thing_listed(const struct Thing *thing);
+void digger_stack_thing_unlisted(const struct Thing *thing);
+
 TbBool add_to_dungeon_imp_stack_using_pos(SubtlCodedCoords stl_num, SpDiggerTaskType task_type, struct Dungeon *dungeon);
 TbBool add_object_for_trap_to_imp_stack(struct Dungeon *dungeon, struct Thing *thing);
 void setup_imp_stack(struct Dungeon *dungeon);
@@ -4461,6 +4461,7 @@ void set_first_creature(struct Thing *creatng)
             cctrl->players_prev_creature_idx = 0;
             dungeon->creatr_list_start = creatng->index;
         }
+        dungeon->creatr_list_of_model[creatng->model]++;
         if (!flag_is_set(cctrl->creature_state_flags,TF2_Spectator) && !(flag_is_set(cctrl->creature_state_flags, TF2_SummonedCreature)))
         {
             dungeon->owned_creatures_of_model[creatng->model]++;
@@ -4486,6 +4487,7 @@ void set_first_creature(struct Thing *creatng)
             cctrl->players_prev_creature_idx = 0;
             dungeon->digger_list_start = creatng->index;
         }
+        dungeon->digger_list_of_model[creatng->model]++;
         if (!flag_is_set(cctrl->creature_state_flags, TF2_Spectator) && !(flag_is_set(cctrl->creature_state_flags, TF2_SummonedCreature)))
         {
             dungeon->num_active_diggers++;
@@ -4529,6 +4531,8 @@ void recalculate_player_creature_digger_lists(PlayerNumber plr_idx)
     dungeon->creatr_list_start = 0;
     dungeon->num_active_diggers = 0;
     dungeon->num_active_creatrs = 0;
+    memset(dungeon->creatr_list_of_model, 0, sizeof(dungeon->creatr_list_of_model));
+    memset(dungeon->digger_list_of_model, 0, sizeof(dungeon->digger_list_of_model));
 
 
     const struct StructureList* slist = get_list_for_thing_class(TCls_Creature);
@@ -4563,6 +4567,7 @@ void recalculate_player_creature_digger_lists(PlayerNumber plr_idx)
                 }
                 cctrl->players_next_creature_idx = 0;
                 cctrl->players_prev_creature_idx = previous_digger;
+                dungeon->digger_list_of_model[creatng->model]++;
                 if (!flag_is_set(cctrl->creature_state_flags,TF2_Spectator) && !(flag_is_set(cctrl->creature_state_flags, TF2_SummonedCreature)))
                 {
                     dungeon->num_active_diggers++;
@@ -4583,6 +4588,7 @@ void recalculate_player_creature_digger_lists(PlayerNumber plr_idx)
                 }
                 cctrl->players_next_creature_idx = 0;
                 cctrl->players_prev_creature_idx = previous_creature;
+                dungeon->creatr_list_of_model[creatng->model]++;
                 if (!flag_is_set(cctrl->creature_state_flags,TF2_Spectator) && !(flag_is_set(cctrl->creature_state_flags, TF2_SummonedCreature)))
                 {
                     dungeon->num_active_creatrs++;
@@ -4642,6 +4648,7 @@ void remove_first_creature(struct Thing *creatng)
             secctrl = creature_control_get_from_thing(sectng);
             secctrl->players_prev_creature_idx = cctrl->players_prev_creature_idx;
         }
+        dungeon->digger_list_of_model[creatng->model]--;
         if (!flag_is_set(cctrl->creature_state_flags, TF2_Spectator) && !flag_is_set(cctrl->creature_state_flags, TF2_SummonedCreature))
         {
             dungeon->owned_creatures_of_model[creatng->model]--;
@@ -4662,6 +4669,7 @@ void remove_first_creature(struct Thing *creatng)
             secctrl = creature_control_get_from_thing(sectng);
             secctrl->players_prev_creature_idx = cctrl->players_prev_creature_idx;
         }
+        dungeon->creatr_list_of_model[creatng->model]--;
         if (!flag_is_set(cctrl->creature_state_flags, TF2_Spectator) && !flag_is_set(cctrl->creature_state_flags, TF2_SummonedCreature))
         {
             dungeon->owned_creatures_of_model[creatng->model]--;
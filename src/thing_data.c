@@ -49,8 +49,10 @@ TbBool is_non_synchronized_thing_class(unsigned char class_id)
 
 static struct Thing *get_oldest_replaceable_effect(void)
 {
-    if (game.thing_lists[TngList_EffectElems].index > 0) {
-        struct Thing *old_effect = thing_get(game.thing_lists[TngList_EffectElems].index);
+    // New things are added at list head, so the oldest one is at its tail
+    const struct ThingClassPool* pool = get_thing_pool_for_list(&game.thing_lists[TngList_EffectElems]);
+    if (pool->oldest > 0) {
+        struct Thing *old_effect = thing_get(pool->oldest);
         if (!thing_is_invalid(old_effect)) {
             return old_effect;
         }
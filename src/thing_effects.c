@@ -30,6 +30,7 @@
 #include "creature_battle.h"
 #include "creature_graphics.h"
 #include "creature_senses.h"
+#include "engine_particles.h"
 #include "engine_redraw.h"
 #include "front_simple.h"
 #include "game_legacy.h"
@@ -725,28 +726,47 @@ void effect_generate_effect_elements(const struct Thing *thing)
     case 1:
     {
         unsigned long argZ;
+        // All elements are created at the same place, so visibility is checked once
+        TbBool visible = any_player_close_enough_to_see(&thing->mappos);
         for (unsigned char i = 0; i < effcst->elements_count; i++)
         {
             if (effcst->kind_min <= 0)
                 continue;
             long n = effcst->kind_min + UNSYNC_RANDOM(effcst->kind_max - effcst->kind_min + 1);
-            elemtng = create_effect_element(&thing->mappos, n, thing->owner);
-            TRACE_THING(elemtng);
-            if (thing_is_invalid(elemtng))
-                break;
+            ParticleIndex part_idx = 0;
+            elemtng = INVALID_THING;
+            if (visible && effect_element_is_particle(n))
+            {
+                part_idx = create_effect_particle(&thing->mappos, n, thing->owner);
+            }
+            if (part_idx == 0)
+            {
+                elemtng = create_effect_element(&thing->mappos, n, thing->owner);
+                TRACE_THING(elemtng);
+                if (thing_is_invalid(elemtng))
+                    break;
+            }
             arg = UNSYNC_RANDOM(DEGREES_360);
             argZ = UNSYNC_RANDOM(DEGREES_180);
             // Setting XY acceleration
             long k = abs(effcst->accel_xy_max - effcst->accel_xy_min);
             if (k <= 1) k = 1;
             long mag = effcst->accel_xy_min + UNSYNC_RANDOM(k);
-            elemtng->veloc_push_add.x.val += distance_with_angle_to_coord_x(mag,arg);
-            elemtng->veloc_push_add.y.val += distance_with_angle_to_coord_y(mag,arg);
+            MapCoordDelta push_x = distance_with_angle_to_coord_x(mag,arg);
+            MapCoordDelta push_y = distance_with_angle_to_coord_y(mag,arg);
             // Setting Z acceleration
             k = abs(effcst->accel_z_max - effcst->accel_z_min);
             if (k <= 1) k = 1;
             mag = effcst->accel_z_min + UNSYNC_RANDOM(k);
-            elemtng->veloc_push_add.z.val += distance_with_angle_to_coord_z(mag,argZ);
+            MapCoordDelta push_z = distance_with_angle_to_coord_z(mag,argZ);
+            if (part_idx != 0)
+            {
+                set_effect_particle_velocity(part_idx, push_x, push_y, push_z, LbArcTanAngle(push_x, push_y) & ANGLE_MASK);
+                continue;
+            }
+            elemtng->veloc_push_add.x.val += push_x;
+            elemtng->veloc_push_add.y.val += push_y;
+            elemtng->veloc_push_add.z.val += push_z;
             elemtng->state_flags |= TF1_PushAdd;
             elemtng->move_angle_xy = LbArcTanAngle(elemtng->veloc_push_add.x.val, elemtng->veloc_push_add.y.val) & ANGLE_MASK;
         }
@@ -762,11 +782,20 @@ void effect_generate_effect_elements(const struct Thing *thing)
             HitPoints mag = effcst->start_health - thing->health;
             arg = (mag << 7) + k/effcst->elements_count;
             set_coords_to_cylindric_shift(&pos, &thing->mappos, mag, arg, 0);
+            k += DEGREES_360;
+            if (effect_element_is_particle(n) && any_player_close_enough_to_see(&pos))
+            {
+                ParticleIndex part_idx = create_effect_particle(&pos, n, thing->owner);
+                if (part_idx != 0)
+                {
+                    set_effect_particle_angle(part_idx, thing->move_angle_xy);
+                    continue;
+                }
+            }
             elemtng = create_effect_element(&pos, n, thing->owner);
             elemtng->move_angle_xy = thing->move_angle_xy;
             TRACE_THING(elemtng);
             SYNCDBG(18,"Created %s",thing_model_name(elemtng));
-            k += DEGREES_360;
         }
         break;
     }
@@ -780,10 +809,19 @@ void effect_generate_effect_elements(const struct Thing *thing)
             HitPoints mag = thing->health;
             arg = (mag << 7) + k/effcst->elements_count;
             set_coords_to_cylindric_shift(&pos, &thing->mappos, 16*mag, arg, 0);
+            k += DEGREES_360;
+            if (effect_element_is_particle(n) && any_player_close_enough_to_see(&pos))
+            {
+                ParticleIndex part_idx = create_effect_particle(&pos, n, thing->owner);
+                if (part_idx != 0)
+                {
+                    set_effect_particle_angle(part_idx, arg);
+                    continue;
+                }
+            }
             elemtng = create_effect_element(&pos, n, thing->owner);
             elemtng->move_angle_xy = arg;
             TRACE_THING(elemtng);
-            k += DEGREES_360;
         }
         break;
     }
@@ -1180,16 +1218,28 @@ TbBool explosion_affecting_door(struct Thing *tngsrc, struct Thing *tngdst, cons
 }
 
 /**
- * Computes and applies damage the effect associated to a spell makes to things at given map block.
+ * Returns range up to which an explosion of given owner can affect things.
+ * Friendly fire may have its range changed, and the larger of both ranges is used.
+ */
+static MapCoordDelta get_explosion_reach(MapCoordDelta max_dist, PlayerNumber owner)
+{
+    if ((owner < 0) || (owner >= PLAYERS_COUNT))
+        return max_dist;
+    MapCoordDelta friendly_dist = max_dist * game.conf.rules[owner].magic.friendly_fight_area_range_percent / 100;
+    return max(max_dist, friendly_dist);
+}
+
+/**
+ * Computes and applies damage the effect associated to a spell makes to things on given map area.
  * @param efftng The effect thing which represents the spell.
  * @param tngsrc The thing being source of the spell.
- * @param mapblk Map block on which all targets are to be affected by the spell.
  * @param max_dist Range of the spell on map, used to compute damage decaying with distance; in map coordinates.
  * @param max_damage Damage at epicenter of the explosion.
  * @param blow_strength The strength of hitwave blowing creatures out of affected area.
  * @param shotst the shot information used to determine damage, bow and spell effects
  */
-long explosion_effect_affecting_map_block(struct Thing *efftng, struct Thing *tngsrc, struct Map *mapblk,
+static long explosion_effect_affecting_map_rect(struct Thing *efftng, struct Thing *tngsrc,
+    MapSubtlCoord start_x, MapSubtlCoord end_x, MapSubtlCoord start_y, MapSubtlCoord end_y,
     MapCoordDelta max_dist, HitPoints max_damage, long blow_strength, struct ShotConfigStats* shotst)
 {
     if (!thing_exists(tngsrc)) //Shooter may already be dead
@@ -1197,19 +1247,11 @@ long explosion_effect_affecting_map_block(struct Thing *efftng, struct Thing *tn
         tngsrc = efftng;
     }
     long num_affected = 0;
-    unsigned long k = 0;
-    long i = get_mapwho_thing_index(mapblk);
-    while (i != 0)
+    struct AreaThingsQuery query;
+    start_area_things_query(&query, &efftng->mappos, get_explosion_reach(max_dist, tngsrc->owner), start_x, end_x, start_y, end_y);
+    struct Thing* thing = get_next_area_things_query_thing(&query);
+    while (!thing_is_invalid(thing))
     {
-        struct Thing* thing = thing_get(i);
-        TRACE_THING(thing);
-        if (thing_is_invalid(thing))
-        {
-            ERRORLOG("Jump to invalid thing detected");
-            break;
-        }
-        i = thing->next_on_mapblk;
-        // Per thing processing block
         if ((thing->class_id == TCls_Door) && (efftng->shot_effect.hit_type != THit_CrtrsOnlyNotOwn)) //TODO: Find pretty way to say that WoP traps should not destroy doors. And make it configurable through configs.
         {
             if (explosion_affecting_door(tngsrc, thing, &efftng->mappos, max_dist, max_damage, blow_strength, tngsrc->owner))
@@ -1224,15 +1266,9 @@ long explosion_effect_affecting_map_block(struct Thing *efftng, struct Thing *tn
                 num_affected++;
             }
         }
-        // Per thing processing block ends
-        k++;
-        if (k > THINGS_COUNT)
-        {
-            ERRORLOG("Infinite loop detected when sweeping things list");
-            break_mapwho_infinite_chain(mapblk);
-            break;
-        }
+        thing = get_next_area_things_query_thing(&query);
     }
+    end_area_things_query(&query);
     return num_affected;
 }
 
@@ -1311,14 +1347,7 @@ void word_of_power_affecting_area(struct Thing *efftng, struct Thing *tngsrc, st
     if (stl_ymax > game.map_subtiles_y) {
       stl_ymax = game.map_subtiles_y;
     }
-    for (long stl_y = stl_ymin; stl_y <= stl_ymax; stl_y++)
-    {
-        for (long stl_x = stl_xmin; stl_x <= stl_xmax; stl_x++)
-        {
-            struct Map* mapblk = get_map_block_at(stl_x, stl_y);
-            explosion_effect_affecting_map_block(efftng, tngsrc, mapblk, max_dist, shotst->area_damage, shotst->area_blow, shotst);
-        }
-    }
+    explosion_effect_affecting_map_rect(efftng, tngsrc, stl_xmin, stl_xmax, stl_ymin, stl_ymax, max_dist, shotst->area_damage, shotst->area_blow, shotst);
 }
 
 /**
@@ -1336,71 +1365,6 @@ TbBool area_effect_can_affect_thing(const struct Thing *thing, HitTargetFlags hi
     return thing_is_shootable(thing, shot_owner, hit_targets);
 }
 
-/**
- * Affects things on a map blocks with explosion effect, if only they should be affected with given hit type.
- *
- * @param tngsrc The thing which caused the affect.
- * @param mapblk Map blocks on which are creatures should be affected.
- * @param pos Position of the effect epicenter.
- * @param max_dist Max distance at which creatures are affected, in map coordinates.
- * @param max_damage Damage at epicenter of the explosion.
- * @param blow_strength The strength of hitwave blowing creatures out of affected area.
- * @param hit_targets Defines which things are affected.
- */
-long explosion_affecting_map_block(struct Thing *tngsrc, const struct Map *mapblk, const struct Coord3d *pos,
-    MapCoord max_dist, HitPoints max_damage, long blow_strength, HitTargetFlags hit_targets)
-{
-    PlayerNumber owner;
-    if (thing_exists(tngsrc))
-        owner = tngsrc->owner;
-    else
-        owner = -1;
-    long num_affected = 0;
-    unsigned long k = 0;
-    long i = get_mapwho_thing_index(mapblk);
-    while (i != 0)
-    {
-        struct Thing* thing = thing_get(i);
-        TRACE_THING(thing);
-        if (thing_is_invalid(thing))
-        {
-            WARNLOG("Jump out of things array");
-            break;
-        }
-        i = thing->next_on_mapblk;
-        // Should never happen - only existing thing shall be in list
-        if (!thing_exists(thing))
-        {
-            WARNLOG("Jump to non-existing thing");
-            break;
-        }
-        // Per thing processing block
-        if (area_effect_can_affect_thing(thing, hit_targets, owner))
-        {
-            if (thing_is_shot(tngsrc))
-            {
-                struct ShotConfigStats* shotst = get_shot_model_stats(tngsrc->model);
-                if (explosion_affecting_thing(tngsrc, thing, pos, max_dist, max_damage, blow_strength, shotst))
-                    num_affected++;
-            }
-            else
-            {
-                ERRORLOG("Exploding thing %s is not a shot", thing_model_name(tngsrc));
-                break;
-            }
-        }
-        // Per thing processing block ends
-        k++;
-        if (k > THINGS_COUNT)
-        {
-            ERRORLOG("Infinite loop detected when sweeping things list");
-            break_mapwho_infinite_chain(mapblk);
-            break;
-        }
-    }
-    return num_affected;
-}
-
 /**
  * Affects things on an area with explosion effect, if only they should be affected with given hit type.
  *
@@ -1439,15 +1403,31 @@ long explosion_affecting_area(struct Thing *tngsrc, const struct Coord3d *pos, M
       end_y = game.map_subtiles_y;
     if (flag_is_set(start_params.debug_flags,DFlg_ShotsDamage))
         create_price_effect(pos, my_player_number, max_damage);
+    PlayerNumber owner;
+    if (thing_exists(tngsrc))
+        owner = tngsrc->owner;
+    else
+        owner = -1;
     long num_affected = 0;
-    for (MapSubtlCoord stl_y = start_y; stl_y <= end_y; stl_y++)
+    struct AreaThingsQuery query;
+    start_area_things_query(&query, pos, get_explosion_reach(max_dist, owner), start_x, end_x, start_y, end_y);
+    struct Thing* thing = get_next_area_things_query_thing(&query);
+    while (!thing_is_invalid(thing))
     {
-        for (MapSubtlCoord stl_x = start_x; stl_x <= end_x; stl_x++)
+        if (area_effect_can_affect_thing(thing, hit_targets, owner))
         {
-            const struct Map* mapblk = get_map_block_at(stl_x, stl_y);
-            num_affected += explosion_affecting_map_block(tngsrc, mapblk, pos, max_dist, max_damage, blow_strength, hit_targets);
+            if (!thing_is_shot(tngsrc))
+            {
+                ERRORLOG("Exploding thing %s is not a shot", thing_model_name(tngsrc));
+                break;
+            }
+            struct ShotConfigStats* shotst = get_shot_model_stats(tngsrc->model);
+            if (explosion_affecting_thing(tngsrc, thing, pos, max_dist, max_damage, blow_strength, shotst))
+                num_affected++;
         }
+        thing = get_next_area_things_query_thing(&query);
     }
+    end_area_things_query(&query);
     return num_affected;
 }
 
@@ -1519,51 +1499,6 @@ TbBool poison_cloud_affecting_thing(struct Thing *tngsrc, struct Thing *tngdst,
     return affected;
 }
 
-long poison_cloud_affecting_map_block(struct Thing *tngsrc, const struct Map *mapblk, const struct Coord3d *pos,
-    MapCoord max_dist, HitPoints max_damage, long blow_strength, HitTargetFlags hit_targets, unsigned char area_affect_type, SpellKind spell_idx)
-{
-    PlayerNumber owner;
-    if (thing_exists(tngsrc))
-        owner = tngsrc->owner;
-    else
-        owner = -1;
-    long num_affected = 0;
-    unsigned long k = 0;
-    long i = get_mapwho_thing_index(mapblk);
-    while (i != 0)
-    {
-        struct Thing* thing = thing_get(i);
-        TRACE_THING(thing);
-        if (thing_is_invalid(thing))
-        {
-            WARNLOG("Jump out of things array");
-            break;
-        }
-        i = thing->next_on_mapblk;
-        // Should never happen - only existing thing shall be in list
-        if (!thing_exists(thing))
-        {
-            WARNLOG("Jump to non-existing thing");
-            break;
-        }
-        // Per thing processing block
-        if (area_effect_can_affect_thing(thing, hit_targets, owner))
-        {
-            if (poison_cloud_affecting_thing(tngsrc, thing, pos, max_dist, max_damage, blow_strength, area_affect_type, owner, spell_idx))
-                num_affected++;
-        }
-        // Per thing processing block ends
-        k++;
-        if (k > THINGS_COUNT)
-        {
-            ERRORLOG("Infinite loop detected when sweeping things list");
-            break_mapwho_infinite_chain(mapblk);
-            break;
-        }
-    }
-    return num_affected;
-}
-
 long poison_cloud_affecting_area(struct Thing *tngsrc, struct Coord3d *pos, long max_dist, long max_damage, unsigned char area_affect_type, SpellKind spell_idx)
 {
     int dmg_divider = 10;
@@ -1599,16 +1534,26 @@ long poison_cloud_affecting_area(struct Thing *tngsrc, struct Coord3d *pos, long
     if (end_y > game.map_subtiles_y) {
         end_y = game.map_subtiles_y;
     }
+    HitTargetFlags hit_targets = hit_type_to_hit_targets(tngsrc->shot_effect.hit_type);
+    PlayerNumber owner;
+    if (thing_exists(tngsrc))
+        owner = tngsrc->owner;
+    else
+        owner = -1;
     long num_affected = 0;
-    for (MapSubtlCoord stl_y = start_y; stl_y <= end_y; stl_y++)
+    struct AreaThingsQuery query;
+    start_area_things_query(&query, pos, max_dist, start_x, end_x, start_y, end_y);
+    struct Thing* thing = get_next_area_things_query_thing(&query);
+    while (!thing_is_invalid(thing))
     {
-        for (MapSubtlCoord stl_x = start_x; stl_x <= end_x; stl_x++)
+        if (area_effect_can_affect_thing(thing, hit_targets, owner))
         {
-            HitTargetFlags hit_targets = hit_type_to_hit_targets(tngsrc->shot_effect.hit_type);
-            struct Map* mapblk = get_map_block_at(stl_x, stl_y);
-            num_affected += poison_cloud_affecting_map_block(tngsrc, mapblk, pos, max_dist, max_damage/dmg_divider, 0, hit_targets, area_affect_type, spell_idx);
+            if (poison_cloud_affecting_thing(tngsrc, thing, pos, max_dist, max_damage/dmg_divider, 0, area_affect_type, owner, spell_idx))
+                num_affected++;
         }
+        thing = get_next_area_things_query_thing(&query);
     }
+    end_area_things_query(&query);
     return num_affected;
 }
 
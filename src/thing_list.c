@@ -35,6 +35,7 @@
 #include "thing_creature.h"
 #include "thing_navigate.h"
 #include "thing_factory.h"
+#include "creature_battle.h"
 #include "creature_senses.h"
 #include "spdigger_stack.h"
 #include "power_hand.h"
@@ -78,6 +79,21 @@ Thing_Class_Func class_functions[] = {
 
 unsigned long thing_create_errors = 0;
 
+/** Max amount of candidates collected at once by all area queries, including nested ones. */
+#define AREA_THINGS_SCRATCH_COUNT (2*THINGS_COUNT)
+
+/** Counts changes of mapwho chains, so that area queries know when collected candidates are outdated. */
+static unsigned long mapwho_changes_count;
+static struct AreaThingCandidate area_things_scratch[AREA_THINGS_SCRATCH_COUNT];
+static long area_things_scratch_used;
+
+/** Amount of creatures linked into mapwho chains, per subtile and per whole subtile row and column. */
+static unsigned short mapwho_creatures_count[(MAX_SUBTILES_X+1)*(MAX_SUBTILES_Y+1)];
+static unsigned short mapwho_creatures_in_row[MAX_SUBTILES_Y+1];
+static unsigned short mapwho_creatures_in_column[MAX_SUBTILES_X+1];
+/** Subtile number at which each creature was counted, increased by one; zero if it is not counted. */
+static SubtlCodedCoords mapwho_creature_counted_at[THINGS_COUNT];
+
 const struct NamedCommand class_commands[] = {
   {"Object",        TCls_Object},
   {"Shot",          TCls_Shot},
@@ -94,6 +110,11 @@ const struct NamedCommand class_commands[] = {
   };
 
 /******************************************************************************/
+/** Dense pools of things in each class list; not saved, as they're rebuilt from the lists. */
+static struct ThingClassPool thing_pools[THING_CLASS_LISTS_COUNT];
+/** Position of each thing within the items[] of its class pool. */
+static ThingIndex thing_pool_pos[THINGS_COUNT];
+/******************************************************************************/
 
 static void update_thing_interpolation(struct Thing *thing)
 {
@@ -128,6 +149,21 @@ void add_thing_to_list(struct Thing *thing, struct StructureList *list)
         prevtng->prev_of_class = thing->index;
     }
     list->index = thing->index;
+    struct ThingClassPool* pool = get_thing_pool_for_list(list);
+    if (pool != NULL)
+    {
+        if (pool->count >= sizeof(pool->items)/sizeof(pool->items[0]))
+        {
+            ERRORLOG("Pool overflow when adding thing %d to list",(int)thing->index);
+            return;
+        }
+        if (pool->count == 0) {
+            pool->oldest = thing->index;
+        }
+        thing_pool_pos[thing->index] = pool->count;
+        pool->items[pool->count] = thing->index;
+        pool->count++;
+    }
 }
 
 void remove_thing_from_list(struct Thing *thing, struct StructureList *slist)
@@ -135,6 +171,20 @@ void remove_thing_from_list(struct Thing *thing, struct StructureList *slist)
     struct Thing *sibtng;
     if ((thing->alloc_flags & TAlF_IsInStrucList) == 0)
         return;
+    struct ThingClassPool* pool = get_thing_pool_for_list(slist);
+    if ((pool != NULL) && (pool->count > 0))
+    {
+        // Swap the last item into the removed position
+        ThingIndex pos = thing_pool_pos[thing->index];
+        pool->count--;
+        ThingIndex last_idx = pool->items[pool->count];
+        pool->items[pos] = last_idx;
+        thing_pool_pos[last_idx] = pos;
+        thing_pool_pos[thing->index] = 0;
+        if (pool->oldest == thing->index) {
+            pool->oldest = thing->prev_of_class;
+        }
+    }
     if (thing->index == slist->index)
     {
         slist->index = thing->next_of_class;
@@ -208,6 +258,64 @@ struct StructureList *get_list_for_thing_class(ThingClass class_id)
     }
 }
 
+/**
+ * Returns the dense pool which accompanies given thing list, or NULL if the list has none.
+ */
+struct ThingClassPool *get_thing_pool_for_list(const struct StructureList *list)
+{
+    long list_idx = list - game.thing_lists;
+    if ((list_idx < 0) || (list_idx >= THING_CLASS_LISTS_COUNT)) {
+        return NULL;
+    }
+    return &thing_pools[list_idx];
+}
+
+void clear_thing_class_pools(void)
+{
+    for (int i = 0; i < THING_CLASS_LISTS_COUNT; i++)
+    {
+        thing_pools[i].count = 0;
+        thing_pools[i].oldest = 0;
+    }
+    memset(thing_pool_pos, 0, sizeof(thing_pool_pos));
+}
+
+/**
+ * Refills class pools from the linked lists; used after game state was loaded or resynced.
+ */
+void rebuild_thing_class_pools(void)
+{
+    clear_thing_class_pools();
+    for (int list_idx = 0; list_idx < THING_CLASS_LISTS_COUNT; list_idx++)
+    {
+        struct ThingClassPool* pool = &thing_pools[list_idx];
+        unsigned long k = 0;
+        long i = game.thing_lists[list_idx].index;
+        while (i != 0)
+        {
+            struct Thing* thing = thing_get(i);
+            if (thing_is_invalid(thing))
+            {
+                ERRORLOG("Jump to invalid thing detected");
+                break;
+            }
+            // Per-thing code
+            thing_pool_pos[i] = pool->count;
+            pool->items[pool->count] = i;
+            pool->count++;
+            pool->oldest = i;
+            // Per-thing code ends
+            i = thing->next_of_class;
+            k++;
+            if (k >= SYNCED_THINGS_COUNT)
+            {
+                ERRORLOG("Infinite loop detected when sweeping things list");
+                break;
+            }
+        }
+    }
+}
+
 /** Removes the given thing from a linked list which contains all things of the same class.
  *
  * @param thing The thing to be unlinked from list chain.
@@ -218,6 +326,7 @@ void remove_thing_from_its_class_list(struct Thing *thing)
     if (slist != NULL) {
         remove_thing_from_list(thing, slist);
     }
+    digger_stack_thing_unlisted(thing);
 }
 
 ThingIndex get_thing_class_list_head(ThingClass class_id)
@@ -238,6 +347,7 @@ void add_thing_to_its_class_list(struct Thing *thing)
     struct StructureList* slist = get_list_for_thing_class(thing->class_id);
     if (slist != NULL)
         add_thing_to_list(thing, slist);
+    digger_stack_thing_listed(thing);
 }
 
 /**
@@ -1043,6 +1153,8 @@ static void update_thing_animation(struct Thing *thing)
 void update_things_in_list(struct StructureList *list)
 {
     SYNCDBG(18,"Starting");
+    // The sweep follows the linked list, not the class pool; the order of updates,
+    // and reading next thing before updating current one, is part of synced game state
     unsigned long k = 0;
     int i = list->index;
     while (i != 0)
@@ -1557,6 +1669,73 @@ void init_creature_states_for_player(PlayerNumber plyr_idx)
     }
 }
 
+static void count_mapwho_creature(const struct Thing *thing)
+{
+    if ((thing->class_id != TCls_Creature) || (thing->index <= 0) || (thing->index >= THINGS_COUNT))
+        return;
+    MapSubtlCoord stl_x = thing->mappos.x.stl.num;
+    MapSubtlCoord stl_y = thing->mappos.y.stl.num;
+    SubtlCodedCoords stl_num = get_subtile_number(stl_x, stl_y);
+    mapwho_creature_counted_at[thing->index] = stl_num + 1;
+    mapwho_creatures_count[stl_num]++;
+    mapwho_creatures_in_row[stl_num_decode_y(stl_num)]++;
+    mapwho_creatures_in_column[stl_num_decode_x(stl_num)]++;
+}
+
+static void uncount_mapwho_creature(const struct Thing *thing)
+{
+    if ((thing->index <= 0) || (thing->index >= THINGS_COUNT))
+        return;
+    SubtlCodedCoords stl_num = mapwho_creature_counted_at[thing->index] - 1;
+    if (stl_num < 0)
+        return;
+    mapwho_creature_counted_at[thing->index] = 0;
+    mapwho_creatures_count[stl_num]--;
+    mapwho_creatures_in_row[stl_num_decode_y(stl_num)]--;
+    mapwho_creatures_in_column[stl_num_decode_x(stl_num)]--;
+}
+
+/**
+ * Recounts creatures linked into mapwho chains.
+ * Needs to be called whenever things are replaced without relinking, ie. on level start and after loading.
+ */
+void rebuild_mapwho_creature_counts(void)
+{
+    memset(mapwho_creatures_count, 0, sizeof(mapwho_creatures_count));
+    memset(mapwho_creatures_in_row, 0, sizeof(mapwho_creatures_in_row));
+    memset(mapwho_creatures_in_column, 0, sizeof(mapwho_creatures_in_column));
+    memset(mapwho_creature_counted_at, 0, sizeof(mapwho_creature_counted_at));
+    for (ThingIndex i = 1; i < THINGS_COUNT; i++)
+    {
+        struct Thing* thing = thing_get(i);
+        if (thing_exists(thing) && ((thing->alloc_flags & TAlF_IsInMapWho) != 0)) {
+            count_mapwho_creature(thing);
+        }
+    }
+}
+
+/** Returns amount of creatures in mapwho chain of given subtile. */
+unsigned short get_mapwho_creatures_count_at(MapSubtlCoord stl_x, MapSubtlCoord stl_y)
+{
+    return mapwho_creatures_count[get_subtile_number(stl_x, stl_y)];
+}
+
+/** Returns amount of creatures in mapwho chains of whole subtile row. */
+unsigned short get_mapwho_creatures_count_in_row(MapSubtlCoord stl_y)
+{
+    if ((stl_y < 0) || (stl_y > MAX_SUBTILES_Y))
+        return 0;
+    return mapwho_creatures_in_row[stl_y];
+}
+
+/** Returns amount of creatures in mapwho chains of whole subtile column. */
+unsigned short get_mapwho_creatures_count_in_column(MapSubtlCoord stl_x)
+{
+    if ((stl_x < 0) || (stl_x > MAX_SUBTILES_X))
+        return 0;
+    return mapwho_creatures_in_column[stl_x];
+}
+
 void remove_thing_from_mapwho(struct Thing *thing)
 {
     struct Thing *mwtng;
@@ -1595,6 +1774,8 @@ void remove_thing_from_mapwho(struct Thing *thing)
     thing->next_on_mapblk = 0;
     thing->prev_on_mapblk = 0;
     thing->alloc_flags &= ~TAlF_IsInMapWho;
+    uncount_mapwho_creature(thing);
+    mapwho_changes_count++;
 }
 
 void place_thing_in_mapwho(struct Thing *thing)
@@ -1617,6 +1798,155 @@ void place_thing_in_mapwho(struct Thing *thing)
     set_mapwho_thing_index(mapblk, thing->index);
     thing->prev_on_mapblk = 0;
     thing->alloc_flags |= TAlF_IsInMapWho;
+    count_mapwho_creature(thing);
+    battle_candidates_creature_placed(thing);
+    mapwho_changes_count++;
+}
+
+/**
+ * Collects candidates from the following blocks of an area query, until the scratch array is full.
+ * Candidates of a block are either all collected, or none.
+ */
+static void collect_area_things_query_candidates(struct AreaThingsQuery *query)
+{
+    query->mapwho_changes = mapwho_changes_count;
+    while (query->blocks_collected < query->blocks_count)
+    {
+        long block_num = query->blocks_collected;
+        MapSubtlCoord stl_x = query->start_x + block_num % query->width;
+        MapSubtlCoord stl_y = query->start_y + block_num / query->width;
+        const struct Map* mapblk = get_map_block_at(stl_x, stl_y);
+        SubtlCodedCoords stl_num = get_subtile_number(stl_x, stl_y);
+        long block_first = query->count;
+        unsigned long k = 0;
+        long i = get_mapwho_thing_index(mapblk);
+        while (i != 0)
+        {
+            struct Thing* thing = thing_get(i);
+            TRACE_THING(thing);
+            if (thing_is_invalid(thing))
+            {
+                WARNLOG("Jump out of things array");
+                break;
+            }
+            i = thing->next_on_mapblk;
+            if (!thing_exists(thing))
+            {
+                WARNLOG("Jump to non-existing thing");
+                break;
+            }
+            // Things out of range are never affected, so they're not even returned
+            if (get_2d_distance(&query->center, &thing->mappos) <= query->max_dist)
+            {
+                if (query->first + query->count >= AREA_THINGS_SCRATCH_COUNT)
+                {
+                    // No space left; collect the block again when the scratch is free
+                    query->count = block_first;
+                    if (block_first == 0) {
+                        ERRORLOG("Too many things on block (%d,%d), some were skipped",(int)stl_x,(int)stl_y);
+                        query->blocks_collected++;
+                    }
+                    area_things_scratch_used = query->first + query->count;
+                    return;
+                }
+                struct AreaThingCandidate* cand = &area_things_scratch[query->first + query->count];
+                cand->index = thing->index;
+                cand->stl_num = stl_num;
+                cand->block_num = block_num;
+                query->count++;
+            }
+            k++;
+            if (k > THINGS_COUNT)
+            {
+                ERRORLOG("Infinite loop detected when sweeping things list");
+                break_mapwho_infinite_chain(mapblk);
+                break;
+            }
+        }
+        query->blocks_collected++;
+    }
+    area_things_scratch_used = query->first + query->count;
+}
+
+/**
+ * Starts a query for things on given rectangle of map blocks, within given distance from a point.
+ * The rectangle bounds must be within map. Queries may be nested, but each has to be ended
+ * with end_area_things_query() before the one started earlier is continued.
+ */
+void start_area_things_query(struct AreaThingsQuery *query, const struct Coord3d *pos, MapCoordDelta max_dist,
+    MapSubtlCoord start_x, MapSubtlCoord end_x, MapSubtlCoord start_y, MapSubtlCoord end_y)
+{
+    query->center = *pos;
+    query->max_dist = max_dist;
+    query->start_x = start_x;
+    query->start_y = start_y;
+    query->width = end_x - start_x + 1;
+    query->blocks_count = query->width * (end_y - start_y + 1);
+    if ((query->width <= 0) || (end_y < start_y))
+        query->blocks_count = 0;
+    query->blocks_collected = 0;
+    query->current_block = -1;
+    query->skip_current_block = false;
+    query->first = area_things_scratch_used;
+    query->count = 0;
+    query->next = 0;
+    collect_area_things_query_candidates(query);
+}
+
+/**
+ * Returns next thing of an area query, or invalid thing if there are no more.
+ * Affecting the returned thing is allowed to create, delete and move things; if mapwho chains
+ * are changed, the blocks not yet visited are scanned again, so results are the same
+ * as when walking the chains directly.
+ */
+struct Thing *get_next_area_things_query_thing(struct AreaThingsQuery *query)
+{
+    while (true)
+    {
+        if (query->mapwho_changes != mapwho_changes_count)
+        {
+            // Candidates from blocks after the current one may be outdated
+            long n = query->next;
+            while ((n < query->count) && (area_things_scratch[query->first + n].block_num <= query->current_block))
+                n++;
+            query->count = n;
+            query->blocks_collected = query->current_block + 1;
+            collect_area_things_query_candidates(query);
+        }
+        if (query->next >= query->count)
+        {
+            if (query->blocks_collected >= query->blocks_count)
+                return INVALID_THING;
+            // All collected candidates were used; reuse the scratch space for next blocks
+            query->count = 0;
+            query->next = 0;
+            collect_area_things_query_candidates(query);
+            continue;
+        }
+        const struct AreaThingCandidate* cand = &area_things_scratch[query->first + query->next];
+        query->next++;
+        if (query->skip_current_block && (cand->block_num == query->current_block))
+            continue;
+        query->current_block = cand->block_num;
+        query->skip_current_block = false;
+        struct Thing* thing = thing_get(cand->index);
+        // If the thing was removed from the block, its chain was broken when walked directly
+        if (!thing_exists(thing) || ((thing->alloc_flags & TAlF_IsInMapWho) == 0) ||
+            (get_subtile_number(thing->mappos.x.stl.num, thing->mappos.y.stl.num) != cand->stl_num))
+        {
+            query->skip_current_block = true;
+            continue;
+        }
+        return thing;
+    }
+}
+
+void end_area_things_query(struct AreaThingsQuery *query)
+{
+    area_things_scratch_used = query->first;
+    query->count = 0;
+    query->next = 0;
+    query->blocks_collected = query->blocks_count;
 }
 
 struct Thing *find_base_thing_on_mapwho(ThingClass oclass, ThingModel model, MapSubtlCoord stl_x, MapSubtlCoord stl_y)
@@ -2052,6 +2382,11 @@ struct Thing *get_highest_score_enemy_creature_within_distance_possible_to_attac
     param.primary_number = creatng->index;
     param.secondary_number = dist;
     param.tertiary_number = move_on_ground;
+    // Fighters within a battle share the list of creatures near it
+    struct Thing* enmtng;
+    if (get_battle_candidate_with_filter(creatng, filter, &param, &enmtng)) {
+        return enmtng;
+    }
     return get_nth_thing_of_class_with_filter(filter, &param, 0);
 }
 
@@ -2316,7 +2651,8 @@ long electricity_affecting_area(const struct Coord3d *pos, PlayerNumber immune_p
         // Per-thing code
         if (!thing_is_picked_up(thing))
         {
-            if (thing->owner != immune_plyr_idx)
+            // Creatures outside of range are never affected; skip them before checking sight
+            if ((thing->owner != immune_plyr_idx) && (get_chessboard_distance(pos, &thing->mappos) < range))
             {
               if (!creature_under_spell_effect(thing, CSAfF_Armour))
               {
@@ -2409,6 +2745,30 @@ long do_to_players_all_creatures_of_model(PlayerNumber plyr_idx, int crmodel, Th
     return count;
 }
 
+/**
+ * Counts creatures on one of dungeon creature lists which match given model, using the per-model counters of that list.
+ * Gives the same result as count_player_list_creatures_of_model() on that list, without walking it.
+ * @param list_of_model Per-model counters of the list, creatr_list_of_model or digger_list_of_model.
+ * @param plyr_idx Owner of the dungeon.
+ * @param crmodel Creature model, or a model wildcard.
+ */
+long count_dungeon_list_creatures_of_model(const unsigned short *list_of_model, PlayerNumber plyr_idx, ThingModel crmodel)
+{
+    if (!is_creature_model_wildcard(crmodel))
+    {
+        if ((crmodel < 0) || (crmodel >= CREATURE_TYPES_MAX))
+            return 0;
+        return list_of_model[crmodel];
+    }
+    long count = 0;
+    for (ThingModel model = 0; model < game.conf.crtr_conf.model_count; model++)
+    {
+        if ((list_of_model[model] > 0) && creature_model_matches_model(model, plyr_idx, crmodel))
+            count += list_of_model[model];
+    }
+    return count;
+}
+
 /** Counts creatures of given model belonging to given player.
  * @param plyr_idx Target player.
  * @param crmodel Creature model, or CREATURE_ANY for all (except special diggers).
@@ -2419,29 +2779,31 @@ long count_player_creatures_of_model(PlayerNumber plyr_idx, int crmodel)
 {
     SYNCDBG(19,"Starting");
     struct Dungeon* dungeon = get_players_num_dungeon(plyr_idx);
-    Thing_Maximizer_Filter filter = anywhere_thing_filter_is_of_class_and_model_and_owned_by;
-    struct CompoundTngFilterParam param;
-    param.class_id = TCls_Creature;
-    param.model_id = (is_creature_model_wildcard(crmodel)) ? CREATURE_ANY : crmodel;
-    param.plyr_idx = plyr_idx;
-    param.primary_number = -1;
-    param.secondary_number = -1;
-    param.tertiary_number = -1;
     if (dungeon_invalid(dungeon) || player_is_neutral(plyr_idx)) {
         // Invalid dungeon - use list of creatures not associated to any dungeon
+        Thing_Maximizer_Filter filter = anywhere_thing_filter_is_of_class_and_model_and_owned_by;
+        struct CompoundTngFilterParam param;
+        param.class_id = TCls_Creature;
+        param.model_id = (is_creature_model_wildcard(crmodel)) ? CREATURE_ANY : crmodel;
+        param.plyr_idx = plyr_idx;
+        param.primary_number = -1;
+        param.secondary_number = -1;
+        param.tertiary_number = -1;
         return count_player_list_creatures_with_filter(game.nodungeon_creatr_list_start, filter, &param);
     }
     TbBool is_spec_digger = (crmodel > 0) && creature_kind_is_for_dungeon_diggers_list(plyr_idx, crmodel);
+    // Wildcards are counted as CREATURE_ANY on the lists they select
+    ThingModel list_model = (is_creature_model_wildcard(crmodel)) ? CREATURE_ANY : crmodel;
     long count = 0;
     if (((crmodel > 0) && (!is_creature_model_wildcard(crmodel)) && !is_spec_digger) ||
         (crmodel == CREATURE_ANY) || (crmodel == CREATURE_NOT_A_DIGGER))
     {
-        count += count_player_list_creatures_with_filter(dungeon->creatr_list_start, filter, &param);
+        count += count_dungeon_list_creatures_of_model(dungeon->creatr_list_of_model, plyr_idx, list_model);
     }
     if (((crmodel > 0) && (!is_creature_model_wildcard(crmodel)) && is_spec_digger) ||
         (crmodel == CREATURE_ANY) || (crmodel == CREATURE_DIGGER))
     {
-        count += count_player_list_creatures_with_filter(dungeon->digger_list_start, filter, &param);
+        count += count_dungeon_list_creatures_of_model(dungeon->digger_list_of_model, plyr_idx, list_model);
     }
     return count;
 }
@@ -2749,11 +3111,11 @@ struct Thing *get_random_players_creature_of_model(PlayerNumber plyr_idx, ThingM
     struct Dungeon* dungeon = get_players_num_dungeon(plyr_idx);
     if (is_spec_digger)
     {
-        total_count = count_player_list_creatures_of_model(dungeon->digger_list_start, crmodel);
+        total_count = count_dungeon_list_creatures_of_model(dungeon->digger_list_of_model, plyr_idx, crmodel);
     }
     else
     {
-        total_count = count_player_list_creatures_of_model(dungeon->creatr_list_start, crmodel);
+        total_count = count_dungeon_list_creatures_of_model(dungeon->creatr_list_of_model, plyr_idx, crmodel);
     }
     if (total_count < 1)
     {
@@ -2779,12 +3141,12 @@ struct Thing *get_random_players_creature_of_model_on_territory(PlayerNumber ply
     if (is_spec_digger)
     {
         total_count = count_player_list_creatures_of_model_on_territory(dungeon->digger_list_start, crmodel, friendly);
-        model_count = count_player_list_creatures_of_model(dungeon->digger_list_start, crmodel);
+        model_count = count_dungeon_list_creatures_of_model(dungeon->digger_list_of_model, plyr_idx, crmodel);
     }
     else
     {
         total_count = count_player_list_creatures_of_model_on_territory(dungeon->creatr_list_start, crmodel, friendly);
-        model_count = count_player_list_creatures_of_model(dungeon->creatr_list_start, crmodel);
+        model_count = count_dungeon_list_creatures_of_model(dungeon->creatr_list_of_model, plyr_idx, crmodel);
     }
     if (total_count < 1)
     {
@@ -3172,12 +3534,16 @@ struct Thing *get_thing_spiral_near_map_block_with_filter(MapCoord x, MapCoord y
     SYNCDBG(19,"Starting");
     struct Thing* retng = INVALID_THING;
     long maximizer = 0;
+    struct Map* center_blk = get_spiral_center_map_block(coord_subtile(x), coord_subtile(y), spiral_len);
     for (int around_val = 0; around_val < spiral_len; around_val++)
     {
         struct MapOffset* sstep = &spiral_step[around_val];
-        MapSubtlCoord sx = coord_subtile(x) + (MapSubtlCoord)sstep->h;
-        MapSubtlCoord sy = coord_subtile(y) + (MapSubtlCoord)sstep->v;
-        struct Map* mapblk = get_map_block_at(sx, sy);
+        struct Map* mapblk;
+        if (center_blk != NULL) {
+            mapblk = center_blk + sstep->both;
+        } else {
+            mapblk = get_map_block_at(coord_subtile(x) + (MapSubtlCoord)sstep->h, coord_subtile(y) + (MapSubtlCoord)sstep->v);
+        }
         if (!map_block_invalid(mapblk))
         {
             long i = get_mapwho_thing_index(mapblk);
@@ -3206,12 +3572,16 @@ long count_things_spiral_near_map_block_with_filter(MapCoord x, MapCoord y, long
     SYNCDBG(19,"Starting");
     long count = 0;
     long maximizer = 0;
+    struct Map* center_blk = get_spiral_center_map_block(coord_subtile(x), coord_subtile(y), spiral_len);
     for (int around_val = 0; around_val < spiral_len; around_val++)
     {
         struct MapOffset* sstep = &spiral_step[around_val];
-        MapSubtlCoord sx = coord_subtile(x) + (MapSubtlCoord)sstep->h;
-        MapSubtlCoord sy = coord_subtile(y) + (MapSubtlCoord)sstep->v;
-        struct Map* mapblk = get_map_block_at(sx, sy);
+        struct Map* mapblk;
+        if (center_blk != NULL) {
+            mapblk = center_blk + sstep->both;
+        } else {
+            mapblk = get_map_block_at(coord_subtile(x) + (MapSubtlCoord)sstep->h, coord_subtile(y) + (MapSubtlCoord)sstep->v);
+        }
         if (!map_block_invalid(mapblk))
         {
             long i = get_mapwho_thing_index(mapblk);
@@ -3238,12 +3608,16 @@ long do_to_things_spiral_near_map_block(MapCoord x, MapCoord y, long spiral_len,
 {
     SYNCDBG(19,"Starting");
     long count = 0;
+    struct Map* center_blk = get_spiral_center_map_block(coord_subtile(x), coord_subtile(y), spiral_len);
     for (int around_val = 0; around_val < spiral_len; around_val++)
     {
         struct MapOffset* sstep = &spiral_step[around_val];
-        MapSubtlCoord sx = coord_subtile(x) + (MapSubtlCoord)sstep->h;
-        MapSubtlCoord sy = coord_subtile(y) + (MapSubtlCoord)sstep->v;
-        struct Map* mapblk = get_map_block_at(sx, sy);
+        struct Map* mapblk;
+        if (center_blk != NULL) {
+            mapblk = center_blk + sstep->both;
+        } else {
+            mapblk = get_map_block_at(coord_subtile(x) + (MapSubtlCoord)sstep->h, coord_subtile(y) + (MapSubtlCoord)sstep->v);
+        }
         if (!map_block_invalid(mapblk))
         {
             long i = get_mapwho_thing_index(mapblk);
@@ -3286,13 +3660,16 @@ long do_to_things_with_param_spiral_near_map_block(const struct Coord3d *center_
     }
     SYNCDBG(19,"Starting");
     long count = 0;
+    struct Map* center_blk = get_spiral_center_map_block(coord_subtile(center_pos->x.val), coord_subtile(center_pos->y.val), spiral_range * spiral_range);
     for (int around_val = 0; around_val < spiral_range * spiral_range; around_val++)
     {
         struct MapOffset* sstep = &spiral_step[around_val];
-        MapSubtlCoord sx = coord_subtile(center_pos->x.val) + sstep->h;
-        MapSubtlCoord sy = coord_subtile(center_pos->y.val) + sstep->v;
-        SYNCDBG(18,"Doing on (%d,%d)",(int)sx,(int)sy);
-        struct Map* mapblk = get_map_block_at(sx, sy);
+        struct Map* mapblk;
+        if (center_blk != NULL) {
+            mapblk = center_blk + sstep->both;
+        } else {
+            mapblk = get_map_block_at(coord_subtile(center_pos->x.val) + sstep->h, coord_subtile(center_pos->y.val) + sstep->v);
+        }
         if (!map_block_invalid(mapblk))
         {
             long i = get_mapwho_thing_index(mapblk);
@@ -4330,22 +4707,111 @@ long count_creatures_in_dungeon_of_model_flags(const struct Dungeon *dungeon, un
     return count;
 }
 
-long count_creatures_in_dungeon_controlled_and_of_model_flags(const struct Dungeon *dungeon, unsigned long need_mdflags, unsigned long excl_mdflags)
+/**
+ * Counts creatures in custody of enemy or dying, on one of dungeon lists, which model flags match given criteria.
+ */
+static long count_player_list_creatures_of_model_flags_not_controlled(long thing_idx, unsigned long need_mdflags, unsigned long excl_mdflags)
 {
     long count = 0;
-    for (ThingModel crmodel = 1; crmodel < game.conf.crtr_conf.model_count; crmodel++)
+    unsigned long k = 0;
+    long i = thing_idx;
+    while (i != 0)
     {
-        struct CreatureModelConfig* crconf = creature_stats_get(crmodel);
-        if (((crconf->model_flags & need_mdflags) == need_mdflags) &&
-           ((crconf->model_flags & excl_mdflags) == 0))
+        struct Thing* thing = thing_get(i);
+        if (thing_is_invalid(thing))
         {
-            count += dungeon->owned_creatures_of_model[crmodel]
-              - count_player_list_creatures_of_model_matching_bool_filter(dungeon->owner, crmodel, creature_is_kept_in_custody_by_enemy_or_dying);
+            ERRORLOG("Jump to invalid thing detected");
+            break;
+        }
+        struct CreatureControl* cctrl = creature_control_get_from_thing(thing);
+        i = cctrl->players_next_creature_idx;
+        // Per creature code
+        struct CreatureModelConfig* crconf = creature_stats_get_from_thing(thing);
+        if (((crconf->model_flags & need_mdflags) == need_mdflags) && ((crconf->model_flags & excl_mdflags) == 0))
+        {
+            if (creature_is_kept_in_custody_by_enemy_or_dying(thing))
+                count++;
+        }
+        // Per creature code ends
+        k++;
+        if (k > THINGS_COUNT)
+        {
+            ERRORLOG("Infinite loop detected when sweeping things list");
+            break;
         }
     }
     return count;
 }
 
+long count_creatures_in_dungeon_controlled_and_of_model_flags(const struct Dungeon *dungeon, unsigned long need_mdflags, unsigned long excl_mdflags)
+{
+    long count = count_creatures_in_dungeon_of_model_flags(dungeon, need_mdflags, excl_mdflags);
+    count -= count_player_list_creatures_of_model_flags_not_controlled(dungeon->creatr_list_start, need_mdflags, excl_mdflags);
+    count -= count_player_list_creatures_of_model_flags_not_controlled(dungeon->digger_list_start, need_mdflags, excl_mdflags);
+    return count;
+}
+
+/**
+ * Compares per-model counters of dungeon creature lists with the lists content.
+ * Mismatches are only logged; the counters are synced state and must not
+ * differ between debug and release builds.
+ * @return True if the counters were correct.
+ */
+TbBool check_dungeon_creature_list_counters(const struct Dungeon *dungeon)
+{
+    const unsigned short *list_of_model[2] = {dungeon->creatr_list_of_model, dungeon->digger_list_of_model};
+    long list_start[2] = {dungeon->creatr_list_start, dungeon->digger_list_start};
+    TbBool result = true;
+    for (int n = 0; n < 2; n++)
+    {
+        unsigned short walk_of_model[CREATURE_TYPES_MAX];
+        memset(walk_of_model, 0, sizeof(walk_of_model));
+        unsigned long k = 0;
+        long i = list_start[n];
+        while (i != 0)
+        {
+            struct Thing* thing = thing_get(i);
+            if (thing_is_invalid(thing))
+            {
+                ERRORLOG("Jump to invalid thing detected");
+                break;
+            }
+            struct CreatureControl* cctrl = creature_control_get_from_thing(thing);
+            i = cctrl->players_next_creature_idx;
+            walk_of_model[thing->model]++;
+            k++;
+            if (k > THINGS_COUNT)
+            {
+                ERRORLOG("Infinite loop detected when sweeping things list");
+                break;
+            }
+        }
+        for (ThingModel model = 0; model < CREATURE_TYPES_MAX; model++)
+        {
+            if (list_of_model[n][model] != walk_of_model[model])
+            {
+                ERRORLOG("Player %d %s list has %d creatures of model %d, but counter says %d", (int)dungeon->owner,
+                    (n == 0) ? "creatures" : "diggers", (int)walk_of_model[model], (int)model, (int)list_of_model[n][model]);
+                result = false;
+            }
+        }
+    }
+    return result;
+}
+
+void check_dungeons_creature_list_counters(void)
+{
+    for (PlayerNumber plyr_idx = 0; plyr_idx < PLAYERS_COUNT; plyr_idx++)
+    {
+        if (player_is_neutral(plyr_idx))
+            continue;
+        struct Dungeon* dungeon = get_players_num_dungeon(plyr_idx);
+        if (dungeon_invalid(dungeon))
+            continue;
+        check_dungeon_creature_list_counters(dungeon);
+    }
+}
+
 void break_mapwho_infinite_chain(const struct Map *mapblk)
 {
     SYNCDBG(8,"Starting");
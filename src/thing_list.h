@@ -34,6 +34,8 @@ extern "C" {
 #define SYNCED_THINGS_COUNT    8192
 #define UNSYNCED_THINGS_COUNT  4096
 #define THINGS_COUNT           SYNCED_THINGS_COUNT+UNSYNCED_THINGS_COUNT
+/** Amount of thing_lists[] entries which store things; lists after them store lights. */
+#define THING_CLASS_LISTS_COUNT 11
 
 enum ThingClassIndex {
     TCls_Empty        =  0,
@@ -179,6 +181,50 @@ struct StructureList {
      unsigned long index;
 };
 
+/**
+ * Dense array of things in a class list, maintained together with the linked list.
+ * Allows iterating over live things without chasing next_of_class through memory.
+ * Removal swaps the last item into the freed position, so the order is not stable;
+ * anything depending on update order must follow the linked list.
+ */
+struct ThingClassPool {
+     ThingIndex count;
+     /** Thing which was in the list for the longest time (tail of the linked list). */
+     ThingIndex oldest;
+     ThingIndex items[SYNCED_THINGS_COUNT];
+};
+
+/** Thing found by an area query, together with where it was found. */
+struct AreaThingCandidate {
+     ThingIndex index;
+     SubtlCodedCoords stl_num;
+     /** Number of the map block within the query rectangle. */
+     long block_num;
+};
+
+/**
+ * Query for things on a rectangle of map blocks, within given 2D distance from a point.
+ * Things are returned in the same order as walking mapwho chains of the blocks would visit them.
+ */
+struct AreaThingsQuery {
+     struct Coord3d center;
+     MapCoordDelta max_dist;
+     MapSubtlCoord start_x;
+     MapSubtlCoord start_y;
+     long width;
+     long blocks_count;
+     /** Amount of blocks from which candidates were already collected. */
+     long blocks_collected;
+     /** Block of the last returned thing, or block in which remaining candidates are skipped. */
+     long current_block;
+     TbBool skip_current_block;
+     /** Position of candidates in the shared scratch array. */
+     long first;
+     long count;
+     long next;
+     unsigned long mapwho_changes;
+};
+
 #pragma pack()
 /******************************************************************************/
 extern Thing_Class_Func class_functions[];
@@ -191,6 +237,9 @@ void remove_thing_from_its_class_list(struct Thing *thing);
 void add_thing_to_its_class_list(struct Thing *thing);
 ThingIndex get_thing_class_list_head(ThingClass class_id);
 struct StructureList *get_list_for_thing_class(ThingClass class_id);
+struct ThingClassPool *get_thing_pool_for_list(const struct StructureList *list);
+void clear_thing_class_pools(void);
+void rebuild_thing_class_pools(void);
 
 long creature_near_filter_is_owned_by(const struct Thing *thing, FilterParam val);
 
@@ -265,6 +314,8 @@ struct Thing* get_nearest_enemy_object_possible_to_attack_by(struct Thing* creat
 // Routines to select all players creatures of model matching the criteria
 long count_creatures_in_dungeon_of_model_flags(const struct Dungeon *dungeon, unsigned long need_mdflags, unsigned long excl_mdflags);
 long count_creatures_in_dungeon_controlled_and_of_model_flags(const struct Dungeon *dungeon, unsigned long need_mdflags, unsigned long excl_mdflags);
+TbBool check_dungeon_creature_list_counters(const struct Dungeon *dungeon);
+void check_dungeons_creature_list_counters(void);
 
 TbBool creature_matches_model(const struct Thing* creatng, ThingModel crmodel);
 TbBool creature_model_matches_model(ThingModel creatng_model, PlayerNumber plyr_idx, ThingModel target_model);
@@ -283,6 +334,7 @@ TbBool update_creature_speed(struct Thing *thing);
 TbBool perform_action_on_all_creatures_in_group(struct Thing *thing, Thing_Bool_Modifier action);
 
 struct Thing *creature_of_model_in_prison_or_tortured(ThingModel crmodel);
+long count_dungeon_list_creatures_of_model(const unsigned short *list_of_model, PlayerNumber plyr_idx, ThingModel crmodel);
 long count_player_creatures_of_model(PlayerNumber plyr_idx, int crmodel);
 long count_player_creatures_for_transfer(PlayerNumber plyr_idx);
 long count_player_creatures_of_model_in_action_point(PlayerNumber plyr_idx, int crmodel, long apt_index);
@@ -299,6 +351,14 @@ struct Thing *find_base_thing_on_mapwho(ThingClass oclass, ThingModel okind, Map
 struct Thing *find_object_of_genre_on_mapwho(long genre, MapSubtlCoord stl_x, MapSubtlCoord stl_y);
 void remove_thing_from_mapwho(struct Thing *thing);
 void place_thing_in_mapwho(struct Thing *thing);
+void rebuild_mapwho_creature_counts(void);
+unsigned short get_mapwho_creatures_count_at(MapSubtlCoord stl_x, MapSubtlCoord stl_y);
+unsigned short get_mapwho_creatures_count_in_row(MapSubtlCoord stl_y);
+unsigned short get_mapwho_creatures_count_in_column(MapSubtlCoord stl_x);
+void start_area_things_query(struct AreaThingsQuery *query, const struct Coord3d *pos, MapCoordDelta max_dist,
+    MapSubtlCoord start_x, MapSubtlCoord end_x, MapSubtlCoord start_y, MapSubtlCoord end_y);
+struct Thing *get_next_area_things_query_thing(struct AreaThingsQuery *query);
+void end_area_things_query(struct AreaThingsQuery *query);
 
 struct Thing *find_hero_gate_of_number(long num);
 long get_free_hero_gate_number(void);
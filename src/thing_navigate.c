@@ -416,18 +416,18 @@ TbBool terrain_toxic_for_creature_at_position(const struct Thing *creatng, MapSu
 }
 
 /**
- * Checks if a creature can navigate to target by tracing a complete route.
+ * Checks if a creature can navigate to target.
+ * Connected components of the navigation mesh are used when possible; complete route is traced otherwise.
  * @param thing
  * @param dstpos
  * @param flags
  * @param func_name
  * @return
- * @see ariadne_prepare_creature_route_to_target() does the same thing but writes resulting route into Ariadne struct.
+ * @see ariadne_prepare_creature_route_to_target() traces the route and writes it into Ariadne struct.
  */
 TbBool creature_can_navigate_to_f(const struct Thing *thing, struct Coord3d *dstpos, NaviRouteFlags flags, const char *func_name)
 {
-    long waypoints_num = ariadne_count_waypoints_on_creature_route_to_target_f(thing, &thing->mappos, dstpos, flags, func_name);
-    return (waypoints_num > 0);
+    return ariadne_creature_can_reach_target_f(thing, &thing->mappos, dstpos, flags, func_name);
 }
 
 /**
@@ -850,36 +850,107 @@ TbBool thing_on_thing_at(const struct Thing *firstng, const struct Coord3d *pos,
     return true;
 }
 
-TbBool things_collide_while_first_moves_to(const struct Thing *firstng, const struct Coord3d *dstpos, const struct Thing *sectng)
+/**
+ * Prepares range of movement fraction for narrowing.
+ * The range starts wider than the movement; only its relation to 0 and 1 matters in the end.
+ */
+void sweep_range_init(struct SweepRange *range)
 {
-    SYNCDBG(8,"The %s index %d, check with %s index %d",thing_model_name(firstng),(int)firstng->index,thing_model_name(sectng),(int)sectng->index);
-    if ((firstng->parent_idx != 0) && (sectng->parent_idx == firstng->parent_idx)) {
-        return false;
+    range->lo_n = -1;
+    range->lo_d = 1;
+    range->hi_n = 2;
+    range->hi_d = 1;
+}
+
+/**
+ * Narrows range of movement fraction t to where offset+t*delta lies strictly within (-radius,radius).
+ * @return False if the range became empty.
+ */
+TbBool sweep_range_narrow_to_axis(struct SweepRange *range, MapCoordDelta offset, MapCoordDelta delta, MapCoordDelta radius)
+{
+    if (delta == 0) {
+        return (offset > -radius) && (offset < radius);
     }
-    // Compute shift in thing position
-    struct CoordDelta3d dt;
-    dt.x.val = dstpos->x.val - (MapCoordDelta)firstng->mappos.x.val;
-    dt.y.val = dstpos->y.val - (MapCoordDelta)firstng->mappos.y.val;
-    dt.z.val = dstpos->z.val - (MapCoordDelta)firstng->mappos.z.val;
-    // Compute amount of interpoints for collision check
-    int interpoints;
-    {
-        MapCoordDelta dt_max = max(max(dt.x.val, dt.y.val), dt.z.val);
-        // Require checking at 1/4 of max collision distance
-        MapCoordDelta dt_limit = (sectng->solid_size_xy + firstng->solid_size_xy) / 4 + 1;
-        interpoints = dt_max / dt_limit;
+    int64_t enter_n;
+    int64_t leave_n;
+    int64_t den;
+    if (delta > 0) {
+        enter_n = -(int64_t)radius - offset;
+        leave_n = (int64_t)radius - offset;
+        den = delta;
+    } else {
+        enter_n = (int64_t)offset - radius;
+        leave_n = (int64_t)offset + radius;
+        den = -(int64_t)delta;
     }
-    for (int i = 1; i < interpoints; i++)
-    {
-        struct Coord3d pos;
-        pos.x.val = firstng->mappos.x.val + dt.x.val * i / interpoints;
-        pos.y.val = firstng->mappos.y.val + dt.y.val * i / interpoints;
-        pos.z.val = firstng->mappos.z.val + dt.z.val * i / interpoints;
-        if (thing_on_thing_at(firstng, &pos, sectng)) {
-            return true;
-        }
+    if (enter_n * range->lo_d > range->lo_n * den) {
+        range->lo_n = enter_n;
+        range->lo_d = den;
+    }
+    if (leave_n * range->hi_d < range->hi_n * den) {
+        range->hi_n = leave_n;
+        range->hi_d = den;
+    }
+    return (range->lo_n * range->hi_d < range->hi_n * range->lo_d);
+}
+
+/**
+ * Returns if the range includes any point of movement, excluding its start.
+ */
+TbBool sweep_range_hits_movement(const struct SweepRange *range)
+{
+    if (range->lo_n * range->hi_d >= range->hi_n * range->lo_d)
+        return false;
+    return (range->hi_n > 0) && (range->lo_n < range->lo_d);
+}
+
+/**
+ * Returns movement fraction at which the range is entered, scaled to SWEEP_FRACTION_ONE.
+ */
+long sweep_range_entry_fraction(const struct SweepRange *range)
+{
+    if (range->lo_n <= 0)
+        return 0;
+    return (long)(range->lo_n * SWEEP_FRACTION_ONE / range->lo_d);
+}
+
+/**
+ * Checks if the first thing touches the second one at any point of its movement to given position.
+ * Gives exact result of segment against box test, so fast things can't pass through thin ones.
+ * @param firstng The moving thing.
+ * @param dstpos Position the moving thing is heading to.
+ * @param sectng The thing which is not moving.
+ * @param hit_frac If not NULL, receives fraction of the movement after which the things touch.
+ */
+TbBool thing_sweep_collides_with_thing(const struct Thing *firstng, const struct Coord3d *dstpos, const struct Thing *sectng, long *hit_frac)
+{
+    if ((firstng->parent_idx != 0) && (sectng->parent_idx == firstng->parent_idx)) {
+        return false;
     }
-    return thing_on_thing_at(firstng, dstpos, sectng);
+    struct SweepRange range;
+    sweep_range_init(&range);
+    MapCoordDelta dist_collide = (sectng->solid_size_xy + firstng->solid_size_xy) / 2;
+    if (!sweep_range_narrow_to_axis(&range, (MapCoordDelta)firstng->mappos.x.val - (MapCoordDelta)sectng->mappos.x.val,
+        dstpos->x.val - (MapCoordDelta)firstng->mappos.x.val, dist_collide))
+        return false;
+    if (!sweep_range_narrow_to_axis(&range, (MapCoordDelta)firstng->mappos.y.val - (MapCoordDelta)sectng->mappos.y.val,
+        dstpos->y.val - (MapCoordDelta)firstng->mappos.y.val, dist_collide))
+        return false;
+    dist_collide = (sectng->solid_size_z + firstng->solid_size_z) / 2;
+    MapCoordDelta dist_z = (MapCoordDelta)firstng->mappos.z.val - (MapCoordDelta)sectng->mappos.z.val - (sectng->solid_size_z >> 1) + (firstng->solid_size_z >> 1);
+    if (!sweep_range_narrow_to_axis(&range, dist_z, dstpos->z.val - (MapCoordDelta)firstng->mappos.z.val, dist_collide))
+        return false;
+    if (!sweep_range_hits_movement(&range))
+        return false;
+    if (hit_frac != NULL)
+        *hit_frac = sweep_range_entry_fraction(&range);
+    return true;
+}
+
+TbBool things_collide_while_first_moves_to(const struct Thing *firstng, const struct Coord3d *dstpos, const struct Thing *sectng)
+{
+    SYNCDBG(8,"The %s index %d, check with %s index %d",thing_model_name(firstng),(int)firstng->index,thing_model_name(sectng),(int)sectng->index);
+    return thing_sweep_collides_with_thing(firstng, dstpos, sectng, NULL);
 }
 
 TbBool thing_is_exempt_from_z_axis_clipping(const struct Thing *thing)
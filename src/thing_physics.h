@@ -27,6 +27,8 @@ extern "C" {
 #endif
 /******************************************************************************/
 #define MAX_VELOCITY 256
+/** Value of movement fraction at the end of movement in swept collision checks. */
+#define SWEEP_FRACTION_ONE 65536
 /******************************************************************************/
 #pragma pack(1)
 
@@ -35,6 +37,14 @@ struct Dungeon;
 struct ComponentVector;
 
 #pragma pack()
+
+/** Range of movement fraction, with ends kept as fractions so that collision checks are exact. */
+struct SweepRange {
+    int64_t lo_n;
+    int64_t lo_d;
+    int64_t hi_n;
+    int64_t hi_d;
+};
 /******************************************************************************/
 void destroy_thing(struct Thing* thing);
 TbBool thing_touching_floor(const struct Thing *thing);
@@ -43,6 +53,11 @@ TbBool thing_above_flight_altitude(const struct Thing* thing);
 
 TbBool thing_on_thing_at(const struct Thing *firstng, const struct Coord3d *pos, const struct Thing *sectng);
 TbBool things_collide_while_first_moves_to(const struct Thing *firstng, const struct Coord3d *dstpos, const struct Thing *sectng);
+TbBool thing_sweep_collides_with_thing(const struct Thing *firstng, const struct Coord3d *dstpos, const struct Thing *sectng, long *hit_frac);
+void sweep_range_init(struct SweepRange *range);
+TbBool sweep_range_narrow_to_axis(struct SweepRange *range, MapCoordDelta offset, MapCoordDelta delta, MapCoordDelta radius);
+TbBool sweep_range_hits_movement(const struct SweepRange *range);
+long sweep_range_entry_fraction(const struct SweepRange *range);
 TbBool cross_x_boundary_first(const struct Coord3d *pos1, const struct Coord3d *pos2);
 TbBool cross_y_boundary_first(const struct Coord3d *pos1, const struct Coord3d *pos2);
 
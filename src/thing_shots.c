@@ -1574,6 +1574,77 @@ struct Thing *get_thing_collided_with_at_satisfying_filter(struct Thing *shotng,
     return INVALID_THING;
 }
 
+/**
+ * Finds the first thing which a shot touches on its way to given position.
+ * Only subtiles close enough to the travelled segment are visited, and things are
+ * checked with swept collision; if more are hit, the one reached earliest is returned.
+ */
+static struct Thing *get_thing_swept_by_shot_satisfying_filter(struct Thing *shotng, struct Coord3d *nxpos, Thing_Collide_Func filter, HitTargetFlags hit_targets, long a5)
+{
+    // Things are found by subtile of their position, so their size has to fit within the margin
+    const MapCoordDelta margin = 384;
+    MapCoord beg_x = shotng->mappos.x.val;
+    MapCoord beg_y = shotng->mappos.y.val;
+    MapCoordDelta delta_x = nxpos->x.val - (MapCoordDelta)beg_x;
+    MapCoordDelta delta_y = nxpos->y.val - (MapCoordDelta)beg_y;
+    MapSubtlCoord stl_x_min = coord_subtile(max(min(beg_x, nxpos->x.val) - margin, 0));
+    MapSubtlCoord stl_y_min = coord_subtile(max(min(beg_y, nxpos->y.val) - margin, 0));
+    MapSubtlCoord stl_x_max = min(coord_subtile(max(beg_x, nxpos->x.val) + margin), game.map_subtiles_x);
+    MapSubtlCoord stl_y_max = min(coord_subtile(max(beg_y, nxpos->y.val) + margin), game.map_subtiles_y);
+    struct Thing* parntng = get_parent_thing(shotng);
+    struct Thing* hittng = INVALID_THING;
+    long hit_frac = SWEEP_FRACTION_ONE + 1;
+    for (MapSubtlCoord stl_y = stl_y_min; stl_y <= stl_y_max; stl_y++)
+    {
+        for (MapSubtlCoord stl_x = stl_x_min; stl_x <= stl_x_max; stl_x++)
+        {
+            struct Map* mapblk = get_map_block_at(stl_x, stl_y);
+            long i = get_mapwho_thing_index(mapblk);
+            if (i == 0)
+                continue;
+            // Skip subtiles which the segment doesn't pass close to
+            struct SweepRange range;
+            sweep_range_init(&range);
+            MapCoordDelta reach = COORD_PER_STL/2 + margin + 1;
+            if (!sweep_range_narrow_to_axis(&range, (MapCoordDelta)beg_x - subtile_coord_center(stl_x), delta_x, reach) ||
+                !sweep_range_narrow_to_axis(&range, (MapCoordDelta)beg_y - subtile_coord_center(stl_y), delta_y, reach) ||
+                !sweep_range_hits_movement(&range))
+                continue;
+            unsigned long k = 0;
+            while (i != 0)
+            {
+                struct Thing* thing = thing_get(i);
+                TRACE_THING(thing);
+                if (thing_is_invalid(thing))
+                {
+                    ERRORLOG("Jump to invalid thing detected");
+                    break;
+                }
+                i = thing->next_on_mapblk;
+                // Per thing code start
+                if ((thing->index != shotng->index) && filter(thing, parntng, hit_targets, a5))
+                {
+                    long frac;
+                    if (thing_sweep_collides_with_thing(shotng, nxpos, thing, &frac) && (frac < hit_frac))
+                    {
+                        hittng = thing;
+                        hit_frac = frac;
+                    }
+                }
+                // Per thing code end
+                k++;
+                if (k > THINGS_COUNT)
+                {
+                    ERRORLOG("Infinite loop detected when sweeping things list");
+                    break_mapwho_infinite_chain(mapblk);
+                    break;
+                }
+            }
+        }
+    }
+    return hittng;
+}
+
 /**
  * Processes hitting another thing.
  *
@@ -1588,7 +1659,7 @@ TbBool shot_hit_something_while_moving(struct Thing *shotng, struct Coord3d *nxp
     SYNCDBG(18,"Starting for %s index %d, hit type %d",thing_model_name(shotng),(int)shotng->index, (int)shotng->shot.hit_type);
     struct Thing* targetng = INVALID_THING;
     HitTargetFlags hit_targets = hit_type_to_hit_targets(shotng->shot.hit_type);
-    targetng = get_thing_collided_with_at_satisfying_filter(shotng, nxpos, collide_filter_thing_is_shootable, hit_targets, 0);
+    targetng = get_thing_swept_by_shot_satisfying_filter(shotng, nxpos, collide_filter_thing_is_shootable, hit_targets, 0);
     if (thing_is_invalid(targetng)) {
         return false;
     }
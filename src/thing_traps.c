@@ -26,6 +26,7 @@
 
 #include "cursor_tag.h"
 #include "thing_data.h"
+#include "thing_list.h"
 #include "creature_states_combt.h"
 #include "config_creature.h"
 #include "config_trapdoor.h"
@@ -226,6 +227,9 @@ TbBool creature_available_for_trap_trigger(struct Thing* creatng)
 
 TbBool update_trap_trigger_line_of_sight_90_on_subtile(struct Thing *traptng, MapSubtlCoord stl_x, MapSubtlCoord stl_y)
 {
+    // Only creatures may trigger the trap, so there's no need to walk the chain without them
+    if (get_mapwho_creatures_count_at(stl_x, stl_y) == 0)
+        return false;
     struct Map* mapblk = get_map_block_at(stl_x, stl_y);
     unsigned long k = 0;
     long i = get_mapwho_thing_index(mapblk);
@@ -272,37 +276,74 @@ TbBool update_trap_trigger_line_of_sight_90_on_subtile(struct Thing *traptng, Ma
     return false;
 }
 
-TbBool update_trap_trigger_line_of_sight_90(struct Thing *traptng)
-{
-    struct TrapConfigStats *trapst = get_trap_model_stats(traptng->model);
-    struct ShotConfigStats* shotst = get_shot_model_stats(trapst->created_itm_model);
-
-    MapSubtlDelta line_of_sight_90_range = (shotst->max_range / COORD_PER_STL);
-    if (line_of_sight_90_range == 0)
-    {
-        line_of_sight_90_range = max(game.map_subtiles_x, game.map_subtiles_y);
-    }
+/**
+ * Cached extents of line of sight 90 trap trigger rays, indexed by trap thing index.
+ * Extents depend only on trap position, shot range and blocking flags of the rows and
+ * columns the rays run along; so they are recomputed when one of these changes.
+ */
+struct TrapTriggerZone {
+    TbBool valid;
+    unsigned long blocking_changes;
+    MapSubtlDelta range;
     MapSubtlCoord stl_x_beg;
     MapSubtlCoord stl_x_end;
     MapSubtlCoord stl_y_beg;
     MapSubtlCoord stl_y_end;
+    MapSubtlCoord stl_x_pre;
+    MapSubtlCoord stl_x_aft;
+    MapSubtlCoord stl_y_pre;
+    MapSubtlCoord stl_y_aft;
+};
+
+static struct TrapTriggerZone trap_trigger_zones[THINGS_COUNT];
+/** Counts changes of blocking flags; rows and columns remember the count at their last change. */
+static unsigned long trap_zones_blocking_changes;
+static unsigned long trap_zones_row_changed_at[MAX_SUBTILES_Y+1];
+static unsigned long trap_zones_column_changed_at[MAX_SUBTILES_X+1];
+
+void clear_trap_trigger_zones(void)
+{
+    memset(trap_trigger_zones, 0, sizeof(trap_trigger_zones));
+    memset(trap_zones_row_changed_at, 0, sizeof(trap_zones_row_changed_at));
+    memset(trap_zones_column_changed_at, 0, sizeof(trap_zones_column_changed_at));
+    trap_zones_blocking_changes = 0;
+}
+
+/**
+ * Informs trap trigger zones that blocking flag of given subtile has changed.
+ */
+void trap_trigger_zones_blocking_changed(MapSubtlCoord stl_x, MapSubtlCoord stl_y)
+{
+    trap_zones_blocking_changes++;
+    if ((stl_y >= 0) && (stl_y <= MAX_SUBTILES_Y))
+        trap_zones_row_changed_at[stl_y] = trap_zones_blocking_changes;
+    if ((stl_x >= 0) && (stl_x <= MAX_SUBTILES_X))
+        trap_zones_column_changed_at[stl_x] = trap_zones_blocking_changes;
+}
+
+static TbBool trap_trigger_zone_is_current(const struct TrapTriggerZone *zone, MapSubtlCoord stl_x_beg, MapSubtlCoord stl_x_end,
+    MapSubtlCoord stl_y_beg, MapSubtlCoord stl_y_end, MapSubtlDelta range)
+{
+    if (!zone->valid || (zone->range != range))
+        return false;
+    if ((zone->stl_x_beg != stl_x_beg) || (zone->stl_x_end != stl_x_end) || (zone->stl_y_beg != stl_y_beg) || (zone->stl_y_end != stl_y_end))
+        return false;
+    for (MapSubtlCoord stl_x = stl_x_beg; stl_x <= stl_x_end; stl_x++)
     {
-        MapCoordDelta trap_radius = traptng->clipbox_size_xy / 2;
-        MapCoord coord_x = traptng->mappos.x.val;
-        stl_x_beg = coord_subtile(coord_x - trap_radius);
-        if (stl_x_beg <= 0)
-            stl_x_beg = 0;
-        stl_x_end = coord_subtile(coord_x + trap_radius);
-        if (stl_x_end >= game.map_subtiles_x)
-            stl_x_end = game.map_subtiles_x;
-        MapCoord coord_y = traptng->mappos.y.val;
-        stl_y_beg = coord_subtile(coord_y - trap_radius);
-        if (stl_y_beg <= 0)
-            stl_y_beg = 0;
-        stl_y_end = coord_subtile(coord_y + trap_radius);
-        if (stl_y_end >= game.map_subtiles_y)
-            stl_y_end = game.map_subtiles_y;
+        if (trap_zones_column_changed_at[stl_x] > zone->blocking_changes)
+            return false;
+    }
+    for (MapSubtlCoord stl_y = stl_y_beg; stl_y <= stl_y_end; stl_y++)
+    {
+        if (trap_zones_row_changed_at[stl_y] > zone->blocking_changes)
+            return false;
     }
+    return true;
+}
+
+static void compute_trap_trigger_zone(struct TrapTriggerZone *zone, MapSubtlCoord stl_x_beg, MapSubtlCoord stl_x_end,
+    MapSubtlCoord stl_y_beg, MapSubtlCoord stl_y_end, MapSubtlDelta line_of_sight_90_range)
+{
     MapSubtlCoord stl_x_pre;
     MapSubtlCoord stl_x_aft;
     MapSubtlCoord stl_y_pre;
@@ -335,16 +376,6 @@ TbBool update_trap_trigger_line_of_sight_90(struct Thing *traptng)
             }
         }
     }
-    // Check the area for activation
-    for (stl_x=stl_x_beg; stl_x <= stl_x_end; stl_x++)
-    {
-        for (stl_y = stl_y_beg; stl_y >= stl_y_pre; stl_y--)
-        {
-            if (update_trap_trigger_line_of_sight_90_on_subtile(traptng, stl_x, stl_y)) {
-                return true;
-            }
-        }
-    }
     // Find a limit of where the trap will fit in positive Y
     for (stl_x=stl_x_beg; stl_x <= stl_x_end; stl_x++)
     {
@@ -357,54 +388,123 @@ TbBool update_trap_trigger_line_of_sight_90(struct Thing *traptng)
             }
         }
     }
-    // Check the area for activation
-    for (stl_x=stl_x_beg; stl_x <= stl_x_end; stl_x++)
+    // Find a limit of where the trap will fit in positive X
+    for (stl_y=stl_y_beg; stl_y <= stl_y_end; stl_y++)
     {
-        for (stl_y = stl_y_end; stl_y <= stl_y_aft; stl_y++)
+        for (stl_x=stl_x_end; stl_x <= stl_x_aft; stl_x++)
         {
-            if (update_trap_trigger_line_of_sight_90_on_subtile(traptng, stl_x, stl_y)) {
-                return true;
+            struct Map* mapblk = get_map_block_at(stl_x, stl_y);
+            if ((mapblk->flags & SlbAtFlg_Blocking) != 0) {
+                stl_x_aft = stl_x - 1;
+                break;
             }
         }
     }
-    // Find a limit of where the trap will fit in positive X
+    // Find a limit of where the trap will fit in negative X
     for (stl_y=stl_y_beg; stl_y <= stl_y_end; stl_y++)
     {
-        for (stl_x=stl_x_end; stl_x <= stl_x_aft; stl_x++)
+        for (stl_x=stl_x_beg; stl_x >= stl_x_pre; stl_x--)
         {
             struct Map* mapblk = get_map_block_at(stl_x, stl_y);
             if ((mapblk->flags & SlbAtFlg_Blocking) != 0) {
-                stl_x_aft = stl_x - 1;
+                stl_x_pre = stl_x + 1;
                 break;
             }
         }
     }
-    // Check the area for activation
-    for (stl_y=stl_y_beg; stl_y <= stl_y_end; stl_y++)
+    zone->valid = true;
+    zone->blocking_changes = trap_zones_blocking_changes;
+    zone->range = line_of_sight_90_range;
+    zone->stl_x_beg = stl_x_beg;
+    zone->stl_x_end = stl_x_end;
+    zone->stl_y_beg = stl_y_beg;
+    zone->stl_y_end = stl_y_end;
+    zone->stl_x_pre = stl_x_pre;
+    zone->stl_x_aft = stl_x_aft;
+    zone->stl_y_pre = stl_y_pre;
+    zone->stl_y_aft = stl_y_aft;
+}
+
+TbBool update_trap_trigger_line_of_sight_90(struct Thing *traptng)
+{
+    struct TrapConfigStats *trapst = get_trap_model_stats(traptng->model);
+    struct ShotConfigStats* shotst = get_shot_model_stats(trapst->created_itm_model);
+
+    MapSubtlDelta line_of_sight_90_range = (shotst->max_range / COORD_PER_STL);
+    if (line_of_sight_90_range == 0)
     {
-        for (stl_x=stl_x_end; stl_x <= stl_x_aft; stl_x++)
+        line_of_sight_90_range = max(game.map_subtiles_x, game.map_subtiles_y);
+    }
+    MapSubtlCoord stl_x_beg;
+    MapSubtlCoord stl_x_end;
+    MapSubtlCoord stl_y_beg;
+    MapSubtlCoord stl_y_end;
+    {
+        MapCoordDelta trap_radius = traptng->clipbox_size_xy / 2;
+        MapCoord coord_x = traptng->mappos.x.val;
+        stl_x_beg = coord_subtile(coord_x - trap_radius);
+        if (stl_x_beg <= 0)
+            stl_x_beg = 0;
+        stl_x_end = coord_subtile(coord_x + trap_radius);
+        if (stl_x_end >= game.map_subtiles_x)
+            stl_x_end = game.map_subtiles_x;
+        MapCoord coord_y = traptng->mappos.y.val;
+        stl_y_beg = coord_subtile(coord_y - trap_radius);
+        if (stl_y_beg <= 0)
+            stl_y_beg = 0;
+        stl_y_end = coord_subtile(coord_y + trap_radius);
+        if (stl_y_end >= game.map_subtiles_y)
+            stl_y_end = game.map_subtiles_y;
+    }
+    struct TrapTriggerZone* zone = &trap_trigger_zones[traptng->index];
+    if (!trap_trigger_zone_is_current(zone, stl_x_beg, stl_x_end, stl_y_beg, stl_y_end, line_of_sight_90_range))
+    {
+        compute_trap_trigger_zone(zone, stl_x_beg, stl_x_end, stl_y_beg, stl_y_end, line_of_sight_90_range);
+    }
+    MapSubtlCoord stl_x;
+    MapSubtlCoord stl_y;
+    // Check the area for activation in negative Y
+    for (stl_x=stl_x_beg; stl_x <= stl_x_end; stl_x++)
+    {
+        if (get_mapwho_creatures_count_in_column(stl_x) == 0)
+            continue;
+        for (stl_y = stl_y_beg; stl_y >= zone->stl_y_pre; stl_y--)
         {
             if (update_trap_trigger_line_of_sight_90_on_subtile(traptng, stl_x, stl_y)) {
                 return true;
             }
         }
     }
-    // Find a limit of where the trap will fit in negative X
+    // Check the area for activation in positive Y
+    for (stl_x=stl_x_beg; stl_x <= stl_x_end; stl_x++)
+    {
+        if (get_mapwho_creatures_count_in_column(stl_x) == 0)
+            continue;
+        for (stl_y = stl_y_end; stl_y <= zone->stl_y_aft; stl_y++)
+        {
+            if (update_trap_trigger_line_of_sight_90_on_subtile(traptng, stl_x, stl_y)) {
+                return true;
+            }
+        }
+    }
+    // Check the area for activation in positive X
     for (stl_y=stl_y_beg; stl_y <= stl_y_end; stl_y++)
     {
-        for (stl_x=stl_x_beg; stl_x >= stl_x_pre; stl_x--)
+        if (get_mapwho_creatures_count_in_row(stl_y) == 0)
+            continue;
+        for (stl_x=stl_x_end; stl_x <= zone->stl_x_aft; stl_x++)
         {
-            struct Map* mapblk = get_map_block_at(stl_x, stl_y);
-            if ((mapblk->flags & SlbAtFlg_Blocking) != 0) {
-                stl_x_pre = stl_x + 1;
-                break;
+            if (update_trap_trigger_line_of_sight_90_on_subtile(traptng, stl_x, stl_y)) {
+                return true;
             }
         }
     }
-    // Check the area for activation
+    // Check the area for activation in negative X
     for (stl_y=stl_y_beg; stl_y <= stl_y_end; stl_y++)
     {
-        for (stl_x=stl_x_beg; stl_x >= stl_x_pre; stl_x--)
+        if (get_mapwho_creatures_count_in_row(stl_y) == 0)
+            continue;
+        for (stl_x=stl_x_beg; stl_x >= zone->stl_x_pre; stl_x--)
         {
             if (update_trap_trigger_line_of_sight_90_on_subtile(traptng, stl_x, stl_y)) {
                 return true;
@@ -705,6 +805,8 @@ void activate_trap_by_slap(struct PlayerInfo *player, struct Thing* traptng)
 
 TbBool find_pressure_trigger_trap_target_passing_by_subtile(const struct Thing *traptng, MapSubtlCoord stl_x, MapSubtlCoord stl_y, struct Thing **found_thing)
 {
+    if (get_mapwho_creatures_count_at(stl_x, stl_y) == 0)
+        return false;
     struct Map* mapblk = get_map_block_at(stl_x, stl_y);
     unsigned long k = 0;
     long i = get_mapwho_thing_index(mapblk);
@@ -93,6 +93,8 @@ TbBool trap_on_bridge(ThingModel trpkind);
 TbBool rearm_trap(struct Thing *traptng);
 TngUpdateRet update_trap(struct Thing *thing);
 void init_traps(void);
+void clear_trap_trigger_zones(void);
+void trap_trigger_zones_blocking_changed(MapSubtlCoord stl_x, MapSubtlCoord stl_y);
 void activate_trap(struct Thing *traptng, struct Thing *creatng);
 void activate_trap_by_slap(struct PlayerInfo* player, struct Thing* traptng);
 void process_trap_charge(struct Thing* traptng);